@@ -0,0 +1,116 @@
+/**
+ * @format
+ */
+
+import { ArduinoBridge } from '../services/arduinoBridge';
+import { BinaryFrameDecoder, encodeFrame } from '../services/binaryProtocol';
+import { LoopbackTransport } from '../services/transport';
+
+jest.mock('react-native-bluetooth-classic', () => ({}));
+
+afterEach(() => {
+  jest.useRealTimers();
+});
+
+function bytes(text: string): Uint8Array {
+  return Uint8Array.from(text, ch => ch.charCodeAt(0));
+}
+
+function concat(...chunks: Uint8Array[]): Uint8Array {
+  const out = new Uint8Array(chunks.reduce((n, c) => n + c.length, 0));
+  let pos = 0;
+  chunks.forEach(chunk => {
+    out.set(chunk, pos);
+    pos += chunk.length;
+  });
+  return out;
+}
+
+test('decodes frames and rejects a corrupted CRC', () => {
+  const samples: [string, number][] = [];
+  const text: number[] = [];
+  const decoder = new BinaryFrameDecoder(
+    (key, value) => samples.push([key, value]),
+    b => text.push(b),
+  );
+  const good = encodeFrame('speed', 0, [5.12, 6]);
+  const bad = encodeFrame('bpm', 1, [72]);
+  bad[4] ^= 0xff;
+  decoder.pushBytes(concat(good, bad, encodeFrame('bpm', 2, [80])));
+
+  expect(samples).toEqual([
+    ['speed', 5.12],
+    ['speed', 6],
+    ['bpm', 80],
+  ]);
+  expect(decoder.getStats().crcErrors).toBe(1);
+});
+
+async function connectBinary(answer: boolean) {
+  const transport = new LoopbackTransport();
+  const writes: string[] = [];
+  transport.onWrite(data => {
+    writes.push(data);
+    if (answer && data.startsWith('BIN:')) {
+      // 응답 줄 바로 뒤에 첫 프레임이 같은 청크로 붙어 온다
+      transport.emit(
+        concat(bytes(data.trim() + '\n'), encodeFrame('speed', 0, [4.5])),
+      );
+    }
+  });
+  const bridge = new ArduinoBridge({ transport, binaryProtocol: true });
+  const speeds: number[] = [];
+  bridge.onSpeed(speed => speeds.push(speed));
+  await bridge.connect('sim');
+  return { bridge, transport, writes, speeds };
+}
+
+test('frames are decoded only after the device acks BIN:1', async () => {
+  jest.useFakeTimers();
+  const { bridge, transport, speeds } = await connectBinary(true);
+
+  expect(bridge.getProtocol()).toBe('binary');
+  expect(speeds).toEqual([4.5]);
+  transport.emit(encodeFrame('speed', 1, [5]));
+  expect(speeds).toEqual([4.5, 5]);
+  await bridge.disconnect();
+});
+
+test('falls back to text when the device never acks', async () => {
+  jest.useFakeTimers();
+  const { bridge, transport, writes, speeds } = await connectBinary(false);
+
+  // 협상 전의 프레임 바이트는 텍스트로 취급되어 값이 되지 않는다
+  transport.emit(encodeFrame('speed', 0, [4.5]));
+  transport.emit(bytes('\n'));
+  expect(speeds).toEqual([]);
+
+  jest.advanceTimersByTime(1000);
+  expect(writes).toContain('BIN:0\n');
+
+  // 시간 초과 뒤의 늦은 BIN:1은 무시한다
+  transport.emit(
+    concat(bytes('BIN:1\n'), encodeFrame('speed', 1, [5]), bytes('\n')),
+  );
+  expect(bridge.getProtocol()).toBe('text');
+  transport.emit(bytes('SPD:5.5\n'));
+  expect(speeds).toEqual([5.5]);
+  await bridge.disconnect();
+});
+
+test('the transport negotiation window closes on fallback', async () => {
+  jest.useFakeTimers();
+  const transport = new LoopbackTransport();
+  const windows: boolean[] = [];
+  Object.assign(transport, {
+    setBinaryNegotiation: (open: boolean) => windows.push(open),
+  });
+  const bridge = new ArduinoBridge({ transport, binaryProtocol: true });
+  await bridge.connect('sim');
+  expect(windows).toEqual([true]);
+
+  // 창이 닫힌 뒤의 늦은 BIN:1로 네이티브가 프레임 모드로 넘어가지 않는다
+  jest.advanceTimersByTime(1000);
+  expect(windows).toEqual([true, false]);
+  await bridge.disconnect();
+});
@@ -0,0 +1,53 @@
+/**
+ * @format
+ */
+
+import { BpmFilter } from '../services/bpmFilter';
+
+// 1초 간격으로 값을 넣고 결과를 모은다
+function feed(filter: BpmFilter, values: number[], startMs = 0): number[] {
+  return values.map((bpm, i) => filter.push(bpm, startMs + i * 1000));
+}
+
+test('sensor glitches of 0 and 255 are dropped by the range gate', () => {
+  const filter = new BpmFilter();
+  const out = feed(filter, [70, 71, 0, 72, 255, 71]);
+
+  expect(out).toEqual([70, 71, NaN, 72, NaN, 71]);
+  expect(filter.getStats().rejectedRange).toBe(2);
+  expect(filter.median).toBe(71);
+});
+
+test('a sudden doubling is dropped by the rate gate', () => {
+  const filter = new BpmFilter();
+  const out = feed(filter, [70, 71, 70, 142, 71, 35, 72]);
+
+  expect(out).toEqual([70, 71, 70, NaN, 71, NaN, 72]);
+  expect(filter.getStats().rejectedRate).toBe(2);
+  expect(filter.getStats().reseeds).toBe(0);
+  expect(filter.median).toBe(71);
+});
+
+test('a real step change reseeds after repeated rejects', () => {
+  const filter = new BpmFilter();
+  feed(filter, [70, 70, 70]);
+  const out = feed(filter, [130, 131, 130, 132, 131], 3000);
+
+  // 세 번 막힌 뒤 네 번째에서 새 값으로 다시 시작한다
+  expect(out).toEqual([NaN, NaN, NaN, 132, 131]);
+  const stats = filter.getStats();
+  expect(stats.rejectedRate).toBe(3);
+  expect(stats.reseeds).toBe(1);
+  expect(filter.median).toBeCloseTo(131.5, 5);
+});
+
+test('a long gap forgets the old window', () => {
+  const filter = new BpmFilter();
+  feed(filter, [70, 70, 70]);
+
+  // 10초 넘게 비었으면 변화율을 따질 기준이 없다
+  expect(filter.push(130, 2000 + 10001)).toBe(130);
+  expect(filter.getStats().rejectedRate).toBe(0);
+  expect(filter.getStats().reseeds).toBe(0);
+  expect(filter.median).toBe(130);
+});
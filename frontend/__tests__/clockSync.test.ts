@@ -0,0 +1,77 @@
+/**
+ * @format
+ */
+
+import { ClockSync } from '../services/clockSync';
+
+const APP_START = 1_700_000_000_000;
+const BOOT_OFFSET = 12_345 - APP_START;
+const DRIFT_PPM = 300;
+
+// 부팅 후 ms를 세는 기기 시계. 앱 시계보다 DRIFT_PPM만큼 빠르다
+function deviceAt(appMs: number): number {
+  return appMs + BOOT_OFFSET + (appMs - APP_START) * DRIFT_PPM * 1e-6;
+}
+
+// 보낸 뒤 uplinkMs에 기기가 처리하고 downlinkMs 뒤에 PONG이 도착한다
+function exchange(
+  sync: ClockSync,
+  sentAt: number,
+  uplinkMs: number,
+  downlinkMs: number,
+) {
+  sync.addExchange(
+    sentAt,
+    sentAt + uplinkMs + downlinkMs,
+    deviceAt(sentAt + uplinkMs),
+  );
+}
+
+function maxError(sync: ClockSync, from: number, to: number): number {
+  let worst = 0;
+  for (let t = from; t <= to; t += 500) {
+    worst = Math.max(worst, Math.abs(sync.toAppTime(deviceAt(t)) - t));
+  }
+  return worst;
+}
+
+test('recovers offset and drift from symmetric exchanges', () => {
+  const sync = new ClockSync();
+  expect(sync.toAppTime(deviceAt(APP_START))).toBeNaN();
+
+  for (let i = 0; i < 20; i++) exchange(sync, APP_START + i * 1000, 15, 15);
+
+  const stats = sync.stats();
+  expect(stats.synced).toBe(true);
+  expect(stats.driftPpm).toBeCloseTo(DRIFT_PPM, -1);
+  expect(stats.minRttMs).toBe(30);
+  expect(maxError(sync, APP_START, APP_START + 30_000)).toBeLessThan(1);
+});
+
+test('asymmetric RTT errs by at most half the asymmetry', () => {
+  const sync = new ClockSync();
+  for (let i = 0; i < 20; i++) exchange(sync, APP_START + i * 1000, 10, 30);
+
+  expect(sync.stats().driftPpm).toBeCloseTo(DRIFT_PPM, -1);
+  expect(maxError(sync, APP_START, APP_START + 30_000)).toBeLessThanOrEqual(
+    10 + 1,
+  );
+});
+
+test('high-RTT exchanges are ignored', () => {
+  const sync = new ClockSync();
+  for (let i = 0; i < 20; i++) {
+    const sentAt = APP_START + i * 1000;
+    exchange(sync, sentAt, 15, 15);
+    // BT 버퍼링으로 늦게 처리된 응답: 쓰면 오프셋이 수백 ms 틀어진다
+    exchange(sync, sentAt + 500, 390, 10);
+  }
+  // 허용 범위를 넘는 왕복은 세지도 않는다
+  exchange(sync, APP_START + 21_000, 1500, 10);
+
+  const stats = sync.stats();
+  expect(stats.exchanges).toBe(40);
+  expect(stats.minRttMs).toBe(30);
+  expect(stats.driftPpm).toBeCloseTo(DRIFT_PPM, -1);
+  expect(maxError(sync, APP_START, APP_START + 30_000)).toBeLessThan(1);
+});
@@ -0,0 +1,104 @@
+/**
+ * @format
+ */
+
+import { CommandCancelledError, CommandQueue } from '../services/commandQueue';
+
+/** write마다 직접 끝낼 수 있는 writer */
+function manualWriter() {
+  const writes: string[] = [];
+  const finish: (() => void)[] = [];
+  const writer = (data: string) =>
+    new Promise<void>(resolve => {
+      writes.push(data);
+      finish.push(resolve);
+    });
+  return { writer, writes, finish };
+}
+
+// 실제 타이머에서만 쓴다 (가짜 타이머는 setImmediate도 멈춘다)
+const flush = () => new Promise<void>(resolve => setImmediate(resolve));
+
+afterEach(() => {
+  jest.useRealTimers();
+});
+
+test('coalesced commands resolve in the order they were requested', async () => {
+  const { writer, writes, finish } = manualWriter();
+  const queue = new CommandQueue(writer);
+  const resolved: string[] = [];
+  const send = (command: string) =>
+    queue.enqueue(command).then(() => resolved.push(command));
+
+  send('S:1.0');
+  send('S:2.0');
+  send('S:3.0');
+  finish[0]();
+  await flush();
+  finish[1]();
+  await flush();
+
+  expect(writes).toEqual(['S:1.0\n', 'S:3.0\n']);
+  expect(queue.getStats().coalesced).toBe(1);
+  expect(resolved).toEqual(['S:1.0', 'S:2.0', 'S:3.0']);
+});
+
+test('a superseded command resolves before the command that replaced it', async () => {
+  jest.useFakeTimers();
+  const queue = new CommandQueue(async () => undefined, {
+    ackTimeoutMs: 300,
+  });
+  const resolved: string[] = [];
+  queue.enqueue('S:1.0').then(() => resolved.push('S:1.0'));
+  await jest.advanceTimersByTimeAsync(0);
+  queue.enqueue('S:2.0').then(() => resolved.push('S:2.0'));
+  await jest.advanceTimersByTimeAsync(0);
+
+  // S:1.0#0의 ACK는 오지 않고 S:2.0#1이 대신 확인된다
+  expect(queue.getStats().superseded).toBe(1);
+  queue.acknowledge(1);
+  await jest.advanceTimersByTimeAsync(0);
+  expect(resolved).toEqual(['S:1.0', 'S:2.0']);
+});
+
+test('an ACK timeout hands its waiters to a newer pending command first', async () => {
+  jest.useFakeTimers();
+  const { writer, writes, finish } = manualWriter();
+  const queue = new CommandQueue(writer, { ackTimeoutMs: 300 });
+  const resolved: string[] = [];
+  queue.enqueue('S:1.0').then(() => resolved.push('S:1.0'));
+  finish[0]();
+  await jest.advanceTimersByTimeAsync(0);
+
+  // T: write가 끝나지 않아 S:2.0은 대기열에 남는다
+  queue.enqueue('T:140');
+  await jest.advanceTimersByTimeAsync(0);
+  queue.acknowledge(1);
+  queue.enqueue('S:2.0').then(() => resolved.push('S:2.0'));
+  jest.advanceTimersByTime(300);
+  finish[1]();
+  await jest.advanceTimersByTimeAsync(0);
+
+  expect(writes).toEqual(['S:1.0#0\n', 'T:140#1\n', 'S:2.0#2\n']);
+  queue.acknowledge(2);
+  await jest.advanceTimersByTimeAsync(0);
+  expect(resolved).toEqual(['S:1.0', 'S:2.0']);
+});
+
+test('STOP cancels queued speed commands', async () => {
+  const { writer, writes, finish } = manualWriter();
+  const queue = new CommandQueue(writer);
+  queue.enqueue('T:140');
+  const speed = queue.enqueue('S:5.0');
+  const stop = queue.sendUrgent('STOP', {
+    cancel: ['S'],
+    resendIntervalMs: 100,
+    maxDurationMs: 1000,
+  });
+
+  await expect(speed).rejects.toBeInstanceOf(CommandCancelledError);
+  expect(writes).toEqual(['T:140\n', 'STOP\n']);
+  finish.forEach(done => done());
+  queue.clear();
+  await stop.catch(() => undefined);
+});
@@ -0,0 +1,43 @@
+/**
+ * @format
+ */
+
+import { EcgRateEstimator, EcgRingBuffer } from '../services/ecgBuffer';
+
+// 네이티브 drain처럼 40 ms마다 묶여서 도착하는 샘플
+function measure(hz: number, seconds: number): number[] {
+  const estimator = new EcgRateEstimator();
+  const estimates: number[] = [];
+  for (let i = 0; i < hz * seconds; i++) {
+    const arrivedAt = Math.ceil((i * 1000) / hz / 40) * 40;
+    const rate = estimator.push(arrivedAt);
+    if (!isNaN(rate)) estimates.push(rate);
+  }
+  return estimates;
+}
+
+test('measures 250 and 500 Hz streams from batched arrivals', () => {
+  expect(measure(250, 5)).toEqual([250, 250]);
+  expect(measure(500, 5)).toEqual([500, 500]);
+});
+
+test('a gap in the stream restarts the measurement window', () => {
+  const estimator = new EcgRateEstimator();
+  for (let t = 0; t < 1500; t += 4) estimator.push(t);
+  // 링크가 1초 멈춘 뒤: 공백을 샘플링 간격으로 세지 않는다
+  const estimates: number[] = [];
+  for (let t = 2500; t < 5000; t += 4) {
+    const rate = estimator.push(t);
+    if (!isNaN(rate)) estimates.push(rate);
+  }
+  expect(estimates).toEqual([250]);
+});
+
+test('changing the sample rate keeps the buffered duration', () => {
+  const buffer = new EcgRingBuffer(250 * 16, 250);
+  buffer.push(1);
+  buffer.setSampleRate(500);
+  expect(buffer.sampleRateHz).toBe(500);
+  expect(buffer.capacity).toBeGreaterThanOrEqual(500 * 16);
+  expect(buffer.totalWritten).toBe(0);
+});
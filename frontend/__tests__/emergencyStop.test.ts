@@ -0,0 +1,111 @@
+/**
+ * @format
+ */
+
+import { ArduinoBridge } from '../services/arduinoBridge';
+import { LoopbackTransport } from '../services/transport';
+
+jest.mock('react-native-bluetooth-classic', () => ({}));
+
+afterEach(() => {
+  jest.useRealTimers();
+});
+
+// 유휴 루프백이 stalled로 넘어가기 전에 재연결 직후를 본다
+async function untilReconnected(bridge: ArduinoBridge) {
+  for (let i = 0; i < 100 && bridge.getState() === 'reconnecting'; i++) {
+    await jest.advanceTimersByTimeAsync(50);
+  }
+}
+
+async function connect(commandAcks = false) {
+  const transport = new LoopbackTransport();
+  const writes: string[] = [];
+  transport.onWrite(data => writes.push(data));
+  const bridge = new ArduinoBridge({ transport, commandAcks });
+  await bridge.connect('sim');
+  return { bridge, transport, writes };
+}
+
+test('without ACKs, STOP completes on write and belt stop is timed separately', async () => {
+  jest.useFakeTimers();
+  const { bridge, transport, writes } = await connect();
+  transport.emit('SPD:8.0\n');
+
+  await bridge.sendEmergencyStop();
+  // 벨트가 감속하는 동안 STOP을 다시 보내지 않는다
+  jest.advanceTimersByTime(1500);
+  transport.emit('SPD:4.0\n');
+  jest.advanceTimersByTime(1500);
+  transport.emit('SPD:0.0\n');
+  await jest.advanceTimersByTimeAsync(0);
+
+  expect(writes.filter(data => data === 'STOP\n')).toHaveLength(1);
+  expect(bridge.getCommandLatency().STOP.count).toBe(1);
+  expect(bridge.getCommandLatency().STOP.p50).toBeLessThan(100);
+  expect(bridge.getBeltStopTime().count).toBe(1);
+  expect(bridge.getBeltStopTime().p50).toBeGreaterThanOrEqual(3000);
+  await bridge.disconnect();
+});
+
+test('STOP pressed while reconnecting is sent before any setpoint replay', async () => {
+  jest.useFakeTimers();
+  const { bridge, transport, writes } = await connect();
+  await bridge.setSpeed(8);
+
+  transport.acceptConnections = false;
+  transport.drop();
+  expect(bridge.getState()).toBe('reconnecting');
+  let stopped = false;
+  const stop = bridge.sendEmergencyStop().then(() => {
+    stopped = true;
+  });
+  await jest.advanceTimersByTimeAsync(2000);
+  expect(stopped).toBe(false);
+
+  writes.length = 0;
+  transport.acceptConnections = true;
+  await untilReconnected(bridge);
+  await stop;
+
+  expect(bridge.getState()).toBe('connected');
+  expect(stopped).toBe(true);
+  const commands = writes.filter(data => data !== 'READY\n');
+  expect(commands[0]).toBe('STOP\n');
+  expect(commands).not.toContain('S:8.0\n');
+  await bridge.disconnect();
+});
+
+test('a STOP cut off by a link drop is resent after reconnect', async () => {
+  jest.useFakeTimers();
+  const { bridge, transport, writes } = await connect(true);
+  const stop = bridge.sendEmergencyStop();
+  expect(writes).toContain('STOP#0\n');
+
+  // ACK 전에 끊긴다
+  transport.drop();
+  await untilReconnected(bridge);
+  expect(bridge.getState()).toBe('connected');
+  const resent = writes.filter(data => data.startsWith('STOP#')).pop()!;
+  expect(resent).not.toBe('STOP#0\n');
+
+  transport.emit(`ACK:${resent.slice(5).trim()}\n`);
+  await expect(stop).resolves.toBeUndefined();
+  await bridge.disconnect();
+});
+
+test('giving up on reconnect rejects a latched STOP', async () => {
+  jest.useFakeTimers();
+  const { bridge, transport } = await connect();
+  transport.acceptConnections = false;
+  transport.drop();
+  const stop = bridge.sendEmergencyStop();
+  const outcome = stop.then(
+    () => 'stopped',
+    () => 'failed',
+  );
+
+  await jest.advanceTimersByTimeAsync(10 * 60 * 1000);
+  expect(bridge.getState()).toBe('disconnected');
+  expect(await outcome).toBe('failed');
+});
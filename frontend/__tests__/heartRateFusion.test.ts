@@ -0,0 +1,62 @@
+/**
+ * @format
+ */
+
+import {
+  HeartRateFusion,
+  HeartRateSourceKey,
+} from '../services/heartRateFusion';
+
+// 4분 주기로 80~120 bpm을 오가는 실제 심박
+function trueHr(atMs: number): number {
+  return 100 + 20 * Math.sin((2 * Math.PI * atMs) / 240000);
+}
+
+type Measurement = [number, HeartRateSourceKey, number];
+
+// 각 소스는 자기 지연만큼 과거의 심박을 보고한다. 벨트와 폰 박동은 60~120초에 끊긴다
+function measurements(): Measurement[] {
+  const out: Measurement[] = [];
+  const dropped = (t: number) => t >= 60000 && t < 120000;
+  for (let t = 0; t < 180000; t += 1000) {
+    out.push([t, 'device', trueHr(t - 3000)]);
+    if (!dropped(t)) out.push([t + 500, 'strap', trueHr(t + 500 - 1000)]);
+  }
+  for (let t = 100; t < 180000; t += 800) {
+    if (!dropped(t)) {
+      out.push([t, 'beat', trueHr(t - 300) + 3 * Math.sin(t * 0.37)]);
+    }
+  }
+  return out.sort((a, b) => a[0] - b[0]);
+}
+
+test('dropping sources leaves no gap or jump in the fused heart rate', () => {
+  const fusion = new HeartRateFusion();
+  let previous = NaN;
+  let previousAt = NaN;
+  let maxStep = 0;
+  let maxGapMs = 0;
+  let maxError = 0;
+
+  measurements().forEach(([atMs, key, bpm]) => {
+    expect(fusion.update(key, bpm, atMs)).toBe(true);
+    // 처음 10초는 지연/잡음 추정이 자리 잡는 구간
+    if (atMs >= 10000) {
+      maxStep = Math.max(maxStep, Math.abs(fusion.bpm - previous));
+      maxGapMs = Math.max(maxGapMs, atMs - previousAt);
+      maxError = Math.max(maxError, Math.abs(fusion.bpm - trueHr(atMs)));
+    }
+    previous = fusion.bpm;
+    previousAt = atMs;
+  });
+
+  // 기기 BPM:만 남아도 1초마다 계속 갱신된다
+  expect(maxGapMs).toBeLessThanOrEqual(1000);
+  expect(maxStep).toBeLessThan(2.5);
+  // 기기 소스만일 때는 그 지연(3초)만큼의 기울기 오차가 있을 수 있다
+  expect(maxError).toBeLessThan(3);
+
+  const stats = fusion.sourceStats();
+  expect(stats.device.updates).toBe(180);
+  expect(stats.strap.lastAt).toBeGreaterThanOrEqual(120000);
+});
@@ -0,0 +1,60 @@
+/**
+ * @format
+ */
+
+import {
+  HeartRateMeasurement,
+  parseHeartRateMeasurement,
+} from '../services/heartRateStrap';
+
+jest.mock('react-native-ble-plx', () => ({}));
+
+// 0x2A37 알림 값 (벨트에서 받은 그대로의 바이트)
+test.each<[string, number[], HeartRateMeasurement]>([
+  [
+    '8-bit HR, no contact support',
+    [0x00, 0x48],
+    { bpm: 72, contact: null, energyKj: null, rrMs: [] },
+  ],
+  [
+    '8-bit HR, contact + one RR (chest strap)',
+    [0x16, 0x4b, 0x60, 0x03],
+    { bpm: 75, contact: true, energyKj: null, rrMs: [844] },
+  ],
+  [
+    'contact supported but not detected',
+    [0x04, 0x00],
+    { bpm: 0, contact: false, energyKj: null, rrMs: [] },
+  ],
+  [
+    '16-bit HR',
+    [0x01, 0x2c, 0x01],
+    { bpm: 300, contact: null, energyKj: null, rrMs: [] },
+  ],
+  [
+    'energy expended is skipped before RR',
+    [0x18, 0x5a, 0x10, 0x27, 0x00, 0x04],
+    { bpm: 90, contact: null, energyKj: 10000, rrMs: [1000] },
+  ],
+  [
+    '16-bit HR, energy and two RR intervals',
+    [0x1f, 0x78, 0x00, 0x05, 0x00, 0x00, 0x02, 0x00, 0x02],
+    { bpm: 120, contact: true, energyKj: 5, rrMs: [500, 500] },
+  ],
+  [
+    'trailing odd byte after RR is ignored',
+    [0x10, 0x3c, 0x00, 0x04, 0x7f],
+    { bpm: 60, contact: null, energyKj: null, rrMs: [1000] },
+  ],
+])('parses %s', (_name, bytes, expected) => {
+  expect(parseHeartRateMeasurement(Uint8Array.from(bytes))).toEqual(expected);
+});
+
+test.each<[string, number[]]>([
+  ['empty', []],
+  ['flags only', [0x00]],
+  ['16-bit HR missing its high byte', [0x01, 0x48]],
+  ['energy expended cut short', [0x08, 0x48, 0x10]],
+])('rejects truncated payload: %s', (_name, bytes) => {
+  expect(parseHeartRateMeasurement(Uint8Array.from(bytes))).toBeNull();
+});
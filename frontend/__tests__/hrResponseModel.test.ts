@@ -0,0 +1,82 @@
+/**
+ * @format
+ */
+
+import { HrModelParams, HrResponseModel } from '../services/hrResponseModel';
+
+const GAIN = 8;
+const TIME_CONSTANT_S = 40;
+const DEAD_TIME_S = 12;
+
+// 90초마다 6 ↔ 10 km/h로 바꾸는 인터벌
+function speedAt(second: number): number {
+  return Math.floor(second / 90) % 2 === 0 ? 6 : 10;
+}
+
+/** FOPDT 사용자에게 seconds초 동안 인터벌을 시키고 1초마다 관측을 넣는다 */
+function drive(model: HrResponseModel, seconds: number) {
+  const decay = Math.exp(-1 / TIME_CONSTANT_S);
+  let v = speedAt(0);
+  for (let t = 0; t < seconds; t++) {
+    v = decay * v + (1 - decay) * speedAt(Math.max(0, t - DEAD_TIME_S));
+    // 박동 간 변이만큼의 작은 잡음
+    const bpm = 70 + GAIN * v + Math.sin(t * 1.7);
+    model.observe(speedAt(t), bpm, t * 1000);
+  }
+}
+
+test('recovers K, tau and theta from a synthetic FOPDT response', () => {
+  const model = new HrResponseModel();
+  drive(model, 60);
+  expect(model.isReady).toBe(false);
+
+  drive(model, 900);
+  const stats = model.getStats();
+  expect(stats.source).toBe('session');
+  expect(stats.params!.deadTimeS).toBe(DEAD_TIME_S);
+  expect(stats.params!.timeConstantS).toBe(TIME_CONSTANT_S);
+  expect(stats.params!.gain).toBeCloseTo(GAIN, 0);
+  expect(stats.params!.r2).toBeGreaterThan(0.95);
+});
+
+const STORED: HrModelParams = {
+  gain: GAIN,
+  timeConstantS: TIME_CONSTANT_S,
+  deadTimeS: DEAD_TIME_S,
+  r2: 0.97,
+  samples: 900,
+};
+
+test('a warm start predicts before any session fit', () => {
+  const model = new HrResponseModel();
+  expect(model.warmStart(STORED)).toBe(true);
+  expect(model.getStats().source).toBe('stored');
+
+  // 6 km/h에 머물던 사람이 7 km/h로 올리면: 데드타임 동안은 그대로, 그 뒤 K만큼 오른다
+  model.observe(6, 118, 0);
+  const out = new Float64Array(300);
+  expect(model.predict(118, 7, out)).toBe(true);
+  expect(out[DEAD_TIME_S - 1]).toBeCloseTo(118, 5);
+  expect(out[DEAD_TIME_S + TIME_CONSTANT_S - 1]).toBeCloseTo(
+    118 + GAIN * (1 - Math.exp(-1)),
+    0,
+  );
+  expect(out[299]).toBeCloseTo(118 + GAIN, 0);
+});
+
+test('warm start rejects off-grid params and never overrides a session fit', () => {
+  const model = new HrResponseModel();
+  expect(model.warmStart({ ...STORED, timeConstantS: 37 })).toBe(false);
+  expect(model.warmStart({ ...STORED, gain: 100 })).toBe(false);
+  expect(model.isReady).toBe(false);
+
+  drive(model, 900);
+  expect(model.getStats().source).toBe('session');
+  expect(model.warmStart({ ...STORED, deadTimeS: 0 })).toBe(false);
+  expect(model.params!.deadTimeS).toBe(DEAD_TIME_S);
+
+  // 같은 사용자의 다음 세션은 맞춘 값을 저장된 값처럼 이어 쓴다
+  model.reset(true);
+  expect(model.getStats().source).toBe('stored');
+  expect(model.params!.samples).toBeGreaterThanOrEqual(900);
+});
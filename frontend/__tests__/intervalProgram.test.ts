@@ -0,0 +1,105 @@
+/**
+ * @format
+ */
+
+import {
+  compileProgram,
+  ProgramRunner,
+  WorkoutProgram,
+} from '../services/intervalProgram';
+
+const PROGRAM: WorkoutProgram = {
+  name: 'test',
+  segments: [
+    { label: 'a', durationS: 10, speed: 5 },
+    { label: 'b', durationS: 10, speed: 8 },
+    { label: 'c', durationS: 0.2, speed: 6 },
+    { label: 'd', durationS: 10, speed: 4 },
+  ],
+};
+
+// 속도 명령이 commandMs 뒤에 완료되는 실행 대상
+function makeTarget(commandLatencyMs: number, commandMs: number) {
+  const sent: [number, number][] = [];
+  const target = {
+    sendSpeed: (speed: number) => {
+      sent.push([Date.now(), speed]);
+      return new Promise<void>(resolve => setTimeout(resolve, commandMs));
+    },
+    trackBand: () => {},
+    stopTracking: () => {},
+    commandLatencyMs: () => commandLatencyMs,
+  };
+  return { target, sent };
+}
+
+test('segments are staged ahead of their boundary by the measured lead', async () => {
+  jest.useFakeTimers();
+  jest.setSystemTime(0);
+  const { target, sent } = makeTarget(180, 150);
+  const runner = new ProgramRunner(target, () => Date.now());
+  const indices: number[] = [];
+  runner.onStatusChange(status => indices.push(status.index));
+
+  runner.start(compileProgram(PROGRAM));
+  // 측정값 180 ms + 여유 20 ms. 프로그램 0초는 lead 뒤
+  expect(runner.getStats().leadMs).toBe(200);
+  expect(sent).toEqual([[0, 5]]);
+
+  await jest.advanceTimersByTimeAsync(199);
+  expect(indices).toEqual([]);
+  await jest.advanceTimersByTimeAsync(1);
+  expect(indices).toEqual([0]);
+
+  // 다음 구간의 송신 시각은 앞 구간을 보낼 때 정한다 (아직 자체 측정값 없음: 200 ms)
+  await jest.advanceTimersByTimeAsync(10000 - 200 - 1);
+  expect(sent).toHaveLength(1);
+  await jest.advanceTimersByTimeAsync(1);
+  expect(sent[1]).toEqual([10000, 8]);
+  // 첫 명령이 150 ms에 끝났으므로 이후 lead는 자체 측정값 150 + 20
+  expect(runner.getStats().leadMs).toBe(170);
+
+  await jest.advanceTimersByTimeAsync(199);
+  expect(indices).toEqual([0]);
+  await jest.advanceTimersByTimeAsync(1);
+  expect(indices).toEqual([0, 1]);
+
+  await jest.advanceTimersByTimeAsync(200 + 20000 - 170 - 10200);
+  expect(sent[2]).toEqual([200 + 20000 - 170, 6]);
+  expect(runner.getStats().onTime).toBe(2);
+  runner.stop();
+});
+
+test('lead never exceeds half of the previous segment', async () => {
+  jest.useFakeTimers();
+  jest.setSystemTime(0);
+  const { target, sent } = makeTarget(180, 150);
+  const runner = new ProgramRunner(target, () => Date.now());
+
+  runner.start(compileProgram(PROGRAM));
+  await jest.advanceTimersByTimeAsync(31000);
+
+  // 'c'는 200 ms라서 'd'는 경계 100 ms 전에 보낸다
+  const t0 = 200;
+  expect(sent.map(([, speed]) => speed)).toEqual([5, 8, 6, 4]);
+  expect(sent[3][0]).toBe(t0 + 20200 - 100);
+  expect(runner.getStatus().state).toBe('finished');
+});
+
+test('commands that complete after the boundary are counted late', async () => {
+  jest.useFakeTimers();
+  jest.setSystemTime(0);
+  // 잰 값(30 ms)보다 실제 명령이 훨씬 느리다
+  const { target } = makeTarget(30, 400);
+  const runner = new ProgramRunner(target, () => Date.now());
+
+  runner.start(compileProgram(PROGRAM));
+  await jest.advanceTimersByTimeAsync(1000);
+
+  const stats = runner.getStats();
+  expect(stats.staged).toBe(1);
+  expect(stats.onTime).toBe(0);
+  expect(stats.landingLate.count).toBe(1);
+  expect(stats.landingLate.p50).toBeCloseTo(350, -1);
+  runner.stop();
+});
@@ -0,0 +1,68 @@
+/**
+ * @format
+ */
+
+import { LineFramer, LineView } from '../services/lineFramer';
+
+function collect(capacity?: number) {
+  const lines: string[] = [];
+  const framer = new LineFramer(
+    (line: LineView) => lines.push(line.toString()),
+    capacity,
+  );
+  return { framer, lines };
+}
+
+test('splits on \\r, \\r\\n, \\n and literal \\\\r', () => {
+  const { framer, lines } = collect();
+  framer.pushString('BPM:72\r\nSPD:5.5\rBPM:80\\rN:140\n');
+  expect(lines).toEqual(['BPM:72', 'SPD:5.5', 'BPM:80', 'N:140']);
+});
+
+test('reassembles lines split across 1-byte chunks', () => {
+  const { framer, lines } = collect();
+  for (const ch of ' BPM:91 \\rSPD:3.0\r\n') {
+    framer.pushString(ch);
+  }
+  expect(lines).toEqual(['BPM:91', 'SPD:3.0']);
+});
+
+test('parses numbers without building strings', () => {
+  const values: number[] = [];
+  const framer = new LineFramer(line => {
+    values.push(
+      line.startsWith('SPD:') ? line.parseFloatAt(4) : line.parseIntAt(4),
+    );
+  });
+  framer.pushString('BPM: 123\rSPD:-2.75\rBPM:x\r');
+  expect(values).toEqual([123, -2.75, NaN]);
+});
+
+test('line views stay correct across the ring wrap point', () => {
+  const { framer, lines } = collect(8);
+  framer.pushString('ABCDE\rFGHIJ\rKLMNO\r');
+  expect(lines).toEqual(['ABCDE', 'FGHIJ', 'KLMNO']);
+});
+
+test('overflow drops only the oldest frame and keeps parsing', () => {
+  const lines: string[] = [];
+  const framer = new LineFramer(
+    line => lines.push(line.toString()),
+    16,
+    ['BPM:', 'SPD:'],
+  );
+  // 종결자가 빠진 버스트: 가장 오래된 프레임만 버려지고, 붙어 있던 프레임은 나뉘어야 한다
+  framer.pushString('xxBPM:70SPD:4.5BPM:71\rSPD:4.6\r');
+  expect(lines).toEqual(['SPD:4.5', 'BPM:71', 'SPD:4.6']);
+  expect(framer.getStats()).toEqual({ droppedBytes: 8, droppedFrames: 2 });
+});
+
+test('values that look like frame starts are not split without an overflow', () => {
+  const lines: string[] = [];
+  const framer = new LineFramer(line => lines.push(line.toString()), 16, [
+    'BPM:',
+    'STS:',
+  ]);
+  framer.pushString('STS:BPM:low\r');
+  expect(lines).toEqual(['STS:BPM:low']);
+});
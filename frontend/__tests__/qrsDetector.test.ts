@@ -0,0 +1,66 @@
+/**
+ * @format
+ */
+
+import { ArduinoBridge } from '../services/arduinoBridge';
+import { BeatEvent, QrsDetector } from '../services/qrsDetector';
+import { LoopbackTransport } from '../services/transport';
+
+jest.mock('react-native-bluetooth-classic', () => ({}));
+
+const RR_SECONDS = 0.8; // 75 bpm
+
+/** R 피크 + T파 + 기저선 흔들림으로 만든 합성 ECG */
+function ecgAt(index: number, sampleRateHz: number): number {
+  const t = index / sampleRateHz;
+  const phase = t % RR_SECONDS;
+  const r = 1000 * Math.exp(-(((phase - 0.4) / 0.012) ** 2));
+  const tWave = 150 * Math.exp(-(((phase - 0.65) / 0.04) ** 2));
+  const baseline = 50 * Math.sin(2 * Math.PI * 0.3 * t);
+  return Math.round(r + tWave + baseline);
+}
+
+function detect(sampleRateHz: number, seconds: number): BeatEvent[] {
+  const beats: BeatEvent[] = [];
+  const detector = new QrsDetector(sampleRateHz, beat => beats.push(beat));
+  for (let i = 0; i < sampleRateHz * seconds; i++) {
+    detector.push(ecgAt(i, sampleRateHz));
+  }
+  return beats;
+}
+
+test.each([250, 500])('detects 75 bpm at %i Hz', sampleRateHz => {
+  const beats = detect(sampleRateHz, 20);
+  // 학습 구간(2초) 뒤로는 박동을 하나도 놓치지 않는다
+  expect(beats.length).toBeGreaterThanOrEqual(20 / RR_SECONDS - 4);
+  beats.forEach(beat => {
+    expect(beat.rrMs).toBeCloseTo(RR_SECONDS * 1000, -1);
+    expect(beat.bpm).toBeCloseTo(75, 0);
+  });
+});
+
+test('bridge rebuilds the detector for a 500 Hz stream', async () => {
+  jest.useFakeTimers();
+  const transport = new LoopbackTransport();
+  const bridge = new ArduinoBridge({ transport });
+  const beats: number[] = [];
+  bridge.onBeat(beat => beats.push(beat.bpm));
+  await bridge.connect('sim');
+
+  // EHZ: 없이 40 ms마다 20샘플씩: 주파수는 도착 샘플 수로 잰다
+  const sampleRateHz = 500;
+  let index = 0;
+  for (let tick = 0; tick < 15 * 25; tick++) {
+    let chunk = '';
+    for (let i = 0; i < 20; i++, index++) {
+      chunk += `ECG:${ecgAt(index, sampleRateHz)}\n`;
+    }
+    transport.emit(chunk);
+    jest.advanceTimersByTime(40);
+  }
+
+  expect(bridge.getEcgWaveform().sampleRateHz).toBe(500);
+  expect(beats.length).toBeGreaterThan(5);
+  beats.forEach(bpm => expect(bpm).toBeCloseTo(75, 0));
+  await bridge.disconnect();
+});
@@ -0,0 +1,160 @@
+/**
+ * @format
+ */
+
+import { SpeedController } from '../services/speedController';
+
+afterEach(() => {
+  jest.useRealTimers();
+});
+
+// 심박은 테스트가 직접 정하고, 보낸 속도는 기록만 하는 제어 대상
+function makeTarget() {
+  const state = { bpm: 100, updatedAtMs: NaN, fresh: true };
+  const sent: number[] = [];
+  const target = {
+    heartRate: () => ({
+      bpm: state.bpm,
+      slope: 0,
+      sigmaBpm: 1,
+      updatedAtMs: state.fresh ? Date.now() : state.updatedAtMs,
+    }),
+    isConnected: () => true,
+    sendSpeed: (speed: number) => {
+      sent.push(speed);
+      return Promise.resolve();
+    },
+    responseModel: () => null,
+  };
+  return { target, state, sent };
+}
+
+const BAND = { low: 130, high: 140 };
+
+test('output clamps at max speed and leaves it as soon as HR overshoots', () => {
+  jest.useFakeTimers();
+  const { target, state, sent } = makeTarget();
+  const controller = new SpeedController(target, {
+    maxSpeed: 10,
+    now: () => Date.now(),
+  });
+
+  // 심박이 한참 낮아 최고 속도에 계속 걸려 있다
+  state.bpm = 80;
+  controller.start(BAND, 9);
+  jest.advanceTimersByTime(120000);
+  expect(Math.max(...sent)).toBe(10);
+  expect(controller.getStatus().speed).toBe(10);
+  expect(controller.getStats().saturated).toBeGreaterThan(100);
+
+  // anti-windup: 한도에 걸린 동안 적분이 쌓이지 않았으므로 바로 내려온다
+  state.bpm = 160;
+  jest.advanceTimersByTime(5000);
+  expect(controller.getStatus().speed).toBeLessThan(10);
+  controller.stop();
+});
+
+test('output clamps at min speed', () => {
+  jest.useFakeTimers();
+  const { target, state, sent } = makeTarget();
+  const controller = new SpeedController(target, {
+    minSpeed: 3,
+    now: () => Date.now(),
+  });
+
+  state.bpm = 180;
+  controller.start(BAND, 4);
+  jest.advanceTimersByTime(60000);
+  expect(Math.min(...sent)).toBe(3);
+  expect(controller.getStatus().speed).toBe(3);
+  controller.stop();
+});
+
+test('speed changes respect the accel and decel limits', () => {
+  jest.useFakeTimers();
+  const { target, state, sent } = makeTarget();
+  // 적분 이득을 크게 해서 매 틱 가속/감속 한도에 걸리게 한다
+  const controller = new SpeedController(target, {
+    ki: 0.05,
+    maxAccelPerS: 0.1,
+    maxDecelPerS: 0.3,
+    now: () => Date.now(),
+  });
+
+  state.bpm = 60;
+  controller.start(BAND, 6);
+  jest.advanceTimersByTime(30000);
+  // 첫 틱은 현재 속도를 이어받고, 그 뒤로 1초마다 0.1 km/h씩
+  expect(controller.getStatus().speed).toBeCloseTo(8.9, 5);
+
+  state.bpm = 200;
+  const before = controller.getStatus().speed;
+  jest.advanceTimersByTime(5000);
+  expect(before - controller.getStatus().speed).toBeCloseTo(1.5, 5);
+  const steps = sent.slice(1).map((speed, i) => Math.abs(speed - sent[i]));
+  expect(Math.max(...steps)).toBeLessThanOrEqual(0.3 + 1e-9);
+  controller.stop();
+});
+
+test('holds speed on stale heart rate and resumes when it is fresh', () => {
+  jest.useFakeTimers();
+  const { target, state, sent } = makeTarget();
+  const controller = new SpeedController(target, {
+    staleAfterMs: 5000,
+    now: () => Date.now(),
+  });
+
+  state.bpm = 100;
+  controller.start(BAND, 6);
+  jest.advanceTimersByTime(10000);
+  expect(sent.length).toBeGreaterThan(0);
+
+  // 마지막 측정이 지금 시각에 멈춘다
+  state.fresh = false;
+  state.updatedAtMs = Date.now();
+  jest.advanceTimersByTime(5000);
+  expect(controller.getStatus().mode).toBe('tracking');
+  jest.advanceTimersByTime(20000);
+  expect(controller.getStatus().mode).toBe('holding');
+  expect(controller.getStatus().holdReason).toBe('stale');
+  expect(controller.getStats().holds).toBeGreaterThanOrEqual(19);
+
+  // 멈춘 동안은 명령을 보내지 않는다
+  const held = sent.length;
+  const heldSpeed = controller.getStatus().speed;
+  jest.advanceTimersByTime(30000);
+  expect(sent).toHaveLength(held);
+  expect(controller.getStatus().speed).toBe(heldSpeed);
+
+  state.fresh = true;
+  jest.advanceTimersByTime(1000);
+  expect(controller.getStatus().mode).toBe('tracking');
+  controller.stop();
+});
+
+test('missed ticks are skipped instead of replayed', () => {
+  jest.useFakeTimers();
+  const { target, state } = makeTarget();
+  let frozenMs = 0;
+  const controller = new SpeedController(target, {
+    now: () => Date.now() + frozenMs,
+  });
+
+  state.bpm = 100;
+  controller.start(BAND, 6);
+  jest.advanceTimersByTime(3000);
+  const ticks = controller.getStats().ticks;
+
+  // 앱이 10.5초 멈췄다가 다음 틱이 늦게 돈다
+  frozenMs = 10500;
+  jest.advanceTimersByTime(1000);
+  const stats = controller.getStats();
+  expect(stats.ticks).toBe(ticks + 1);
+  expect(stats.skippedTicks).toBe(10);
+  expect(stats.tickLateness.max).toBeGreaterThanOrEqual(10000);
+
+  // 다음 틱은 원래 1초 격자에 맞춰 돈다
+  jest.advanceTimersByTime(1000);
+  expect(controller.getStats().ticks).toBe(ticks + 2);
+  controller.stop();
+});
@@ -0,0 +1,117 @@
+/**
+ * @format
+ */
+
+import { LineFramer, LineView } from '../services/lineFramer';
+import {
+  DispatchResult,
+  TELEMETRY_CHANNEL_KEYS,
+  TELEMETRY_CHANNELS,
+  TelemetryChannelKey,
+  TelemetryDispatcher,
+} from '../services/telemetryChannels';
+
+type Received = [TelemetryChannelKey, unknown, number];
+
+// 모든 채널을 구독하고, 한 줄씩 framer를 거쳐 dispatch한다
+function setup() {
+  const dispatcher = new TelemetryDispatcher();
+  const received: Received[] = [];
+  TELEMETRY_CHANNEL_KEYS.forEach(key => {
+    dispatcher.on(key, value =>
+      received.push([key, value, dispatcher.deviceTimeMs]),
+    );
+  });
+  let result: DispatchResult | null = null;
+  const framer = new LineFramer((line: LineView) => {
+    result = dispatcher.dispatch(line);
+  });
+  const dispatch = (line: string): DispatchResult | null => {
+    result = null;
+    framer.pushString(line + '\n');
+    return result;
+  };
+  return { dispatch, received };
+}
+
+const SAMPLE_VALUES: { [K in TelemetryChannelKey]: [string, unknown] } = {
+  bpm: ['72', 72],
+  speed: ['5.5', 5.5],
+  targetEcho: ['140', 140],
+  rr: ['833', 833],
+  incline: ['-1.5', -1.5],
+  distance: ['0.42', 0.42],
+  status: [' Running ', 'Running'],
+  protocol: ['1', 1],
+  ecg: ['-312', -312],
+  ecgRate: ['250', 250],
+  ack: ['17', 17],
+  pong: ['9', 9],
+};
+
+test.each(TELEMETRY_CHANNEL_KEYS)('%s lines reach only their channel', key => {
+  const { dispatch, received } = setup();
+  const [text, value] = SAMPLE_VALUES[key];
+
+  expect(dispatch(TELEMETRY_CHANNELS[key].prefix + text)).toBe('ok');
+  expect(received).toEqual([[key, value, NaN]]);
+});
+
+test('registered prefixes are distinct and fit the packed key', () => {
+  const prefixes = TELEMETRY_CHANNEL_KEYS.map(
+    key => TELEMETRY_CHANNELS[key].prefix,
+  );
+  expect(new Set(prefixes).size).toBe(prefixes.length);
+  prefixes.forEach(prefix => {
+    expect(prefix.endsWith(':')).toBe(true);
+    expect(prefix.length - 1).toBeLessThanOrEqual(4);
+  });
+});
+
+test.each([
+  // 등록된 접두사의 앞/뒤를 자르거나 늘린 것은 다른 키다
+  ['PON:9', 'unknown'],
+  ['PONGS:9', 'unknown'],
+  ['XBPM:72', 'unknown'],
+  ['BP:72', 'unknown'],
+  ['NN:140', 'unknown'],
+  // NUL이 앞에 붙어도 짧은 접두사와 같은 키가 되지 않는다
+  ['\0N:140', 'unknown'],
+  ['\0BPM:72', 'unknown'],
+  // 대소문자를 구분한다
+  ['bpm:72', 'unknown'],
+  // 콜론이 4바이트 안에 없다
+  ['BPM72', 'unknown'],
+  ['ABCDE:1', 'unknown'],
+  [':72', 'unknown'],
+  // 접두사는 맞지만 값이 없거나 숫자가 아니다
+  ['BPM:', 'invalid'],
+  ['BPM:x', 'invalid'],
+  ['SPD:.', 'invalid'],
+  ['STS:   ', 'invalid'],
+  ['STS:@1234', 'invalid'],
+])('%j is %s', (line, expected) => {
+  const { dispatch, received } = setup();
+
+  expect(dispatch(line)).toBe(expected);
+  expect(received).toEqual([]);
+});
+
+test('the @<ms> suffix becomes the device time', () => {
+  const { dispatch, received } = setup();
+
+  dispatch('BPM:72@183204');
+  dispatch('SPD:5.5 @183300');
+  dispatch('STS:Paused @ noon@183400');
+  // 숫자가 없는 접미사는 시각이 없는 것으로 본다
+  dispatch('RR:833@');
+  dispatch('N:140');
+
+  expect(received).toEqual([
+    ['bpm', 72, 183204],
+    ['speed', 5.5, 183300],
+    ['status', 'Paused @ noon', 183400],
+    ['rr', 833, NaN],
+    ['targetEcho', 140, NaN],
+  ]);
+});
@@ -0,0 +1,137 @@
+/**
+ * @format
+ */
+
+import { ArduinoBridge } from '../services/arduinoBridge';
+import {
+  CaptureRecorder,
+  ReplayTransport,
+  decodeCapture,
+} from '../services/trafficCapture';
+import { LoopbackTransport } from '../services/transport';
+
+jest.mock('react-native-bluetooth-classic', () => ({}));
+
+function text(bytes: Uint8Array): string {
+  return String.fromCharCode(...bytes);
+}
+
+function record(): Uint8Array {
+  const recorder = new CaptureRecorder();
+  recorder.recordText('BPM:7', 0);
+  recorder.recordText('2\nSPD:5.5\n', 12.5);
+  recorder.recordBytes(
+    Uint8Array.from([0x53, 0x54, 0x53, 0x3a, 0xe9]),
+    40.25,
+  );
+  // 1초 간격은 3바이트 varint가 된다
+  recorder.recordText('\n', 1040.25);
+  expect(recorder.chunks).toBe(4);
+  return recorder.toBytes();
+}
+
+test('chunk boundaries and offsets survive a round trip', () => {
+  const chunks = decodeCapture(record());
+
+  expect(chunks.map(chunk => chunk.offsetMs)).toEqual([
+    0, 12.5, 40.25, 1040.25,
+  ]);
+  expect(chunks.map(chunk => text(chunk.bytes))).toEqual([
+    'BPM:7',
+    '2\nSPD:5.5\n',
+    'STS:é',
+    '\n',
+  ]);
+});
+
+test('text chunks are stored as latin1 bytes', () => {
+  const recorder = new CaptureRecorder();
+  recorder.recordText('STS:é', 0);
+  expect(Array.from(decodeCapture(recorder.toBytes())[0].bytes)).toEqual([
+    0x53, 0x54, 0x53, 0x3a, 0xe9,
+  ]);
+});
+
+test('truncated or foreign input is rejected', () => {
+  const capture = record();
+
+  // 마지막 청크의 헤더 한가운데(3바이트 varint)와 본문 직전에서 자른다
+  expect(() => decodeCapture(capture.subarray(0, capture.length - 3))).toThrow(
+    'Truncated traffic capture',
+  );
+  expect(() => decodeCapture(capture.subarray(0, capture.length - 1))).toThrow(
+    'Truncated traffic capture',
+  );
+  // 본문 중간에서 자른다
+  const midChunk = capture.subarray(0, 4 + 2 + 5 + 2 + 4);
+  expect(() => decodeCapture(midChunk)).toThrow('Truncated traffic capture');
+
+  expect(() => decodeCapture(new Uint8Array(0))).toThrow(
+    'Not a traffic capture',
+  );
+  const otherMagic = Uint8Array.from([0x5a, 0x58, 0x43, 0x32]);
+  expect(() => decodeCapture(otherMagic)).toThrow('Not a traffic capture');
+  // 헤더만 있으면 빈 캡처
+  expect(decodeCapture(capture.subarray(0, 4))).toEqual([]);
+});
+
+test('a full recorder drops whole chunks and stays decodable', () => {
+  const recorder = new CaptureRecorder({ maxBytes: 32 });
+  for (let i = 0; i < 10; i++) recorder.recordText('SPD:5.5\n', i);
+
+  expect(recorder.truncated).toBeGreaterThan(0);
+  const chunks = decodeCapture(recorder.toBytes());
+  expect(chunks).toHaveLength(recorder.chunks);
+  chunks.forEach(chunk => expect(text(chunk.bytes)).toBe('SPD:5.5\n'));
+});
+
+type Parsed = [string, number][];
+
+function listen(bridge: ArduinoBridge): Parsed {
+  const parsed: Parsed = [];
+  bridge.onSpeed(speed => parsed.push(['speed', speed]));
+  bridge.onRawHeartRate((source, bpm) => parsed.push([source, bpm]));
+  bridge.onTelemetry('incline', incline => parsed.push(['incline', incline]));
+  bridge.onTelemetry('distance', km => parsed.push(['distance', km]));
+  return parsed;
+}
+
+test('replaying a capture through the bridge yields the same samples', async () => {
+  const transport = new LoopbackTransport();
+  const live = new ArduinoBridge({ transport });
+  const expected = listen(live);
+  await live.connect('sim');
+
+  live.startCapture();
+  // 줄 중간에서 끊긴 청크와 한 청크에 여러 줄이 섞인 현장 입력
+  [
+    'BPM:7',
+    '2\r\nSPD:5',
+    '.5\nINC:1.5\nDST:0.',
+    '42\nBPM:73\n',
+    'S',
+    'PD:6.0\r\n',
+    'BPM:x\nSPD:6.5@1200\n',
+  ].forEach(chunk => transport.emit(chunk));
+  const capture = live.stopCapture()!;
+  await live.disconnect();
+  expect(expected).toEqual([
+    ['device', 72],
+    ['speed', 5.5],
+    ['incline', 1.5],
+    ['distance', 0.42],
+    ['device', 73],
+    ['speed', 6],
+    ['speed', 6.5],
+  ]);
+
+  const replay = new ReplayTransport(capture, { speed: Infinity });
+  const replayed = new ArduinoBridge({ transport: replay });
+  const actual = listen(replayed);
+  await replayed.connect('replay');
+  const stats = await replay.finished;
+  await replayed.disconnect();
+
+  expect(stats.chunks).toBe(7);
+  expect(actual).toEqual(expected);
+});
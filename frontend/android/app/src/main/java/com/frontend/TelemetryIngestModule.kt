@@ -0,0 +1,167 @@
+package com.frontend
+
+import android.annotation.SuppressLint
+import android.bluetooth.BluetoothManager
+import android.bluetooth.BluetoothSocket
+import android.content.Context
+import com.facebook.react.bridge.Promise
+import com.facebook.react.bridge.ReactApplicationContext
+import com.facebook.react.bridge.ReactContextBaseJavaModule
+import com.facebook.react.bridge.ReactMethod
+import com.facebook.react.modules.core.DeviceEventManagerModule
+import com.facebook.soloader.SoLoader
+import java.io.IOException
+import java.util.UUID
+
+/**
+ * HC-06 RFCOMM 소켓을 직접 열고, 읽기 스레드에서 받은 바이트를 C++ TelemetryIngest로 넘긴다.
+ * JS는 global.__telemetryIngest.drain()으로 디코딩된 샘플을 묶음으로 가져간다.
+ */
+class TelemetryIngestModule(reactContext: ReactApplicationContext) :
+    ReactContextBaseJavaModule(reactContext) {
+
+  @Volatile private var socket: BluetoothSocket? = null
+  private var readThread: Thread? = null
+
+  override fun getName(): String = NAME
+
+  /** JS 스레드에서 동기 호출되어 JSI HostObject를 설치한다 */
+  @ReactMethod(isBlockingSynchronousMethod = true)
+  fun install(): Boolean {
+    val runtimePtr = reactApplicationContext.javaScriptContextHolder?.get() ?: 0L
+    if (runtimePtr == 0L) return false
+    nativeInstall(runtimePtr)
+    return true
+  }
+
+  @SuppressLint("MissingPermission")
+  @ReactMethod
+  fun connect(address: String, promise: Promise) {
+    Thread {
+          try {
+            closeSocket()
+            val manager =
+                reactApplicationContext.getSystemService(Context.BLUETOOTH_SERVICE)
+                    as BluetoothManager
+            val adapter = manager.adapter
+            adapter.cancelDiscovery()
+
+            val s = adapter.getRemoteDevice(address).createRfcommSocketToServiceRecord(SPP_UUID)
+            s.connect()
+            socket = s
+            nativeReset()
+            startReader(s)
+            promise.resolve(true)
+          } catch (e: Exception) {
+            closeSocket()
+            promise.reject("E_CONNECT", e.message, e)
+          }
+        }
+        .start()
+  }
+
+  @ReactMethod
+  fun write(data: String, promise: Promise) {
+    val s = socket
+    if (s == null) {
+      promise.reject("E_NOT_CONNECTED", "Device not connected")
+      return
+    }
+    try {
+      s.outputStream.write(data.toByteArray(Charsets.ISO_8859_1))
+      promise.resolve(true)
+    } catch (e: IOException) {
+      promise.reject("E_WRITE", e.message, e)
+    }
+  }
+
+  @ReactMethod
+  fun disconnect(promise: Promise) {
+    closeSocket()
+    promise.resolve(true)
+  }
+
+  @ReactMethod
+  fun isConnected(promise: Promise) {
+    promise.resolve(socket?.isConnected == true)
+  }
+
+  // NativeEventEmitter 요구 사항
+  @ReactMethod fun addListener(eventName: String) {}
+
+  @ReactMethod fun removeListeners(count: Int) {}
+
+  override fun invalidate() {
+    closeSocket()
+    super.invalidate()
+  }
+
+  private fun startReader(s: BluetoothSocket) {
+    readThread =
+        Thread(
+                {
+                  val buffer = ByteArray(READ_BUFFER_SIZE)
+                  try {
+                    val input = s.inputStream
+                    while (!Thread.currentThread().isInterrupted) {
+                      val count = input.read(buffer)
+                      if (count < 0) break
+                      if (count > 0) {
+                        nativePush(buffer, count, System.currentTimeMillis().toDouble())
+                      }
+                    }
+                  } catch (e: IOException) {
+                    // 소켓이 닫히면 read가 예외로 끝난다
+                  }
+
+                  if (socket === s) {
+                    closeSocket()
+                    emitDisconnected()
+                  }
+                },
+                "TelemetryIngestReader")
+            .apply {
+              isDaemon = true
+              priority = Thread.MAX_PRIORITY
+              start()
+            }
+  }
+
+  @Synchronized
+  private fun closeSocket() {
+    val s = socket
+    socket = null
+    readThread?.interrupt()
+    readThread = null
+    try {
+      s?.close()
+    } catch (e: IOException) {
+      // 이미 닫힘
+    }
+  }
+
+  private fun emitDisconnected() {
+    if (!reactApplicationContext.hasActiveReactInstance()) return
+    reactApplicationContext
+        .getJSModule(DeviceEventManagerModule.RCTDeviceEventEmitter::class.java)
+        .emit(EVENT_DISCONNECTED, null)
+  }
+
+  private external fun nativeInstall(runtimePtr: Long)
+
+  private external fun nativePush(bytes: ByteArray, length: Int, timestampMs: Double)
+
+  private external fun nativeReset()
+
+  companion object {
+    const val NAME = "TelemetryIngest"
+    const val EVENT_DISCONNECTED = "TelemetryIngestDisconnected"
+
+    private val SPP_UUID: UUID = UUID.fromString("00001101-0000-1000-8000-00805F9B34FB")
+    private const val READ_BUFFER_SIZE = 1024
+
+    init {
+      SoLoader.loadLibrary("appmodules")
+    }
+  }
+}
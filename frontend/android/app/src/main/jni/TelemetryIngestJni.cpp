@@ -0,0 +1,53 @@
+// TelemetryIngestModule.kt의 external 함수 구현
+
+#include <jni.h>
+#include <jsi/jsi.h>
+
+#include <memory>
+
+#include "TelemetryIngest.h"
+#include "TelemetryIngestHostObject.h"
+
+namespace {
+
+// 읽기 스레드와 JS 런타임이 공유하는 단일 인스턴스 (HC-06 링크는 하나)
+std::shared_ptr<zxis::TelemetryIngest> sharedIngest() {
+  static auto ingest = std::make_shared<zxis::TelemetryIngest>();
+  return ingest;
+}
+
+} // namespace
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_frontend_TelemetryIngestModule_nativeInstall(
+    JNIEnv*,
+    jobject,
+    jlong runtimePtr) {
+  auto* runtime = reinterpret_cast<facebook::jsi::Runtime*>(runtimePtr);
+  if (runtime != nullptr) {
+    zxis::installTelemetryIngest(*runtime, sharedIngest());
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_frontend_TelemetryIngestModule_nativePush(
+    JNIEnv* env,
+    jobject,
+    jbyteArray bytes,
+    jint length,
+    jdouble timestampMs) {
+  jbyte* data = env->GetByteArrayElements(bytes, nullptr);
+  if (data == nullptr) {
+    return;
+  }
+  sharedIngest()->push(
+      reinterpret_cast<const uint8_t*>(data),
+      static_cast<size_t>(length),
+      timestampMs);
+  env->ReleaseByteArrayElements(bytes, data, JNI_ABORT);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_frontend_TelemetryIngestModule_nativeReset(JNIEnv*, jobject) {
+  sharedIngest()->reset();
+}
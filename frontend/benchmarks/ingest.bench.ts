@@ -0,0 +1,51 @@
+/**
+ * 수신 경로 벤치마크. `npm run bench`
+ *
+ * 결과는 benchmarks/results.json에 쓰고 benchmarks/baseline.json과 비교한다.
+ * 할당(B/line)은 항상 비교하고, 처리량/지연은 기준값을 잰 머신과 같을 때만 비교한다.
+ * 의도한 변경이면 같은 머신에서 BENCH_UPDATE_BASELINE=1 npm run bench 로 기준값을 갱신한다.
+ *
+ * @format
+ */
+
+import {
+  Baseline,
+  confirmRegressions,
+  machineId,
+  runAll,
+} from './ingestBench';
+
+jest.mock('react-native-bluetooth-classic', () => ({}));
+jest.setTimeout(120000);
+
+const fs = require('fs');
+const path = require('path');
+const nodeProcess = require('process');
+
+// npm run bench는 frontend/에서 돈다
+const BASELINE_PATH = path.join(nodeProcess.cwd(), 'benchmarks/baseline.json');
+const RESULTS_PATH = path.join(nodeProcess.cwd(), 'benchmarks/results.json');
+
+test('ingest hot path stays within baseline', async () => {
+  const machine = machineId();
+  const results = await runAll();
+  const report: Baseline = { machine, results };
+  fs.writeFileSync(RESULTS_PATH, JSON.stringify(report, null, 2) + '\n');
+  console.table(results);
+
+  if (nodeProcess.env.BENCH_UPDATE_BASELINE) {
+    fs.writeFileSync(BASELINE_PATH, JSON.stringify(report, null, 2) + '\n');
+    return;
+  }
+
+  const baseline: Baseline = JSON.parse(
+    fs.readFileSync(BASELINE_PATH, 'utf8'),
+  );
+  const sameMachine = baseline.machine === machine;
+  if (!sameMachine) {
+    console.warn(
+      `Baseline was measured on "${baseline.machine}", comparing allocations only`,
+    );
+  }
+  expect(await confirmRegressions(results, baseline, sameMachine)).toEqual([]);
+});
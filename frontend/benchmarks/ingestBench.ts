@@ -0,0 +1,312 @@
+/**
+ * 수신 경로 마이크로벤치마크 시나리오. ingest.bench.ts(Jest)가 돌리고 baseline.json과 비교한다.
+ *
+ * - framer/*   LineFramer.pushString만 (조각남 × 종결자)
+ * - bridge/*   LoopbackTransport → ArduinoBridge 전체 수신 경로 (프레이머 + 디스패치 + 내부 리스너)
+ * - fanout/*   bridge 경로에 onSpeed 리스너 1/5/20개
+ *
+ * 각 시나리오는 처리량(lines/s), 줄당 할당 바이트, 청크 처리 시간 p99/최대(µs)를 낸다.
+ *
+ * @format
+ */
+
+import { ArduinoBridge } from '../services/arduinoBridge';
+import { monotonicNow } from '../services/ingestMetrics';
+import { LineFramer } from '../services/lineFramer';
+import { LoopbackTransport } from '../services/transport';
+
+export type BenchResult = {
+  linesPerSec: number;
+  /** linesPerSec / 같은 실행의 보정 루프 속도. 머신 부하/클럭 변화가 상쇄되어 이것으로 비교한다 */
+  relativeThroughput: number;
+  /** 줄당 힙 증가 바이트. gc를 쓸 수 없으면 null */
+  bytesPerLine: number | null;
+  /** 청크 하나 처리 시간 p99 (패스별 p99의 중앙값) */
+  p99ChunkUs: number;
+  /** 관측된 최악의 청크 처리 시간. 보고만 하고 비교하지 않는다 (GC 정지가 섞인다) */
+  maxChunkUs: number;
+};
+
+export const TERMINATORS: Record<string, string> = {
+  cr: '\r',
+  crlf: '\r\n',
+  'literal-backslash-r': '\\r',
+};
+
+// 한 청크 크기 (바이트)
+export const FRAGMENTATIONS: Record<string, number> = {
+  '1-byte': 1,
+  // RFCOMM 기본 프레임 크기
+  mtu: 127,
+  'many-lines': 4096,
+};
+
+const LINES_PER_PASS = 20000;
+const TIMED_PASSES = 15;
+// 청크 지연은 패스마다 p99를 내고 그 중앙값을 쓴다 (GC 한 번에 흔들리지 않게)
+const LATENCY_PASSES = 5;
+const ALLOCATION_BATCHES = 5;
+
+/** BPM:/SPD: 교대로, 실제 기기와 비슷한 값 범위 */
+export function makePayload(terminator: string, lines = LINES_PER_PASS) {
+  let text = '';
+  for (let i = 0; i < lines; i++) {
+    text +=
+      i % 2 === 0
+        ? `BPM:${60 + (i % 120)}${terminator}`
+        : `SPD:${((i % 200) / 10).toFixed(1)}${terminator}`;
+  }
+  return text;
+}
+
+export function chunkPayload(payload: string, chunkSize: number): string[] {
+  const chunks: string[] = [];
+  for (let i = 0; i < payload.length; i += chunkSize) {
+    chunks.push(payload.slice(i, i + chunkSize));
+  }
+  return chunks;
+}
+
+type Sink = (chunk: string) => void;
+
+type HeapProbe = { gc: () => void; used: () => number } | null;
+
+// Jest의 테스트 컨텍스트에는 gc가 없으므로 v8 플래그를 켜고 새 컨텍스트에서 꺼낸다
+function heapProbe(): HeapProbe {
+  try {
+    const v8 = require('v8');
+    const vm = require('vm');
+    v8.setFlagsFromString('--expose-gc');
+    const gc = vm.runInNewContext('gc') as () => void;
+    return { gc, used: () => v8.getHeapStatistics().used_heap_size };
+  } catch {
+    return null;
+  }
+}
+
+const probe = heapProbe();
+
+// 보정 루프: 바이트를 훑는 기준 작업의 속도 (bytes/s). 시나리오마다 직전에 다시 잰다
+const calibrationPayload = makePayload('\r\n');
+
+function calibrate(): number {
+  const payload = calibrationPayload;
+  let best = 0;
+  let checksum = 0;
+  for (let pass = 0; pass < TIMED_PASSES; pass++) {
+    const startedAt = monotonicNow();
+    for (let i = 0; i < payload.length; i++) {
+      checksum = (checksum * 31 + payload.charCodeAt(i)) | 0;
+    }
+    const elapsed = monotonicNow() - startedAt;
+    best = Math.max(best, payload.length / (elapsed / 1000));
+  }
+  if (checksum === 42) best += 1; // 루프가 제거되지 않게
+  return best;
+}
+
+function measure(push: Sink, chunks: string[], lines: number): BenchResult {
+  // 워밍업 (JIT)
+  chunks.forEach(push);
+  const calibrationRate = calibrate();
+
+  let best = 0;
+  for (let pass = 0; pass < TIMED_PASSES; pass++) {
+    const startedAt = monotonicNow();
+    for (let i = 0; i < chunks.length; i++) push(chunks[i]);
+    const elapsed = monotonicNow() - startedAt;
+    best = Math.max(best, lines / (elapsed / 1000));
+  }
+
+  const chunkUs = new Float64Array(chunks.length);
+  const p99s: number[] = [];
+  let maxUs = 0;
+  for (let pass = 0; pass < LATENCY_PASSES; pass++) {
+    for (let i = 0; i < chunks.length; i++) {
+      const startedAt = monotonicNow();
+      push(chunks[i]);
+      chunkUs[i] = (monotonicNow() - startedAt) * 1000;
+    }
+    chunkUs.sort();
+    p99s.push(chunkUs[Math.floor((chunkUs.length - 1) * 0.99)]);
+    maxUs = Math.max(maxUs, chunkUs[chunkUs.length - 1]);
+  }
+  p99s.sort((a, b) => a - b);
+
+  let bytesPerLine: number | null = null;
+  if (probe) {
+    // GC가 배치 중간에 돌면 증가량이 작게 잡히므로 여러 배치 중 최대를 쓴다
+    bytesPerLine = 0;
+    for (let batch = 0; batch < ALLOCATION_BATCHES; batch++) {
+      probe.gc();
+      const before = probe.used();
+      for (let i = 0; i < chunks.length; i++) push(chunks[i]);
+      const grown = probe.used() - before;
+      if (grown > 0) bytesPerLine = Math.max(bytesPerLine, grown / lines);
+    }
+  }
+
+  return {
+    linesPerSec: Math.round(best),
+    relativeThroughput: round2((best / calibrationRate) * 1000),
+    bytesPerLine:
+      bytesPerLine === null ? null : Math.round(bytesPerLine * 10) / 10,
+    p99ChunkUs: round2(p99s[Math.floor(p99s.length / 2)]),
+    maxChunkUs: round2(maxUs),
+  };
+}
+
+function round2(value: number) {
+  return Math.round(value * 100) / 100;
+}
+
+export function runFramer(terminator: string, chunkSize: number) {
+  let lines = 0;
+  const framer = new LineFramer(() => {
+    lines++;
+  });
+  const payload = makePayload(terminator);
+  return measure(
+    chunk => framer.pushString(chunk),
+    chunkPayload(payload, chunkSize),
+    LINES_PER_PASS,
+  );
+}
+
+export async function runBridge(
+  terminator: string,
+  chunkSize: number,
+  speedListeners = 0,
+) {
+  const transport = new LoopbackTransport();
+  const bridge = new ArduinoBridge({ transport });
+  for (let i = 0; i < speedListeners; i++) {
+    bridge.onSpeed(speed => {
+      if (speed < 0) throw new Error('negative speed');
+    });
+  }
+  await bridge.connect('bench');
+  try {
+    const payload = makePayload(terminator);
+    return measure(
+      chunk => transport.emit(chunk),
+      chunkPayload(payload, chunkSize),
+      LINES_PER_PASS,
+    );
+  } finally {
+    await bridge.disconnect();
+  }
+}
+
+export const FAN_OUT_LISTENERS = [1, 5, 20];
+
+/** 모든 시나리오. 키는 baseline.json의 키와 같다 */
+export function scenarios(): Record<string, () => Promise<BenchResult>> {
+  const all: Record<string, () => Promise<BenchResult>> = {};
+  Object.entries(FRAGMENTATIONS).forEach(([fragName, chunkSize]) => {
+    Object.entries(TERMINATORS).forEach(([termName, terminator]) => {
+      all[`framer/${fragName}/${termName}`] = async () =>
+        runFramer(terminator, chunkSize);
+    });
+    all[`bridge/${fragName}/crlf`] = () =>
+      runBridge(TERMINATORS.crlf, chunkSize);
+  });
+  FAN_OUT_LISTENERS.forEach(listeners => {
+    all[`fanout/${listeners}`] = () =>
+      runBridge(TERMINATORS.crlf, FRAGMENTATIONS['many-lines'], listeners);
+  });
+  return all;
+}
+
+export async function runAll(): Promise<Record<string, BenchResult>> {
+  const results: Record<string, BenchResult> = {};
+  for (const [name, run] of Object.entries(scenarios())) {
+    results[name] = await run();
+  }
+  return results;
+}
+
+export type Baseline = {
+  /** 기준값을 잰 머신. 다르면 시간 지표는 비교하지 않는다 */
+  machine: string;
+  results: Record<string, BenchResult>;
+};
+
+// 회귀 판정 여유. 시간 지표는 잡음이 크므로 넉넉하게, 할당은 머신과 무관하므로 빡빡하게
+const THROUGHPUT_DROP = 0.4;
+const LATENCY_FACTOR = 3;
+const LATENCY_SLACK_US = 5;
+const ALLOCATION_FACTOR = 1.25;
+const ALLOCATION_SLACK_BYTES = 16;
+
+export function machineId(): string {
+  const os = require('os');
+  const nodeProcess = require('process');
+  const cpus = os.cpus();
+  const cpu = `${cpus[0]?.model ?? 'unknown'} x${cpus.length}`;
+  return `${cpu} ${nodeProcess.platform} node ${nodeProcess.version}`;
+}
+
+/** 기준값보다 나빠진 항목 목록 (비어 있으면 통과). 항목은 "<시나리오>: <설명>" */
+export function findRegressions(
+  results: Record<string, BenchResult>,
+  baseline: Baseline,
+  sameMachine: boolean,
+): string[] {
+  const regressions: string[] = [];
+  Object.entries(baseline.results).forEach(([name, base]) => {
+    const current = results[name];
+    if (!current) {
+      regressions.push(`${name}: scenario missing`);
+      return;
+    }
+    if (base.bytesPerLine !== null && current.bytesPerLine !== null) {
+      const limit = Math.max(
+        base.bytesPerLine * ALLOCATION_FACTOR,
+        base.bytesPerLine + ALLOCATION_SLACK_BYTES,
+      );
+      if (current.bytesPerLine > limit) {
+        regressions.push(
+          `${name}: ${current.bytesPerLine} B/line allocated (baseline ${base.bytesPerLine})`,
+        );
+      }
+    }
+    if (!sameMachine) return;
+    if (
+      current.relativeThroughput <
+      base.relativeThroughput * (1 - THROUGHPUT_DROP)
+    ) {
+      regressions.push(
+        `${name}: relative throughput ${current.relativeThroughput} (baseline ${base.relativeThroughput}, ${current.linesPerSec} lines/s)`,
+      );
+    }
+    const latencyLimit = base.p99ChunkUs * LATENCY_FACTOR + LATENCY_SLACK_US;
+    if (current.p99ChunkUs > latencyLimit) {
+      regressions.push(
+        `${name}: p99 ${current.p99ChunkUs} µs per chunk (baseline ${base.p99ChunkUs})`,
+      );
+    }
+  });
+  return regressions;
+}
+
+// 시간 지표는 한 번 튄 것만으로 실패시키지 않는다: 걸린 시나리오만 다시 재서 계속 나쁠 때만 남긴다
+const CONFIRM_RUNS = 2;
+
+export async function confirmRegressions(
+  results: Record<string, BenchResult>,
+  baseline: Baseline,
+  sameMachine: boolean,
+): Promise<string[]> {
+  const all = scenarios();
+  const current = { ...results };
+  let regressions = findRegressions(current, baseline, sameMachine);
+  for (let run = 0; run < CONFIRM_RUNS && regressions.length > 0; run++) {
+    const suspects = new Set(regressions.map(r => r.split(':')[0]));
+    for (const name of suspects) {
+      if (all[name]) current[name] = await all[name]();
+    }
+    regressions = findRegressions(current, baseline, sameMachine);
+  }
+  return regressions;
+}
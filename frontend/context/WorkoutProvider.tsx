@@ -4,18 +4,32 @@ import React, {
   useCallback,
   useContext,
   useEffect,
+  useLayoutEffect,
   useMemo,
   useRef,
   useState,
 } from "react";
 import { Alert } from "react-native";
+import { Buffer } from "buffer";
 
 import {
   ArduinoBridge,
   ArduinoConnectionState,
   BodyInfo,
+  SessionDiagnostics,
+  StrapState,
   WorkoutPurposeKey,
 } from "../services/arduinoBridge";
+import { CommandCancelledError } from "../services/commandQueue";
+import { EcgRingBuffer } from "../services/ecgBuffer";
+import { HeartRateSensorInfo } from "../services/heartRateStrap";
+import { ProgramStatus, createHiitProgram } from "../services/intervalProgram";
+import { createLogger } from "../services/logger";
+import {
+  HeartRateBand,
+  SpeedControlStatus,
+} from "../services/speedController";
+import { Transport } from "../services/transport";
 
 type UserProfile = BodyInfo & {
   weight?: number;
@@ -29,22 +43,57 @@ type WorkoutContextValue = {
   purpose: WorkoutPurposeKey | null;
   setPurpose: (purpose: WorkoutPurposeKey | null) => void;
   targetHr: number | null;
+  // 목적의 강도 구간 (자동 속도 제어 목표)
+  targetBand: HeartRateBand | null;
   heartRate: number | null;
+  // 값이 예상 주기 안에 갱신되지 않음 (마지막 값을 그대로 믿으면 안 됨)
+  heartRateStale: boolean;
   ecgHistory: number[];
+  // 원시 ECG 파형 링 버퍼 (state 아님, 항상 같은 객체)
+  ecgWaveform: EcgRingBuffer;
   speed: number;
+  speedStale: boolean;
   connectionState: ArduinoConnectionState;
   connectToDevice: (id: string) => Promise<void>;
   disconnect: () => Promise<void>;
+  // BLE 심박 벨트 (러닝머신 연결과 별개). 연결되면 heartRate는 벨트 값을 따른다
+  strapState: StrapState;
+  scanHeartRateStraps: (
+    onFound: (sensor: HeartRateSensorInfo) => void
+  ) => Promise<void>;
+  connectHeartRateStrap: (id: string) => Promise<void>;
+  disconnectHeartRateStrap: () => Promise<void>;
   sendTargetHr: () => Promise<void>;
   emergencyStop: () => Promise<void>;
   setSpeed: (speed: number) => Promise<void>;
   adjustSpeed: (delta: number) => Promise<void>;
+  // 심박이 목표 구간에 머물도록 속도 자동 조절. 수동 속도 변경/비상 정지로 꺼진다
+  speedControl: SpeedControlStatus;
+  startSpeedControl: () => void;
+  stopSpeedControl: () => void;
+  // 인터벌 프로그램 (HIIT). 구간 전환은 명령 지연만큼 미리 보내서 경계에 맞춘다
+  program: ProgramStatus;
+  startProgram: () => void;
+  stopProgram: () => void;
+  // 디버그 오버레이/세션 내보내기용 (호출할 때마다 새 스냅샷)
+  getDiagnostics: () => SessionDiagnostics;
+  // 원시 수신 캡처 (ReplayTransport로 재생). stopCapture는 캡처 파일을 base64로 돌려준다
+  startCapture: () => void;
+  stopCapture: () => string | null;
 };
 
 const WorkoutContext = createContext<WorkoutContextValue | undefined>(
   undefined
 );
 
+const log = createLogger("WorkoutProvider");
+// 샘플마다 호출되는 리스너용 (debug 레벨, 10번에 한 번)
+const sampleLog = createLogger("WorkoutProvider:samples", {
+  sampleEvery: 10,
+});
+
+const CLOCK_SYNC_INTERVAL_MS = 5000;
+
 const DEFAULT_PROFILE: UserProfile = {
   age: 25,
   restingHr: 60,
@@ -53,28 +102,68 @@ const DEFAULT_PROFILE: UserProfile = {
   level: "Beginner",
 };
 
-export function WorkoutProvider({ children }: { children: React.ReactNode }) {
-  const bridgeRef = useRef(new ArduinoBridge());
+export function WorkoutProvider({
+  children,
+  transport,
+}: {
+  children: React.ReactNode;
+  // 기기 대신 쓸 링크 (테스트, 캡처 재생, 시뮬레이터)
+  transport?: Transport;
+}) {
+  // 안드로이드에서는 네이티브 인제스트 모듈이 소켓 읽기/파싱을 맡는다 (없으면 JS 경로)
+  // 기기가 @<ms> 타임스탬프를 붙이면 PING/PONG으로 시계를 맞춰 샘플 시각을 앱 시계로 옮긴다
+  // commandAcks는 끈다 (기기 펌웨어가 ACK:<seq>를 보낸다는 보장이 없다). 그래서 인터벌
+  // 프로그램의 선행 시간(lead)은 송신 큐 대기 + write까지만 덮고 기기 처리 시간은 빠진다
+  // 초기화 함수로 넘겨서 첫 렌더에만 만든다 (렌더마다 브리지 전체를 만들고 버리지 않도록)
+  const [bridge] = useState(
+    () =>
+      new ArduinoBridge({
+        nativeIngest: true,
+        clockSyncIntervalMs: CLOCK_SYNC_INTERVAL_MS,
+        transport,
+      })
+  );
+  const bridgeRef = useRef(bridge);
 
   const [profile, setProfile] = useState<UserProfile>(DEFAULT_PROFILE);
   const [purpose, setPurpose] = useState<WorkoutPurposeKey | null>(null);
   const [connectionState, setConnectionState] =
     useState<ArduinoConnectionState>("disconnected");
+  const [strapState, setStrapState] = useState<StrapState>("disconnected");
+  const [speedControl, setSpeedControl] = useState<SpeedControlStatus>(() =>
+    bridgeRef.current.getSpeedControlStatus()
+  );
+  const [program, setProgram] = useState<ProgramStatus>(() =>
+    bridgeRef.current.getProgramStatus()
+  );
 
   const [heartRate, setHeartRate] = useState<number | null>(null);
   const [speed, setSpeedState] = useState(0);
+  const [heartRateStale, setHeartRateStale] = useState(false);
+  const [speedStale, setSpeedStale] = useState(false);
   const [ecgHistory, setEcgHistory] = useState<number[]>([]);
+  // 마지막으로 요청한 속도. 빠르게 연타하면 렌더 전이라 speed state가 아직 이전 값이다
+  const requestedSpeedRef = useRef(0);
+  // 아직 커밋되지 않은 샘플 중 가장 먼저 도착한 것의 도착 시각 (0이면 없음)
+  const pendingArrivalRef = useRef(0);
 
   // ==========================================
-  // 🔥 스트림 구독 (ECG / SPD)
+  // 🔥 스트림 구독 (ECG / SPD / 연결 상태 / stale)
   // ==========================================
   useEffect(() => {
-    console.log("[WorkoutProvider] Setting up listeners");
+    log.info("Setting up listeners");
+
+    const markArrival = () => {
+      if (pendingArrivalRef.current === 0) {
+        pendingArrivalRef.current = bridgeRef.current.getSampleArrivalTime();
+      }
+    };
 
     const unsubscribeEcg = bridgeRef.current.onEcgSample((bpmRaw) => {
       const bpm = Number(bpmRaw) || 0;
 
-      console.log("[WorkoutProvider] Received BPM:", bpm);
+      sampleLog.debug(() => `Received BPM: ${bpm}`);
+      markArrival();
 
       setHeartRate(bpm);
       setEcgHistory((prev) => [...prev.slice(-39), bpm]); // 그래프용 최근 40개 유지
@@ -83,17 +172,62 @@ export function WorkoutProvider({ children }: { children: React.ReactNode }) {
     const unsubscribeSpeed = bridgeRef.current.onSpeed((spdRaw) => {
       const spd = Number(spdRaw) || 0;
 
-      console.log("[WorkoutProvider] Received Speed:", spd);
+      sampleLog.debug(() => `Received Speed: ${spd}`);
+      markArrival();
+      // 요청 속도(requestedSpeedRef)는 건드리지 않는다: 가속 중인 벨트 속도로 덮으면 연타한 +가 목표를 낮춘다
       setSpeedState(spd);
     });
 
+    // 링크 끊김/자동 재연결로 바뀌는 상태도 반영
+    const unsubscribeState = bridgeRef.current.onConnectionStateChange(
+      (state) => {
+        log.info("Connection state:", state);
+        setConnectionState(state);
+      }
+    );
+
+    const unsubscribeStrap = bridgeRef.current.onStrapStateChange((state) => {
+      log.info("Heart rate sensor state:", state);
+      setStrapState(state);
+    });
+
+    // 제어 루프는 브리지 타이머에서 돈다. 여기서는 표시용 상태만 받는다
+    const unsubscribeSpeedControl = bridgeRef.current.onSpeedControlChange(
+      (status) => setSpeedControl(status)
+    );
+
+    const unsubscribeProgram = bridgeRef.current.onProgramChange((status) =>
+      setProgram(status)
+    );
+
+    // 도착 간격 감시: 멈춘 스트림은 stale로 표시
+    const unsubscribeStale = bridgeRef.current.onStaleChange(
+      (stream, stale) => {
+        if (stream === "heartRate") setHeartRateStale(stale);
+        else setSpeedStale(stale);
+      }
+    );
+
     return () => {
       unsubscribeEcg();
       unsubscribeSpeed();
+      unsubscribeState();
+      unsubscribeStrap();
+      unsubscribeSpeedControl();
+      unsubscribeProgram();
+      unsubscribeStale();
       bridgeRef.current.teardownStreams();
     };
   }, []);
 
+  // 청크 도착 → 커밋 지연. 레이아웃 이펙트는 커밋 직후(페인트 전)에 실행된다
+  useLayoutEffect(() => {
+    if (pendingArrivalRef.current > 0) {
+      bridgeRef.current.recordCommit(pendingArrivalRef.current);
+      pendingArrivalRef.current = 0;
+    }
+  }, [heartRate, speed]);
+
   // ==========================================
   //  목표 심박 계산 (Karvonen)
   // ==========================================
@@ -102,12 +236,32 @@ export function WorkoutProvider({ children }: { children: React.ReactNode }) {
     return ArduinoBridge.computeTargetHr(profile, purpose);
   }, [profile, purpose]);
 
+  const targetBand = useMemo(() => {
+    if (!purpose || !profile.age || !profile.restingHr) return null;
+    return ArduinoBridge.computeTargetHrBand(profile, purpose);
+  }, [profile, purpose]);
+
+  // 제어 중에 프로필/목적이 바뀌면 구간만 바꾼다
+  useEffect(() => {
+    if (targetBand && bridgeRef.current.getSpeedControlStatus().mode !== "off") {
+      bridgeRef.current.startSpeedControl(targetBand);
+    }
+  }, [targetBand]);
+
+  // 심박 응답 모델은 앱이 떠 있는 동안 프로필별로 기억한다. 프로필에 id가 없으므로 신체 정보를 키로 쓴다
+  const { age, gender, weight, restingHr } = profile;
+  useEffect(() => {
+    bridgeRef.current.setResponseModelProfile(
+      [gender, age, weight, restingHr].join("/")
+    );
+  }, [age, gender, weight, restingHr]);
+
   // ==========================================
   // 디바이스 연결
   // ==========================================
   const connectToDevice = useCallback(async (deviceId: string) => {
     setConnectionState("connecting");
-    console.log("[WorkoutProvider] Connecting to:", deviceId);
+    log.info("Connecting to:", deviceId);
 
     try {
       await bridgeRef.current.connect(deviceId);
@@ -116,11 +270,14 @@ export function WorkoutProvider({ children }: { children: React.ReactNode }) {
       // 연결되면 데이터 초기화
       setEcgHistory([]);
       setHeartRate(null);
+      setHeartRateStale(false);
+      setSpeedStale(false);
+      requestedSpeedRef.current = 0;
       setSpeedState(0);
 
-      console.log("[WorkoutProvider] Connected!");
+      log.info("Connected!");
     } catch (e) {
-      console.error("[WorkoutProvider] Connection failed:", e);
+      log.error("Connection failed:", e);
       setConnectionState("disconnected");
       throw e;
     }
@@ -135,16 +292,38 @@ export function WorkoutProvider({ children }: { children: React.ReactNode }) {
     } finally {
       setConnectionState("disconnected");
       setHeartRate(null);
+      setHeartRateStale(false);
+      setSpeedStale(false);
+      requestedSpeedRef.current = 0;
       setSpeedState(0);
       setEcgHistory([]);
     }
   }, []);
 
+  // ==========================================
+  // 심박 벨트 (BLE)
+  // ==========================================
+  const scanHeartRateStraps = useCallback(
+    (onFound: (sensor: HeartRateSensorInfo) => void) =>
+      bridgeRef.current.scanHeartRateStraps(onFound),
+    []
+  );
+
+  const connectHeartRateStrap = useCallback(
+    (sensorId: string) => bridgeRef.current.connectHeartRateStrap(sensorId),
+    []
+  );
+
+  const disconnectHeartRateStrap = useCallback(
+    () => bridgeRef.current.disconnectHeartRateStrap(),
+    []
+  );
+
   // ==========================================
   // 🔥 목표 심박 전송
   // ==========================================
   const sendTargetHr = useCallback(async () => {
-    console.log("[WorkoutProvider] Sending target HR:", targetHr);
+    log.info("Sending target HR:", targetHr);
 
     if (!targetHr) {
       Alert.alert("입력 필요", "프로필 및 운동 목적을 먼저 설정하세요.");
@@ -160,7 +339,7 @@ export function WorkoutProvider({ children }: { children: React.ReactNode }) {
       await bridgeRef.current.sendTargetHeartRate(targetHr);
       Alert.alert("전송 완료", `${targetHr} bpm 전송됨`);
     } catch (e) {
-      console.error(e);
+      log.error("Send target HR failed:", e);
       Alert.alert("전송 실패", String(e));
     }
   }, [targetHr, connectionState]);
@@ -169,12 +348,21 @@ export function WorkoutProvider({ children }: { children: React.ReactNode }) {
   // 🔥 비상 정지
   // ==========================================
   const emergencyStop = useCallback(async () => {
+    // 전달 여부와 무관하게 요청 속도는 바로 0 (이후 +/- 조절이 이전 속도에서 이어지지 않도록)
+    requestedSpeedRef.current = 0;
+    setSpeedState(0);
+    if (bridgeRef.current.getState() === "reconnecting") {
+      Alert.alert("정지 대기", "연결이 복구되는 즉시 정지 명령을 보냅니다.");
+    }
     try {
+      // 연타해도 모든 호출이 마지막 STOP의 결과로 끝난다
       await bridgeRef.current.sendEmergencyStop();
-      setSpeedState(0);
       Alert.alert("정지 완료", "트레드밀이 정지되었습니다.");
     } catch (e) {
-      Alert.alert("오류", String(e));
+      Alert.alert(
+        "정지 실패",
+        `정지 명령을 전달하지 못했습니다. 기기의 정지 버튼을 누르세요.\n${String(e)}`
+      );
     }
   }, []);
 
@@ -189,11 +377,15 @@ export function WorkoutProvider({ children }: { children: React.ReactNode }) {
 
       const safe = Math.max(0, Number(spd.toFixed(1)));
 
+      requestedSpeedRef.current = safe;
       setSpeedState(safe);
 
       try {
+        // 아직 전송되지 않은 이전 S: 명령은 송신 큐에서 이 값으로 덮어쓴다
         await bridgeRef.current.setSpeed(safe);
       } catch (e) {
+        // 비상 정지가 대기 중인 속도 명령을 취소한 경우
+        if (e instanceof CommandCancelledError) return;
         Alert.alert("속도 오류", String(e));
       }
     },
@@ -202,11 +394,69 @@ export function WorkoutProvider({ children }: { children: React.ReactNode }) {
 
   const adjustSpeed = useCallback(
     async (delta: number) => {
-      await setSpeed(speed + delta);
+      await setSpeed(requestedSpeedRef.current + delta);
     },
-    [speed, setSpeed]
+    [setSpeed]
   );
 
+  // ==========================================
+  // 자동 속도 제어 (심박 추종)
+  // ==========================================
+  const startSpeedControl = useCallback(() => {
+    if (!targetBand) {
+      Alert.alert("입력 필요", "프로필 및 운동 목적을 먼저 설정하세요.");
+      return;
+    }
+    if (connectionState !== "connected") {
+      Alert.alert("연결 필요", "먼저 기기에 연결해주세요.");
+      return;
+    }
+    bridgeRef.current.startSpeedControl(targetBand);
+  }, [targetBand, connectionState]);
+
+  const stopSpeedControl = useCallback(
+    () => bridgeRef.current.stopSpeedControl(),
+    []
+  );
+
+  // ==========================================
+  // 인터벌 프로그램
+  // ==========================================
+  const startProgram = useCallback(() => {
+    if (!profile.age || !profile.restingHr) {
+      Alert.alert("입력 필요", "프로필을 먼저 설정하세요.");
+      return;
+    }
+    if (connectionState !== "connected") {
+      Alert.alert("연결 필요", "먼저 기기에 연결해주세요.");
+      return;
+    }
+    // 워밍업은 지방 연소 구간으로 천천히 올린다
+    const warmupBand = ArduinoBridge.computeTargetHrBand(profile, "fatBurn");
+    try {
+      bridgeRef.current.startProgram(
+        createHiitProgram(warmupBand, profile.level)
+      );
+    } catch (e) {
+      log.error("Start program failed:", e);
+      Alert.alert("프로그램 오류", String(e));
+    }
+  }, [profile, connectionState]);
+
+  const stopProgram = useCallback(() => bridgeRef.current.stopProgram(), []);
+
+  const getDiagnostics = useCallback(
+    () => bridgeRef.current.exportDiagnostics(),
+    []
+  );
+
+  const startCapture = useCallback(() => bridgeRef.current.startCapture(), []);
+
+  const stopCapture = useCallback(() => {
+    const capture = bridgeRef.current.stopCapture();
+    return capture ? Buffer.from(capture).toString("base64") : null;
+  }, []);
+
   // ==========================================
   // Provider value
   // ==========================================
@@ -217,31 +467,64 @@ export function WorkoutProvider({ children }: { children: React.ReactNode }) {
       purpose,
       setPurpose,
       targetHr,
+      targetBand,
       heartRate,
+      heartRateStale,
       ecgHistory,
+      ecgWaveform: bridgeRef.current.getEcgWaveform(),
       speed,
+      speedStale,
       connectionState,
       connectToDevice,
       disconnect,
+      strapState,
+      scanHeartRateStraps,
+      connectHeartRateStrap,
+      disconnectHeartRateStrap,
       sendTargetHr,
       emergencyStop,
       setSpeed,
       adjustSpeed,
+      speedControl,
+      startSpeedControl,
+      stopSpeedControl,
+      program,
+      startProgram,
+      stopProgram,
+      getDiagnostics,
+      startCapture,
+      stopCapture,
     }),
     [
       profile,
       purpose,
       targetHr,
+      targetBand,
       heartRate,
+      heartRateStale,
       ecgHistory,
       speed,
+      speedStale,
       connectionState,
       connectToDevice,
       disconnect,
+      strapState,
+      scanHeartRateStraps,
+      connectHeartRateStrap,
+      disconnectHeartRateStrap,
       sendTargetHr,
       emergencyStop,
       setSpeed,
       adjustSpeed,
+      speedControl,
+      startSpeedControl,
+      stopSpeedControl,
+      program,
+      startProgram,
+      stopProgram,
+      getDiagnostics,
+      startCapture,
+      stopCapture,
     ]
   );
 
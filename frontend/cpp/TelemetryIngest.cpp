@@ -0,0 +1,519 @@
+// cpp/TelemetryIngest.cpp
+
+#include "TelemetryIngest.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace zxis {
+
+namespace {
+
+constexpr uint8_t kCR = 0x0d;
+constexpr uint8_t kLF = 0x0a;
+constexpr uint8_t kBackslash = 0x5c;
+constexpr uint8_t kLowerR = 0x72;
+constexpr uint8_t kColon = 0x3a;
+constexpr uint8_t kAt = 0x40;
+constexpr double kNoDeviceTime = std::numeric_limits<double>::quiet_NaN();
+constexpr size_t kMaxPrefixBytes = 4;
+
+enum class FieldType : uint8_t { U8, U16, I16 };
+
+struct TextChannel {
+  const char* name;
+  Channel channel;
+  bool isFloat;
+};
+
+// telemetryChannels.ts의 TELEMETRY_CHANNELS 중 숫자 채널. STS: 같은 텍스트 채널은 JS로 넘긴다.
+constexpr TextChannel kTextChannels[] = {
+    {"BPM", Channel::Bpm, false},
+    {"SPD", Channel::Speed, true},
+    {"N", Channel::TargetEcho, false},
+    {"RR", Channel::Rr, false},
+    {"INC", Channel::Incline, true},
+    {"DST", Channel::Distance, true},
+    {"BIN", Channel::Protocol, false},
+    {"ECG", Channel::Ecg, false},
+};
+
+// 오버플로우 재동기화용 프레임 시작 접두사 (ACK: 같은 텍스트 줄은 JS로 넘긴다)
+constexpr const char* kFrameStarts[] = {
+    "BPM:", "SPD:", "N:", "RR:", "INC:", "DST:", "STS:", "BIN:", "ECG:",
+    "EHZ:", "ACK:", "PONG:"};
+// 가장 긴 접두사 길이 - 1
+constexpr size_t kKeepTail = 4;
+
+struct BinaryChannel {
+  Channel channel;
+  FieldType field;
+  double divisor;
+};
+
+// binaryProtocol.ts의 BINARY_CHANNELS (인덱스 = 채널 id, divisor 0 = 사용 안 함)
+constexpr BinaryChannel kBinaryChannels[] = {
+    {Channel::Bpm, FieldType::U8, 0},
+    {Channel::Bpm, FieldType::U8, 1},
+    {Channel::Speed, FieldType::U16, 100},
+    {Channel::TargetEcho, FieldType::U8, 1},
+    {Channel::Rr, FieldType::U16, 1},
+    {Channel::Incline, FieldType::I16, 10},
+    {Channel::Distance, FieldType::U16, 100},
+    {Channel::Protocol, FieldType::U8, 0},
+    {Channel::Ecg, FieldType::I16, 1},
+};
+constexpr size_t kBinaryChannelCount =
+    sizeof(kBinaryChannels) / sizeof(kBinaryChannels[0]);
+
+size_t fieldWidth(FieldType field) {
+  return field == FieldType::U8 ? 1 : 2;
+}
+
+constexpr uint32_t packName(const char* name) {
+  uint32_t key = 0;
+  for (size_t i = 0; name[i] != '\0'; i++) {
+    key = key * 256 + static_cast<uint8_t>(name[i]);
+  }
+  return key;
+}
+
+const TextChannel* findTextChannel(uint32_t packed) {
+  for (const auto& entry : kTextChannels) {
+    if (packName(entry.name) == packed) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+// CRC-8 (poly 0x07, init 0x00)
+struct Crc8Table {
+  uint8_t values[256];
+  constexpr Crc8Table() : values() {
+    for (int i = 0; i < 256; i++) {
+      uint8_t crc = static_cast<uint8_t>(i);
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07)
+                           : static_cast<uint8_t>(crc << 1);
+      }
+      values[i] = crc;
+    }
+  }
+};
+constexpr Crc8Table kCrc8;
+
+uint8_t crc8(const uint8_t* bytes, size_t length) {
+  uint8_t crc = 0;
+  for (size_t i = 0; i < length; i++) {
+    crc = kCrc8.values[crc ^ bytes[i]];
+  }
+  return crc;
+}
+
+bool isBlank(uint8_t b) {
+  return b == ' ' || b == '\t';
+}
+
+bool isDigit(uint8_t b) {
+  return b >= '0' && b <= '9';
+}
+
+size_t roundUpPow2(size_t n) {
+  size_t size = 1;
+  while (size < n) {
+    size <<= 1;
+  }
+  return size;
+}
+
+} // namespace
+
+TelemetryIngest::TelemetryIngest(size_t lineCapacity)
+    : ring_(roundUpPow2(std::max<size_t>(2, lineCapacity))),
+      mask_(ring_.size() - 1) {
+  pending_.reserve(256);
+}
+
+void TelemetryIngest::push(
+    const uint8_t* data,
+    size_t length,
+    double timestampMs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.bytes += length;
+  stats_.chunks++;
+  for (size_t i = 0; i < length; i++) {
+    pushByte(data[i], timestampMs);
+  }
+}
+
+void TelemetryIngest::drain(
+    std::vector<Sample>& samples,
+    std::vector<std::string>& textLines) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  samples.clear();
+  textLines.clear();
+  samples.swap(pending_);
+  textLines.swap(pendingText_);
+}
+
+IngestStats TelemetryIngest::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void TelemetryIngest::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tail_ = head_;
+  pendingBackslash_ = false;
+  resynced_ = false;
+  binaryFrames_ = false;
+  negotiating_ = false;
+  filled_ = 0;
+  expected_ = 0;
+  lastSeq_ = -1;
+  pending_.clear();
+  pendingText_.clear();
+  stats_ = IngestStats{};
+}
+
+void TelemetryIngest::setNegotiating(bool negotiating) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  negotiating_ = negotiating;
+}
+
+void TelemetryIngest::pushByte(uint8_t b, double timestampMs) {
+  if (filled_ == 0) {
+    if (b == kFrameSync && binaryFrames_) {
+      frame_[0] = b;
+      filled_ = 1;
+    } else {
+      pushTextByte(b, timestampMs);
+    }
+    return;
+  }
+
+  frame_[filled_++] = b;
+
+  if (filled_ == kFrameHeader) {
+    const uint8_t id = frame_[1];
+    const uint8_t count = frame_[3];
+    if (id >= kBinaryChannelCount || kBinaryChannels[id].divisor == 0 ||
+        count == 0 || count > kMaxSamplesPerFrame) {
+      resyncFrame(timestampMs);
+      return;
+    }
+    expected_ =
+        kFrameHeader + count * fieldWidth(kBinaryChannels[id].field) + 1;
+    return;
+  }
+
+  if (filled_ > kFrameHeader && filled_ == expected_) {
+    const size_t crcAt = expected_ - 1;
+    if (crc8(&frame_[1], crcAt - 1) != frame_[crcAt]) {
+      stats_.crcErrors++;
+      resyncFrame(timestampMs);
+      return;
+    }
+    deliverFrame(timestampMs);
+  }
+}
+
+void TelemetryIngest::deliverFrame(double timestampMs) {
+  const BinaryChannel& spec = kBinaryChannels[frame_[1]];
+  const int seq = frame_[2];
+  const size_t count = frame_[3];
+
+  if (lastSeq_ >= 0) {
+    stats_.seqGaps += static_cast<uint8_t>(seq - lastSeq_ - 1);
+  }
+  lastSeq_ = seq;
+  stats_.frames++;
+
+  filled_ = 0;
+  expected_ = 0;
+
+  const size_t width = fieldWidth(spec.field);
+  size_t pos = kFrameHeader;
+  for (size_t i = 0; i < count; i++) {
+    int32_t raw = frame_[pos];
+    if (width == 2) {
+      raw |= frame_[pos + 1] << 8;
+      if (spec.field == FieldType::I16 && (raw & 0x8000)) {
+        raw -= 0x10000;
+      }
+    }
+    pos += width;
+    enqueue(spec.channel, raw / spec.divisor, timestampMs, kNoDeviceTime);
+  }
+}
+
+void TelemetryIngest::resyncFrame(double timestampMs) {
+  const size_t pending = filled_;
+  filled_ = 0;
+  expected_ = 0;
+
+  size_t next = 1;
+  while (next < pending && frame_[next] != kFrameSync) {
+    next++;
+  }
+  stats_.droppedBytes += next;
+  if (next >= pending) {
+    return;
+  }
+
+  std::array<uint8_t, kMaxFrameBytes> replay;
+  const size_t replayLength = pending - next;
+  std::copy_n(frame_.begin() + next, replayLength, replay.begin());
+  for (size_t i = 0; i < replayLength; i++) {
+    pushByte(replay[i], timestampMs);
+  }
+}
+
+void TelemetryIngest::pushTextByte(uint8_t b, double timestampMs) {
+  if (b == kCR || b == kLF) {
+    emitLine(head_, timestampMs);
+    return;
+  }
+
+  if (pendingBackslash_ && b == kLowerR) {
+    emitLine(head_ - 1, timestampMs);
+    return;
+  }
+  pendingBackslash_ = b == kBackslash;
+
+  if (head_ - tail_ >= ring_.size()) {
+    resyncLine();
+  }
+  ring_[head_ & mask_] = b;
+  head_++;
+}
+
+void TelemetryIngest::emitLine(uint64_t lineEnd, double timestampMs) {
+  if (resynced_) {
+    // 재동기화 뒤 첫 줄은 종결자가 빠진 프레임이 붙어 있을 수 있으므로 프레임 시작마다 나눈다
+    uint64_t segment = tail_;
+    for (uint64_t pos = tail_ + 1; pos < lineEnd; pos++) {
+      if (isCompleteFrameStartAt(pos, lineEnd)) {
+        emitRange(segment, pos, timestampMs);
+        segment = pos;
+      }
+    }
+    emitRange(segment, lineEnd, timestampMs);
+  } else {
+    emitRange(tail_, lineEnd, timestampMs);
+  }
+
+  tail_ = head_;
+  pendingBackslash_ = false;
+  resynced_ = false;
+}
+
+void TelemetryIngest::emitRange(
+    uint64_t begin,
+    uint64_t end,
+    double timestampMs) {
+  while (begin < end && isBlank(ringAt(begin))) {
+    begin++;
+  }
+  while (end > begin && isBlank(ringAt(end - 1))) {
+    end--;
+  }
+
+  if (end > begin) {
+    stats_.lines++;
+    decodeLine(begin, end, timestampMs);
+  }
+}
+
+void TelemetryIngest::decodeLine(
+    uint64_t begin,
+    uint64_t end,
+    double timestampMs) {
+  uint32_t packed = 0;
+  uint64_t colon = 0;
+  bool found = false;
+  const uint64_t limit = std::min<uint64_t>(end, begin + kMaxPrefixBytes + 1);
+  for (uint64_t pos = begin; pos < limit; pos++) {
+    const uint8_t b = ringAt(pos);
+    if (b == kColon) {
+      colon = pos;
+      found = true;
+      break;
+    }
+    // 앞의 NUL은 자릿수를 바꾸지 않아 짧은 접두사와 같은 키가 된다
+    if (b == 0) break;
+    packed = packed * 256 + b;
+  }
+
+  const TextChannel* channel =
+      found && colon > begin ? findTextChannel(packed) : nullptr;
+  if (channel == nullptr) {
+    // 텍스트 채널/알 수 없는 줄은 JS 쪽 디스패처가 처리
+    if (pendingText_.size() >= kMaxPendingText) {
+      stats_.textDrops++;
+    } else {
+      std::string line;
+      line.reserve(end - begin);
+      for (uint64_t pos = begin; pos < end; pos++) {
+        // JSI에는 ASCII 문자열로 넘기므로 깨진 바이트는 치환
+        const uint8_t b = ringAt(pos);
+        line.push_back(b < 0x80 ? static_cast<char>(b) : '?');
+      }
+      // 샘플과 같은 순서로 JS에 넘기도록 큐에는 줄 번호와 도착 시각만 넣는다
+      enqueue(
+          Channel::Text,
+          static_cast<double>(pendingText_.size()),
+          timestampMs,
+          kNoDeviceTime);
+      pendingText_.push_back(std::move(line));
+    }
+    return;
+  }
+
+  // LineView.parseIntAt / parseFloatAt와 같은 규칙
+  uint64_t pos = colon + 1;
+  while (pos < end && isBlank(ringAt(pos))) {
+    pos++;
+  }
+  double sign = 1;
+  if (pos < end && (ringAt(pos) == '-' || ringAt(pos) == '+')) {
+    sign = ringAt(pos) == '-' ? -1 : 1;
+    pos++;
+  }
+  double mantissa = 0;
+  double scale = 1;
+  size_t digits = 0;
+  while (pos < end && isDigit(ringAt(pos))) {
+    mantissa = mantissa * 10 + (ringAt(pos) - '0');
+    digits++;
+    pos++;
+  }
+  if (channel->isFloat && pos < end && ringAt(pos) == '.') {
+    pos++;
+    while (pos < end && isDigit(ringAt(pos))) {
+      mantissa = mantissa * 10 + (ringAt(pos) - '0');
+      scale *= 10;
+      digits++;
+      pos++;
+    }
+  }
+
+  if (digits == 0) {
+    stats_.parseFailures++;
+    return;
+  }
+
+  // 값 뒤의 @<기기 ms> (telemetryChannels.ts findDeviceTime과 같은 규칙)
+  double deviceTimeMs = kNoDeviceTime;
+  for (uint64_t at = end; at > pos; at--) {
+    if (ringAt(at - 1) != kAt) {
+      continue;
+    }
+    double stamp = 0;
+    size_t stampDigits = 0;
+    for (uint64_t i = at; i < end && isDigit(ringAt(i)); i++) {
+      stamp = stamp * 10 + (ringAt(i) - '0');
+      stampDigits++;
+    }
+    if (stampDigits > 0) {
+      deviceTimeMs = stamp;
+    }
+    break;
+  }
+  const double value = sign * mantissa / scale;
+  if (channel->channel == Channel::Protocol) {
+    // 협상 창 안에서 온 BIN:<v> 응답의 다음 바이트부터 프레임 디코딩 (BIN:0은 언제든 텍스트로 복귀)
+    binaryFrames_ = negotiating_ && value == kBinaryProtocolVersion;
+    negotiating_ = false;
+    if (!binaryFrames_) {
+      filled_ = 0;
+      expected_ = 0;
+    }
+  }
+  enqueue(channel->channel, value, timestampMs, deviceTimeMs);
+}
+
+void TelemetryIngest::resyncLine() {
+  uint64_t next = 0;
+  bool found = false;
+  for (uint64_t pos = tail_ + 1; pos < head_; pos++) {
+    if (isFrameStartAt(pos, head_)) {
+      next = pos;
+      found = true;
+      break;
+    }
+  }
+  if (!found) {
+    next = std::max<uint64_t>(tail_ + 1, head_ - kKeepTail);
+  }
+
+  stats_.droppedBytes += next - tail_;
+  stats_.droppedFrames++;
+  tail_ = next;
+  resynced_ = true;
+}
+
+bool TelemetryIngest::isFrameStartAt(uint64_t pos, uint64_t end) const {
+  for (const char* prefix : kFrameStarts) {
+    bool matched = true;
+    for (size_t i = 0; prefix[i] != '\0' && pos + i < end; i++) {
+      if (ringAt(pos + i) != static_cast<uint8_t>(prefix[i])) {
+        matched = false;
+        break;
+      }
+    }
+    if (matched) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TelemetryIngest::isCompleteFrameStartAt(uint64_t pos, uint64_t end)
+    const {
+  for (const char* prefix : kFrameStarts) {
+    const size_t length = std::strlen(prefix);
+    if (pos + length > end) {
+      continue;
+    }
+    bool matched = true;
+    for (size_t i = 0; i < length; i++) {
+      if (ringAt(pos + i) != static_cast<uint8_t>(prefix[i])) {
+        matched = false;
+        break;
+      }
+    }
+    if (matched) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TelemetryIngest::enqueue(
+    Channel channel,
+    double value,
+    double timestampMs,
+    double deviceTimeMs) {
+  if (pending_.size() >= kMaxPendingSamples) {
+    // JS가 오래 멈춘 경우: 오래된 절반을 한 번에 버린다.
+    // 텍스트 줄(ACK/PONG)은 pendingText_의 문자열과 짝이므로 남긴다
+    // (kMaxPendingText개 이하라 숫자 샘플만 버려도 자리가 난다)
+    size_t drop = pending_.size() / 2;
+    size_t kept = 0;
+    for (size_t i = 0; i < pending_.size(); i++) {
+      if (drop > 0 && pending_[i].channel != Channel::Text) {
+        drop--;
+        stats_.queueDrops++;
+        continue;
+      }
+      pending_[kept++] = pending_[i];
+    }
+    pending_.resize(kept);
+  }
+  pending_.push_back(Sample{channel, value, timestampMs, deviceTimeMs});
+}
+
+} // namespace zxis
@@ -0,0 +1,127 @@
+// cpp/TelemetryIngest.h
+// HC-06 시리얼 스트림을 JS 스레드 밖에서 프레이밍/디코딩하는 C++ 코어.
+// services/lineFramer.ts, telemetryChannels.ts, binaryProtocol.ts와 같은 규칙을 따른다.
+// 소켓 읽기 스레드가 push()로 바이트를 넣고, JS 스레드는 drain()으로 디코딩된 샘플을 한 번에 가져간다.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace zxis {
+
+// services/nativeIngest.ts의 NATIVE_CHANNEL_KEYS와 같은 순서 (Protocol 외에는 바이너리 채널 id와 동일)
+enum class Channel : uint8_t {
+  // 네이티브에서 디코딩하지 않은 줄. value는 drain()이 넘기는 textLines의 인덱스
+  Text = 0,
+  Bpm = 1,
+  Speed = 2,
+  TargetEcho = 3,
+  Rr = 4,
+  Incline = 5,
+  Distance = 6,
+  Protocol = 7,
+  Ecg = 8,
+};
+
+struct Sample {
+  Channel channel;
+  double value;
+  // 읽기 스레드가 바이트를 받은 시각 (epoch ms)
+  double timestampMs;
+  // 줄 끝의 @<기기 ms> (기기 단조 시계). 없으면 NaN
+  double deviceTimeMs;
+};
+
+struct IngestStats {
+  uint64_t bytes = 0;
+  uint64_t chunks = 0;
+  uint64_t lines = 0;
+  uint64_t frames = 0;
+  uint64_t parseFailures = 0;
+  uint64_t crcErrors = 0;
+  uint64_t seqGaps = 0;
+  uint64_t droppedBytes = 0;
+  uint64_t droppedFrames = 0;
+  // JS가 drain하지 못해 버려진 샘플 수
+  uint64_t queueDrops = 0;
+  // 텍스트 줄 큐(kMaxPendingText)가 가득 차서 버려진 줄 수 (ACK/PONG 유실)
+  uint64_t textDrops = 0;
+};
+
+class TelemetryIngest {
+ public:
+  static constexpr size_t kDefaultLineCapacity = 512;
+  static constexpr size_t kMaxPendingSamples = 4096;
+  static constexpr size_t kMaxPendingText = 64;
+
+  explicit TelemetryIngest(size_t lineCapacity = kDefaultLineCapacity);
+
+  // 읽기 스레드에서 호출
+  void push(const uint8_t* data, size_t length, double timestampMs);
+
+  // JS 스레드에서 호출. 대기 중인 샘플과 (네이티브에서 디코딩하지 않는) 텍스트 줄을 넘겨받는다.
+  // 텍스트 줄은 samples 안에 Channel::Text 항목으로 도착 순서대로 끼어 있다.
+  void drain(std::vector<Sample>& samples, std::vector<std::string>& textLines);
+
+  IngestStats stats() const;
+  void reset();
+
+  // JS 스레드에서 호출. JS가 BIN:<v> 협상 창을 열고 닫을 때 맞춰 부른다.
+  // 창이 열려 있을 때 온 BIN:<v>만 프레임 디코딩을 켠다 (늦은 응답으로 JS와 어긋나지 않도록)
+  void setNegotiating(bool negotiating);
+
+ private:
+  static constexpr int kBinaryProtocolVersion = 1;
+  static constexpr uint8_t kFrameSync = 0xA5;
+  static constexpr size_t kFrameHeader = 4;
+  static constexpr size_t kMaxSamplesPerFrame = 32;
+  static constexpr size_t kMaxFrameBytes = kFrameHeader + kMaxSamplesPerFrame * 2 + 1;
+
+  void pushByte(uint8_t b, double timestampMs);
+  void pushTextByte(uint8_t b, double timestampMs);
+  void emitLine(uint64_t lineEnd, double timestampMs);
+  void emitRange(uint64_t begin, uint64_t end, double timestampMs);
+  void decodeLine(uint64_t begin, uint64_t end, double timestampMs);
+  void resyncLine();
+  bool isFrameStartAt(uint64_t pos, uint64_t end) const;
+  bool isCompleteFrameStartAt(uint64_t pos, uint64_t end) const;
+  void resyncFrame(double timestampMs);
+  void deliverFrame(double timestampMs);
+  void enqueue(
+      Channel channel,
+      double value,
+      double timestampMs,
+      double deviceTimeMs);
+
+  uint8_t ringAt(uint64_t pos) const { return ring_[pos & mask_]; }
+
+  mutable std::mutex mutex_;
+
+  // 텍스트 줄 프레이밍 (lineFramer.ts)
+  std::vector<uint8_t> ring_;
+  uint64_t mask_;
+  uint64_t head_ = 0;
+  uint64_t tail_ = 0;
+  bool pendingBackslash_ = false;
+  // 재동기화 이후 아직 종결자를 만나지 않음
+  bool resynced_ = false;
+
+  // 바이너리 프레임 (binaryProtocol.ts). 기기가 BIN:1로 응답한 뒤에만 디코딩한다
+  bool binaryFrames_ = false;
+  bool negotiating_ = false;
+  std::array<uint8_t, kMaxFrameBytes> frame_{};
+  size_t filled_ = 0;
+  size_t expected_ = 0;
+  int lastSeq_ = -1;
+
+  std::vector<Sample> pending_;
+  std::vector<std::string> pendingText_;
+  IngestStats stats_;
+};
+
+} // namespace zxis
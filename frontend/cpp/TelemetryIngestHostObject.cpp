@@ -0,0 +1,168 @@
+// cpp/TelemetryIngestHostObject.cpp
+
+#include "TelemetryIngestHostObject.h"
+
+namespace zxis {
+
+namespace jsi = facebook::jsi;
+
+namespace {
+
+// [channel, value, timestampMs, deviceTimeMs] (nativeIngest.ts SAMPLE_STRIDE)
+constexpr size_t kSampleStride = 4;
+
+// Float64Array가 소유권을 가져가는 버퍼
+class SampleBuffer : public jsi::MutableBuffer {
+ public:
+  explicit SampleBuffer(size_t count) : data_(count * kSampleStride) {}
+
+  size_t size() const override {
+    return data_.size() * sizeof(double);
+  }
+
+  uint8_t* data() override {
+    return reinterpret_cast<uint8_t*>(data_.data());
+  }
+
+  double* values() {
+    return data_.data();
+  }
+
+ private:
+  std::vector<double> data_;
+};
+
+} // namespace
+
+TelemetryIngestHostObject::TelemetryIngestHostObject(
+    std::shared_ptr<TelemetryIngest> ingest)
+    : ingest_(std::move(ingest)) {}
+
+jsi::Value TelemetryIngestHostObject::get(
+    jsi::Runtime& runtime,
+    const jsi::PropNameID& name) {
+  const std::string prop = name.utf8(runtime);
+
+  if (prop == "drain") {
+    return jsi::Function::createFromHostFunction(
+        runtime,
+        name,
+        0,
+        [this](jsi::Runtime& rt, const jsi::Value&, const jsi::Value*, size_t) {
+          return drain(rt);
+        });
+  }
+
+  if (prop == "stats") {
+    return jsi::Function::createFromHostFunction(
+        runtime,
+        name,
+        0,
+        [this](jsi::Runtime& rt, const jsi::Value&, const jsi::Value*, size_t) {
+          return stats(rt);
+        });
+  }
+
+  if (prop == "reset") {
+    return jsi::Function::createFromHostFunction(
+        runtime,
+        name,
+        0,
+        [this](jsi::Runtime&, const jsi::Value&, const jsi::Value*, size_t) {
+          ingest_->reset();
+          return jsi::Value::undefined();
+        });
+  }
+
+  if (prop == "setNegotiating") {
+    return jsi::Function::createFromHostFunction(
+        runtime,
+        name,
+        1,
+        [this](
+            jsi::Runtime&,
+            const jsi::Value&,
+            const jsi::Value* args,
+            size_t count) {
+          ingest_->setNegotiating(count > 0 && args[0].getBool());
+          return jsi::Value::undefined();
+        });
+  }
+
+  return jsi::Value::undefined();
+}
+
+std::vector<jsi::PropNameID> TelemetryIngestHostObject::getPropertyNames(
+    jsi::Runtime& runtime) {
+  std::vector<jsi::PropNameID> names;
+  names.push_back(jsi::PropNameID::forAscii(runtime, "drain"));
+  names.push_back(jsi::PropNameID::forAscii(runtime, "stats"));
+  names.push_back(jsi::PropNameID::forAscii(runtime, "reset"));
+  names.push_back(jsi::PropNameID::forAscii(runtime, "setNegotiating"));
+  return names;
+}
+
+jsi::Value TelemetryIngestHostObject::drain(jsi::Runtime& runtime) {
+  ingest_->drain(samples_, textLines_);
+  if (samples_.empty() && textLines_.empty()) {
+    return jsi::Value::null();
+  }
+
+  auto buffer = std::make_shared<SampleBuffer>(samples_.size());
+  double* out = buffer->values();
+  for (const Sample& sample : samples_) {
+    *out++ = static_cast<double>(sample.channel);
+    *out++ = sample.value;
+    *out++ = sample.timestampMs;
+    *out++ = sample.deviceTimeMs;
+  }
+
+  jsi::ArrayBuffer arrayBuffer(runtime, buffer);
+  jsi::Value typed = runtime.global()
+                         .getPropertyAsFunction(runtime, "Float64Array")
+                         .callAsConstructor(runtime, arrayBuffer);
+
+  jsi::Array text(runtime, textLines_.size());
+  for (size_t i = 0; i < textLines_.size(); i++) {
+    text.setValueAtIndex(
+        runtime, i, jsi::String::createFromAscii(runtime, textLines_[i]));
+  }
+
+  jsi::Object result(runtime);
+  result.setProperty(runtime, "samples", typed);
+  result.setProperty(runtime, "text", text);
+  return result;
+}
+
+jsi::Value TelemetryIngestHostObject::stats(jsi::Runtime& runtime) {
+  const IngestStats s = ingest_->stats();
+  jsi::Object result(runtime);
+  result.setProperty(runtime, "bytes", static_cast<double>(s.bytes));
+  result.setProperty(runtime, "chunks", static_cast<double>(s.chunks));
+  result.setProperty(runtime, "lines", static_cast<double>(s.lines));
+  result.setProperty(runtime, "frames", static_cast<double>(s.frames));
+  result.setProperty(
+      runtime, "parseFailures", static_cast<double>(s.parseFailures));
+  result.setProperty(runtime, "crcErrors", static_cast<double>(s.crcErrors));
+  result.setProperty(runtime, "seqGaps", static_cast<double>(s.seqGaps));
+  result.setProperty(
+      runtime, "droppedBytes", static_cast<double>(s.droppedBytes));
+  result.setProperty(
+      runtime, "droppedFrames", static_cast<double>(s.droppedFrames));
+  result.setProperty(runtime, "queueDrops", static_cast<double>(s.queueDrops));
+  result.setProperty(runtime, "textDrops", static_cast<double>(s.textDrops));
+  return result;
+}
+
+void installTelemetryIngest(
+    jsi::Runtime& runtime,
+    std::shared_ptr<TelemetryIngest> ingest) {
+  auto hostObject =
+      std::make_shared<TelemetryIngestHostObject>(std::move(ingest));
+  runtime.global().setProperty(
+      runtime,
+      TelemetryIngestHostObject::kGlobalName,
+      jsi::Object::createFromHostObject(runtime, hostObject));
+}
+
+} // namespace zxis
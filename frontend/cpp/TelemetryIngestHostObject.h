@@ -0,0 +1,49 @@
+// cpp/TelemetryIngestHostObject.h
+// TelemetryIngest를 JS에 global.__telemetryIngest로 노출하는 JSI HostObject.
+//
+//   drain()  → { samples: Float64Array [channel, value, timestampMs, ...], text: string[] } | null
+//   stats()  → IngestStats 필드를 가진 객체
+//   reset()
+//   setNegotiating(boolean)  BIN:<v> 협상 창 열기/닫기
+
+#pragma once
+
+#include <jsi/jsi.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TelemetryIngest.h"
+
+namespace zxis {
+
+class TelemetryIngestHostObject : public facebook::jsi::HostObject {
+ public:
+  static constexpr const char* kGlobalName = "__telemetryIngest";
+
+  explicit TelemetryIngestHostObject(std::shared_ptr<TelemetryIngest> ingest);
+
+  facebook::jsi::Value get(
+      facebook::jsi::Runtime& runtime,
+      const facebook::jsi::PropNameID& name) override;
+
+  std::vector<facebook::jsi::PropNameID> getPropertyNames(
+      facebook::jsi::Runtime& runtime) override;
+
+ private:
+  facebook::jsi::Value drain(facebook::jsi::Runtime& runtime);
+  facebook::jsi::Value stats(facebook::jsi::Runtime& runtime);
+
+  std::shared_ptr<TelemetryIngest> ingest_;
+  // drain 사이에 재사용해서 JS 스레드의 네이티브 할당을 줄인다
+  std::vector<Sample> samples_;
+  std::vector<std::string> textLines_;
+};
+
+// JS 스레드에서 호출해야 한다
+void installTelemetryIngest(
+    facebook::jsi::Runtime& runtime,
+    std::shared_ptr<TelemetryIngest> ingest);
+
+} // namespace zxis
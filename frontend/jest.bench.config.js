@@ -0,0 +1,5 @@
+// 수신 경로 벤치마크 (npm run bench). 일반 테스트(jest)에는 포함되지 않는다
+module.exports = {
+  preset: 'react-native',
+  testMatch: ['<rootDir>/benchmarks/**/*.bench.ts'],
+};
@@ -18,6 +18,7 @@ import RNBluetoothClassic from "react-native-bluetooth-classic";
 import { RootStackParamList } from "../types/navigation";
 import { useWorkout } from "../context/WorkoutProvider";
 import { ArduinoBridge } from "../services/arduinoBridge";
+import { HeartRateSensorInfo } from "../services/heartRateStrap";
 
 type Props = NativeStackScreenProps<RootStackParamList, "BleConnection">;
 
@@ -63,11 +64,18 @@ export default function ConnectDeviceScreen({ navigation }: Props) {
     sendTargetHr,
     profile,
     purpose,
+    strapState,
+    scanHeartRateStraps,
+    connectHeartRateStrap,
+    disconnectHeartRateStrap,
   } = useWorkout();
 
   const [scanning, setScanning] = useState(false);
   const [devices, setDevices] = useState<DeviceInfo[]>([]);
   const [selectedDeviceId, setSelectedDeviceId] = useState<string | null>(null);
+  const [strapScanning, setStrapScanning] = useState(false);
+  const [straps, setStraps] = useState<HeartRateSensorInfo[]>([]);
+  const [selectedStrapId, setSelectedStrapId] = useState<string | null>(null);
 
   // 🔥 연결 끊김 감지
   useEffect(() => {
@@ -192,6 +200,61 @@ export default function ConnectDeviceScreen({ navigation }: Props) {
     );
   };
 
+  // 심박 벨트 (BLE, 선택 사항). 페어링 없이 광고를 스캔해서 찾는다
+  const startStrapScan = async () => {
+    const ok = await requestBtPermissions();
+    if (!ok) {
+      Alert.alert(
+        "권한 필요",
+        "블루투스 사용을 위해 위치 및 블루투스 권한이 필요합니다."
+      );
+      return;
+    }
+
+    setStrapScanning(true);
+    setStraps([]);
+    try {
+      await scanHeartRateStraps((sensor) =>
+        setStraps((prev) => [...prev, sensor])
+      );
+    } catch (error) {
+      console.error("[StrapScan] Error:", error);
+      Alert.alert("심박 벨트 검색 실패", String(error));
+    } finally {
+      setStrapScanning(false);
+    }
+  };
+
+  const handleStrapPress = async (sensorId: string) => {
+    if (selectedStrapId === sensorId && strapState !== "disconnected") {
+      await disconnectHeartRateStrap();
+      setSelectedStrapId(null);
+      return;
+    }
+
+    setSelectedStrapId(sensorId);
+    try {
+      await connectHeartRateStrap(sensorId);
+    } catch (error) {
+      setSelectedStrapId(null);
+      Alert.alert("심박 벨트 연결 실패", String(error));
+    }
+  };
+
+  const strapStateLabel = (sensorId: string) => {
+    if (selectedStrapId !== sensorId) return "연결하기";
+    switch (strapState) {
+      case "connecting":
+        return "연결 중...";
+      case "connected":
+        return "연결됨 · 해제";
+      case "reconnecting":
+        return "재연결 중...";
+      default:
+        return "연결하기";
+    }
+  };
+
   // 신호 강도를 바 개수로 변환
   const getSignalBars = (rssi: number): 1 | 2 | 3 | 4 => {
     if (rssi >= -50) return 4;
@@ -361,6 +424,44 @@ export default function ConnectDeviceScreen({ navigation }: Props) {
           </View>
         )}
 
+        {/* 심박 벨트 (BLE Heart Rate) */}
+        <View style={styles.infoBox}>
+          <Text style={styles.infoTitle}>심박 벨트 (선택)</Text>
+          <Text style={styles.infoText}>
+            BLE 가슴 벨트를 연결하면 러닝머신 센서 대신 벨트의 심박수를 사용합니다.
+          </Text>
+          {straps.map((sensor) => (
+            <TouchableOpacity
+              key={sensor.id}
+              style={styles.strapRow}
+              onPress={() => handleStrapPress(sensor.id)}
+            >
+              <Icon
+                name="favorite"
+                size={20}
+                color={
+                  selectedStrapId === sensor.id && strapState === "connected"
+                    ? "#32CD32"
+                    : "#9DA6B9"
+                }
+              />
+              <Text style={styles.strapName}>{sensor.name}</Text>
+              <Text style={styles.strapState}>{strapStateLabel(sensor.id)}</Text>
+            </TouchableOpacity>
+          ))}
+          <TouchableOpacity
+            style={styles.strapScanButton}
+            onPress={startStrapScan}
+            disabled={strapScanning}
+          >
+            {strapScanning ? (
+              <ActivityIndicator color="#FFFFFF" size="small" />
+            ) : (
+              <Text style={styles.connectText}>심박 벨트 검색</Text>
+            )}
+          </TouchableOpacity>
+        </View>
+
         {/* Scanning Indicator */}
         {scanning && (
           <View style={styles.scanningBox}>
@@ -572,6 +673,30 @@ const styles = StyleSheet.create({
     textAlign: "center",
     maxWidth: 260,
   },
+  strapRow: {
+    flexDirection: "row",
+    alignItems: "center",
+    gap: 10,
+    paddingVertical: 10,
+    borderBottomWidth: 1,
+    borderBottomColor: "#2E3440",
+  },
+  strapName: {
+    flex: 1,
+    color: "#FFFFFF",
+    fontSize: 14,
+  },
+  strapState: {
+    color: "#9DA6B9",
+    fontSize: 12,
+  },
+  strapScanButton: {
+    marginTop: 10,
+    backgroundColor: "#135bec",
+    paddingVertical: 10,
+    borderRadius: 10,
+    alignItems: "center",
+  },
   scanningBox: {
     marginTop: 20,
     alignItems: "center",
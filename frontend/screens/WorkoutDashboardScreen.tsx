@@ -1,10 +1,11 @@
-﻿import React, { useEffect, useMemo, useState } from "react";
+﻿import React, { useEffect, useMemo, useRef, useState } from "react";
 import {
   View,
   Text,
   TouchableOpacity,
   StyleSheet,
   ScrollView,
+  Share,
 } from "react-native";
 import Icon from "react-native-vector-icons/MaterialIcons";
 import { VictoryLine } from "victory-native";
@@ -12,24 +13,189 @@ import { NativeStackScreenProps } from "@react-navigation/native-stack";
 
 import { RootStackParamList } from "../types/navigation";
 import { useWorkout } from "../context/WorkoutProvider";
+import { SessionDiagnostics } from "../services/arduinoBridge";
+import { LatencySummary } from "../services/latencyHistogram";
 
 type Props = NativeStackScreenProps<RootStackParamList, "WorkoutDashboard">;
 
 type ChartPoint = { x: number; y: number };
 
+// ECG 파형 표시: 최근 3초를 150포인트로 솎아서 10 fps로 갱신
+const ECG_WINDOW_SECONDS = 3;
+const ECG_DISPLAY_POINTS = 150;
+const ECG_REFRESH_MS = 100;
+// 디버그 오버레이 갱신 주기
+const DEBUG_REFRESH_MS = 500;
+
+function formatLatency(summary: LatencySummary): string {
+  if (summary.count === 0) return "-";
+  return `p50 ${summary.p50.toFixed(1)} / p95 ${summary.p95.toFixed(
+    1
+  )} / p99 ${summary.p99.toFixed(1)} ms (n=${summary.count})`;
+}
+
+// 제목을 길게 누르면 열리는 계측 오버레이. 열려 있을 때만 주기적으로 스냅샷을 읽는다
+function DebugOverlay({
+  getDiagnostics,
+  startCapture,
+  stopCapture,
+}: {
+  getDiagnostics: () => SessionDiagnostics;
+  startCapture: () => void;
+  stopCapture: () => string | null;
+}) {
+  const [diagnostics, setDiagnostics] = useState(getDiagnostics);
+  const [capturing, setCapturing] = useState(false);
+
+  useEffect(() => {
+    const timer = setInterval(
+      () => setDiagnostics(getDiagnostics()),
+      DEBUG_REFRESH_MS
+    );
+    return () => clearInterval(timer);
+  }, [getDiagnostics]);
+
+  const exportSession = () => {
+    Share.share({
+      title: "zxis session diagnostics",
+      message: JSON.stringify(getDiagnostics(), null, 2),
+    }).catch(() => undefined);
+  };
+
+  // 캡처 파일(base64)은 ReplayTransport로 재생해서 회귀 입력/벤치마크로 쓴다
+  const toggleCapture = () => {
+    if (!capturing) {
+      startCapture();
+      setCapturing(true);
+      return;
+    }
+    setCapturing(false);
+    const capture = stopCapture();
+    if (capture) {
+      Share.share({
+        title: "zxis raw capture",
+        message: capture,
+      }).catch(() => undefined);
+    }
+  };
+
+  const { counters, fanOut, endToEnd, oneWay } = diagnostics.ingest;
+  const { clock, speedControl, hrModel, program } = diagnostics;
+  const rows: [string, string][] = [
+    ["link", `${diagnostics.state} / ${diagnostics.protocol}`],
+    ["bytes / chunks", `${counters.bytes} / ${counters.chunks}`],
+    ["lines / frames", `${counters.lines} / ${counters.frames}`],
+    [
+      "parse fail / unknown",
+      `${counters.parseFailures} / ${counters.unknownLines}`,
+    ],
+    [
+      "overflow bytes / frames",
+      `${counters.overflowBytes} / ${counters.overflowFrames}`,
+    ],
+    [
+      "crc / queue / text drops",
+      `${counters.crcErrors} / ${counters.queueDrops} / ${counters.textDrops}`,
+    ],
+    ["fan-out", formatLatency(fanOut)],
+    ["chunk → commit", formatLatency(endToEnd)],
+    [
+      "device clock",
+      clock.synced
+        ? `${clock.offsetMs} ms · ${clock.driftPpm} ppm · rtt ${clock.minRttMs}`
+        : `not synced (${clock.exchanges})`,
+    ],
+    ["device → chunk", formatLatency(oneWay)],
+    [
+      "speed control",
+      `${speedControl.ticks} ticks · ${speedControl.commands} cmd · ${speedControl.holds} hold`,
+    ],
+    ["decision → cmd", formatLatency(speedControl.decisionToCommand)],
+    [
+      "hr model",
+      hrModel.params
+        ? `K ${hrModel.params.gain} · τ ${hrModel.params.timeConstantS}s · θ ${hrModel.params.deadTimeS}s · ${hrModel.source === "stored" ? "earlier session" : hrModel.source} · ${speedControl.predictiveTicks} mpc`
+        : `learning (${hrModel.sessionSamples} s)`,
+    ],
+    [
+      "program lead",
+      `${program.leadMs} ms · ${program.onTime}/${program.staged} on time`,
+    ],
+    ["segment late", formatLatency(program.landingLate)],
+    ...Object.entries(diagnostics.commandLatency).map(
+      ([type, summary]): [string, string] => [
+        `cmd ${type}`,
+        formatLatency(summary),
+      ]
+    ),
+    ["belt stop", formatLatency(diagnostics.beltStop)],
+    ...Object.entries(diagnostics.heartRateSources)
+      .filter(([, source]) => source.updates > 0)
+      .map(([key, source]): [string, string] => [
+        `hr ${key}`,
+        `${source.updates} ok / ${source.rejected} rej · ${source.latencyMs} ms · ±${source.noiseBpm}`,
+      ]),
+    ...Object.entries(diagnostics.heartRateFilters)
+      .filter(([, filter]) => filter.rejectedRange + filter.rejectedRate > 0)
+      .map(([key, filter]): [string, string] => [
+        `hr filter ${key}`,
+        `${filter.rejectedRange} range / ${filter.rejectedRate} rate · ${filter.reseeds} reseed`,
+      ]),
+  ];
+
+  return (
+    <View style={styles.debugOverlay}>
+      {rows.map(([label, value]) => (
+        <View key={label} style={styles.debugRow}>
+          <Text style={styles.debugLabel}>{label}</Text>
+          <Text style={styles.debugValue}>{value}</Text>
+        </View>
+      ))}
+      <TouchableOpacity style={styles.debugExport} onPress={exportSession}>
+        <Text style={styles.debugExportText}>세션 내보내기</Text>
+      </TouchableOpacity>
+      <TouchableOpacity style={styles.debugExport} onPress={toggleCapture}>
+        <Text style={styles.debugExportText}>
+          {capturing ? "캡처 중지 · 공유" : "원시 수신 캡처"}
+        </Text>
+      </TouchableOpacity>
+    </View>
+  );
+}
+
 export default function WorkoutDashboardScreen({ navigation }: Props) {
   const {
     heartRate,
+    heartRateStale,
     targetHr,
+    purpose,
     speed,
+    speedStale,
     // ecgHistory,  // <= 이제 안 씀
     adjustSpeed,
+    speedControl,
+    startSpeedControl,
+    stopSpeedControl,
+    program,
+    startProgram,
+    stopProgram,
     sendTargetHr,
     emergencyStop,
     connectionState,
+    ecgWaveform,
+    getDiagnostics,
+    startCapture,
+    stopCapture,
   } = useWorkout();
 
+  const [showDebug, setShowDebug] = useState(false);
+
+  // 프로그램 구간 카운트다운 표시용 (프로그램 실행은 브리지 타이머가 맡는다)
+  const [clockNow, setClockNow] = useState(Date.now());
+
   const [chartData, setChartData] = useState<ChartPoint[]>([]);
+  const [ecgData, setEcgData] = useState<ChartPoint[]>([]);
+  const ecgScratch = useRef(new Float32Array(ECG_DISPLAY_POINTS));
 
   // 속도 표시용 (NaN 방지)
   const displaySpeed = useMemo(
@@ -49,9 +215,47 @@ export default function WorkoutDashboardScreen({ navigation }: Props) {
     });
   }, [heartRate]);
 
+  // 🔥 원시 ECG 파형: 샘플마다 렌더하지 않고 링 버퍼를 주기적으로 읽는다
+  useEffect(() => {
+    let lastSeq = -1;
+    const timer = setInterval(() => {
+      if (ecgWaveform.totalWritten === lastSeq) return;
+      lastSeq = ecgWaveform.totalWritten;
+
+      const stride = Math.max(
+        1,
+        Math.floor(
+          (ecgWaveform.sampleRateHz * ECG_WINDOW_SECONDS) / ECG_DISPLAY_POINTS
+        )
+      );
+      const scratch = ecgScratch.current;
+      const count = ecgWaveform.copyLatest(scratch, stride);
+      const points: ChartPoint[] = new Array(count);
+      for (let i = 0; i < count; i++) {
+        points[i] = { x: i, y: scratch[i] };
+      }
+      setEcgData(points);
+    }, ECG_REFRESH_MS);
+
+    return () => clearInterval(timer);
+  }, [ecgWaveform]);
+
+  useEffect(() => {
+    if (program.state !== "running") return;
+    const timer = setInterval(() => setClockNow(Date.now()), 1000);
+    return () => clearInterval(timer);
+  }, [program.state]);
+
+  const segmentRemaining = Math.max(
+    0,
+    Math.ceil((program.segmentEndsAt - clockNow) / 1000)
+  );
+
   const connectionLabel = useMemo(() => {
     if (connectionState === "connected") return "아두이노 연결됨";
     if (connectionState === "connecting") return "연결 중...";
+    if (connectionState === "stalled") return "데이터 수신 지연";
+    if (connectionState === "reconnecting") return "재연결 중...";
     return "미연결 상태";
   }, [connectionState]);
 
@@ -60,11 +264,24 @@ export default function WorkoutDashboardScreen({ navigation }: Props) {
       {/* Top Bar */}
       <View style={styles.topBar}>
         <View>
-          <Text style={styles.topTitle}>대시보드</Text>
+          <Text
+            style={styles.topTitle}
+            onLongPress={() => setShowDebug((prev) => !prev)}
+          >
+            대시보드
+          </Text>
           <Text style={styles.topSubtitle}>{connectionLabel}</Text>
         </View>
       </View>
 
+      {showDebug && (
+        <DebugOverlay
+          getDiagnostics={getDiagnostics}
+          startCapture={startCapture}
+          stopCapture={stopCapture}
+        />
+      )}
+
       <ScrollView contentContainerStyle={styles.content}>
         {/* Current HR */}
         <View style={styles.hrCard}>
@@ -77,12 +294,16 @@ export default function WorkoutDashboardScreen({ navigation }: Props) {
               color="#FF3B30"
               style={styles.pulse}
             />
-            <Text style={styles.hrValue}>
+            <Text
+              style={[styles.hrValue, heartRateStale && styles.staleValue]}
+            >
               {heartRate != null ? heartRate : "--"}
             </Text>
           </View>
 
-          <Text style={styles.label}>BPM</Text>
+          <Text style={styles.label}>
+            {heartRateStale ? "BPM · 수신 지연" : "BPM"}
+          </Text>
         </View>
 
         {/* Trend Chart */}
@@ -123,12 +344,35 @@ export default function WorkoutDashboardScreen({ navigation }: Props) {
 
         </View>
 
+        {/* Raw ECG Waveform */}
+        {ecgData.length > 1 && (
+          <View style={styles.chartCard}>
+            <View style={styles.chartHeader}>
+              <Text style={styles.chartTitle}>ECG 파형</Text>
+              <Text style={styles.chartSub}>최근 {ECG_WINDOW_SECONDS}초</Text>
+            </View>
+
+            <View style={{ height: 140 }}>
+              <VictoryLine
+                data={ecgData}
+                style={{
+                  data: { stroke: "#FF3B30", strokeWidth: 1.5 },
+                }}
+              />
+            </View>
+          </View>
+        )}
+
         {/* Current Speed */}
         <View style={styles.speedCard}>
           <Text style={styles.label}>현재 속도</Text>
 
           <View style={styles.speedRow}>
-            <Text style={styles.speedValue}>{displaySpeed.toFixed(1)}</Text>
+            <Text
+              style={[styles.speedValue, speedStale && styles.staleValue]}
+            >
+              {displaySpeed.toFixed(1)}
+            </Text>
             <Text style={styles.speedUnit}>MPH</Text>
           </View>
         </View>
@@ -150,6 +394,61 @@ export default function WorkoutDashboardScreen({ navigation }: Props) {
           </TouchableOpacity>
         </View>
 
+        {/* Interval Program (HIIT) */}
+        {purpose === "hiit" && (
+          <View style={styles.programCard}>
+            {program.state === "running" && program.index >= 0 ? (
+              <>
+                <Text style={styles.programLabel}>{program.label}</Text>
+                <Text style={styles.programCountdown}>
+                  {Math.floor(segmentRemaining / 60)}:
+                  {String(segmentRemaining % 60).padStart(2, "0")}
+                </Text>
+                <Text style={styles.programSub}>
+                  구간 {program.index + 1}/{program.count}
+                </Text>
+              </>
+            ) : (
+              <Text style={styles.programSub}>
+                {program.state === "finished"
+                  ? "프로그램 완료"
+                  : "워밍업 → 질주/회복 반복 → 마무리"}
+              </Text>
+            )}
+            <TouchableOpacity
+              style={styles.programButton}
+              onPress={
+                program.state === "running" ? stopProgram : startProgram
+              }
+            >
+              <Text style={styles.programButtonText}>
+                {program.state === "running"
+                  ? "프로그램 중지"
+                  : "HIIT 프로그램 시작"}
+              </Text>
+            </TouchableOpacity>
+          </View>
+        )}
+
+        {/* HR-tracking Speed Control */}
+        <TouchableOpacity
+          style={[
+            styles.autoSpeedButton,
+            speedControl.mode !== "off" && styles.autoSpeedButtonActive,
+          ]}
+          onPress={
+            speedControl.mode === "off" ? startSpeedControl : stopSpeedControl
+          }
+        >
+          <Text style={styles.autoSpeedText}>
+            {speedControl.mode === "off"
+              ? "자동 속도 조절 시작"
+              : speedControl.mode === "holding"
+                ? "자동 속도 · 심박 대기 중 (끄기)"
+                : `자동 속도 · ${speedControl.band?.low}–${speedControl.band?.high} bpm (끄기)`}
+          </Text>
+        </TouchableOpacity>
+
         {/* Send Target HR */}
         <TouchableOpacity style={styles.sendButton} onPress={sendTargetHr}>
           <Text style={styles.sendText}>
@@ -296,6 +595,10 @@ const styles = StyleSheet.create({
     fontSize: 18,
     marginLeft: 8,
   },
+  // 갱신이 멈춘 값은 흐리게
+  staleValue: {
+    color: "#B0B8C4",
+  },
 
   /* Speed Control Buttons */
   speedButtons: {
@@ -311,6 +614,62 @@ const styles = StyleSheet.create({
     justifyContent: "center",
   },
 
+  /* Interval Program */
+  programCard: {
+    backgroundColor: "#FFFFFF",
+    borderRadius: 20,
+    padding: 20,
+    alignItems: "center",
+    gap: 6,
+  },
+  programLabel: {
+    fontSize: 20,
+    fontWeight: "700",
+    color: "#1A1A1A",
+  },
+  programCountdown: {
+    fontSize: 44,
+    fontWeight: "700",
+    color: "#FF3B30",
+  },
+  programSub: {
+    color: "#7C8798",
+    fontSize: 14,
+  },
+  programButton: {
+    marginTop: 8,
+    height: 48,
+    alignSelf: "stretch",
+    borderRadius: 14,
+    backgroundColor: "#FF3B30",
+    alignItems: "center",
+    justifyContent: "center",
+  },
+  programButtonText: {
+    color: "#FFFFFF",
+    fontSize: 16,
+    fontWeight: "700",
+  },
+
+  /* HR-tracking Speed Control */
+  autoSpeedButton: {
+    height: 56,
+    borderRadius: 16,
+    borderWidth: 1,
+    borderColor: "#FF9500",
+    backgroundColor: "#FFF4E5",
+    alignItems: "center",
+    justifyContent: "center",
+  },
+  autoSpeedButtonActive: {
+    backgroundColor: "#FF9500",
+  },
+  autoSpeedText: {
+    color: "#1A1A1A",
+    fontSize: 16,
+    fontWeight: "700",
+  },
+
   /* Send Target HR */
   sendButton: {
     height: 60,
@@ -360,4 +719,37 @@ const styles = StyleSheet.create({
     fontWeight: "700",
     color: "#FFFFFF",
   },
+
+  /* Debug overlay */
+  debugOverlay: {
+    marginHorizontal: 16,
+    marginBottom: 8,
+    padding: 12,
+    borderRadius: 12,
+    backgroundColor: "rgba(10, 15, 26, 0.9)",
+  },
+  debugRow: {
+    flexDirection: "row",
+    justifyContent: "space-between",
+    paddingVertical: 2,
+  },
+  debugLabel: {
+    color: "#7C8798",
+    fontSize: 11,
+    fontFamily: "monospace",
+  },
+  debugValue: {
+    color: "#39FF14",
+    fontSize: 11,
+    fontFamily: "monospace",
+  },
+  debugExport: {
+    marginTop: 8,
+    alignSelf: "flex-end",
+  },
+  debugExportText: {
+    color: "#007BFF",
+    fontSize: 12,
+    fontWeight: "700",
+  },
 });
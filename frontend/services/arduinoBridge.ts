@@ -1,8 +1,78 @@
 // services/arduinoBridge.ts
-import RNBluetoothClassic, {
-  BluetoothDevice,
-  BluetoothEventSubscription,
-} from "react-native-bluetooth-classic";
+import { BluetoothDevice } from "react-native-bluetooth-classic";
+
+import {
+  BINARY_PROTOCOL_VERSION,
+  BinaryDecoderStats,
+  BinaryFrameDecoder,
+} from "./binaryProtocol";
+import { BpmFilter, BpmFilterStats } from "./bpmFilter";
+import { ClassicTransport } from "./classicTransport";
+import { ClockSync, ClockSyncStats } from "./clockSync";
+import {
+  CommandCancelledError,
+  CommandQueue,
+  CommandQueueStats,
+} from "./commandQueue";
+import {
+  ECG_DEFAULT_SAMPLE_RATE_HZ,
+  EcgRateEstimator,
+  EcgRingBuffer,
+} from "./ecgBuffer";
+import {
+  BleHeartRateSensor,
+  HeartRateMeasurement,
+  HeartRateSensor,
+  HeartRateSensorInfo,
+  HeartRateSensorSink,
+} from "./heartRateStrap";
+import {
+  HeartRateEstimate,
+  HeartRateFusion,
+  HeartRateSourceKey,
+  HeartRateSourceStats,
+} from "./heartRateFusion";
+import {
+  HrModelStats,
+  HrModelStore,
+  HrResponseModel,
+  MemoryHrModelStore,
+} from "./hrResponseModel";
+import {
+  ProgramRunner,
+  ProgramStats,
+  ProgramStatus,
+  WorkoutProgram,
+  compileProgram,
+} from "./intervalProgram";
+import { LatencyHistogram, LatencySummary } from "./latencyHistogram";
+import { LinkWatchdog, LinkWatchdogOptions } from "./linkWatchdog";
+import { TrafficLog, createLogger } from "./logger";
+import {
+  IngestMetrics,
+  IngestMetricsSnapshot,
+  monotonicNow,
+} from "./ingestMetrics";
+import { FramerStats, LineFramer, LineView } from "./lineFramer";
+import { NativeIngestStats } from "./nativeIngest";
+import { NativeIngestTransport } from "./nativeTransport";
+import { BeatEvent, QrsDetector } from "./qrsDetector";
+import { ReconnectSupervisor } from "./reconnectSupervisor";
+import {
+  HeartRateBand,
+  SpeedControlStats,
+  SpeedControlStatus,
+  SpeedController,
+  SpeedControllerOptions,
+} from "./speedController";
+import {
+  TELEMETRY_PREFIXES,
+  TelemetryChannelKey,
+  TelemetryDispatcher,
+  TelemetryListener,
+} from "./telemetryChannels";
+import { CaptureRecorder } from "./trafficCapture";
+import { Transport, TransportSink } from "./transport";
 
 type WorkoutPurposeKey = "fatBurn" | "cardio" | "hiit";
 
@@ -25,27 +95,518 @@ const PURPOSE_INTENSITY: Record<WorkoutPurposeKey, IntensityRange> = {
 export type ArduinoConnectionState =
   | "disconnected"
   | "connecting"
-  | "connected";
+  | "connected"
+  | "stalled"
+  | "reconnecting";
+
+/** 도착 간격을 감시하는 값 스트림 */
+export type WatchedStream = "heartRate" | "speed";
+
+export type LinkProtocol = "text" | "binary";
+
+/** BLE 심박 벨트 연결 상태 (러닝머신 링크와 별개) */
+export type StrapState =
+  | "disconnected"
+  | "connecting"
+  | "connected"
+  | "reconnecting";
+
+export type ArduinoBridgeOptions = {
+  /** 연결 시 BIN:1 바이너리 프레임을 협상한다. 기기가 제때 응답하지 않으면 BIN:0을 보내고 텍스트 유지 */
+  binaryProtocol?: boolean;
+  /** 네이티브 인제스트 모듈이 있으면 소켓 읽기/디코딩을 JS 스레드 밖에서 처리 */
+  nativeIngest?: boolean;
+  /** 명령에 #<seq>를 붙여 보내고 기기의 ACK:<seq>를 기다린다 (없으면 재전송) */
+  commandAcks?: boolean;
+  /** BPM/SPD 도착 간격 감시 (기본: 예상 주기 1초 × 1.5) */
+  linkWatchdog?: LinkWatchdogOptions;
+  /** 이 간격으로 PING:<n>을 보내고 PONG:<n>도 링크가 살아 있는 신호로 센다. 0이면 끔 */
+  keepaliveIntervalMs?: number;
+  /**
+   * 이 간격으로 PING:<n>을 보내 기기 시계와의 오프셋/드리프트를 잰다 (연결 직후에는 몇 번 빠르게).
+   * PONG:<n>@<기기 ms>로 답하는 기기에서만 동기화된다. 0이면 끔
+   */
+  clockSyncIntervalMs?: number;
+  /**
+   * 링크 구현을 직접 지정한다 (테스트/시뮬레이터: LoopbackTransport, TcpTransport 등).
+   * 없으면 네이티브 인제스트 → Bluetooth Classic 순서로 고른다.
+   */
+  transport?: Transport;
+  /** BLE 심박 벨트 구현 (없으면 react-native-ble-plx) */
+  heartRateSensor?: HeartRateSensor;
+  /** 심박 추종 속도 제어 루프 주기/이득/한도 */
+  speedControl?: SpeedControllerOptions;
+  /** 프로필별 심박 응답 모델 저장소 (없으면 앱이 떠 있는 동안만 유지) */
+  hrModelStore?: HrModelStore;
+};
+
+const RECEIVE_BUFFER_SIZE = 512;
+const PROTOCOL_NEGOTIATION_TIMEOUT_MS = 1000;
+// EHZ: 값이 이보다 크면 잘못된 줄로 본다
+const MAX_ECG_SAMPLE_RATE_HZ = 2000;
+const CONNECT_TIMEOUT_MS = 15000;
+const STRAP_CONNECT_TIMEOUT_MS = 10000;
+const COMMAND_ACK_TIMEOUT_MS = 300;
+const COMMAND_MAX_RETRIES = 3;
+// ACK 모드에서 STOP은 ACK가 올 때까지 이 간격으로 다시 보낸다
+const STOP_RESEND_INTERVAL_MS = 100;
+const STOP_MAX_DURATION_MS = 10000;
+// 자동 재연결 시도 한 번의 제한 시간 (수동 연결보다 짧게)
+const RECONNECT_ATTEMPT_TIMEOUT_MS = 5000;
+// stalled 상태가 이만큼 이어지면 소켓이 죽은 것으로 보고 재연결한다
+const STALL_RECONNECT_MS = 5000;
+// 시계 동기화: 연결 직후 이 간격으로 몇 번 먼저 교환한다
+const CLOCK_SYNC_BURST = 5;
+const CLOCK_SYNC_BURST_INTERVAL_MS = 200;
+// 응답이 오지 않은 PING은 이 시간이 지나면 잊는다
+const PING_EXPIRY_MS = 5000;
+
+// 여러 ArduinoBridge(재생성된 Provider)가 같은 저장소를 본다
+const defaultHrModelStore = new MemoryHrModelStore();
+
+const log = createLogger("BT");
+// 청크/줄마다 찍히는 로그. debug 레벨에서만, 그것도 20번에 한 번만
+const ingestLog = createLogger("BT:ingest", { sampleEvery: 20 });
 
 type EcgListener = (bpm: number) => void;
 type SpeedListener = (speed: number) => void;
+type BeatListener = (beat: BeatEvent) => void;
+type StateListener = (state: ArduinoConnectionState) => void;
+type StrapStateListener = (state: StrapState) => void;
+type SpeedControlListener = (status: SpeedControlStatus) => void;
+type RawHeartRateListener = (source: HeartRateSourceKey, bpm: number) => void;
+type ProgramListener = (status: ProgramStatus) => void;
+
+/** 디버그 오버레이/세션 내보내기용 진단 정보 */
+export type SessionDiagnostics = {
+  exportedAt: string;
+  state: ArduinoConnectionState;
+  protocol: LinkProtocol;
+  ingest: IngestMetricsSnapshot;
+  commands: CommandQueueStats;
+  commandLatency: Record<string, LatencySummary>;
+  /** STOP을 누른 뒤 기기가 SPD:0을 보고하기까지 (감속 시간이라 명령 전달 지연과 따로 잰다) */
+  beltStop: LatencySummary;
+  native: NativeIngestStats | null;
+  /** 기기 시계 동기화 상태 */
+  clock: ClockSyncStats;
+  /** 심박 소스별 갱신/기각 수와 추정 지연·잡음 */
+  heartRateSources: Record<HeartRateSourceKey, HeartRateSourceStats>;
+  /** 심박 소스별 범위/변화율 게이트에 걸려 버린 값 */
+  heartRateFilters: Record<HeartRateSourceKey, BpmFilterStats>;
+  /** 심박 추종 속도 제어: 틱/명령 수와 결정→명령 지연 */
+  speedControl: SpeedControlStats;
+  /** 속도 → 심박 응답 모델: 맞춘 이득/시정수/데드타임과 출처 */
+  hrModel: HrModelStats;
+  /** 인터벌 프로그램: 선행 시간과 구간 전환이 경계에 맞게 도착했는지 */
+  program: ProgramStats;
+  /** 최근 원시 송수신 (TrafficLog.dump) */
+  traffic: string;
+};
+type StaleListener = (stream: WatchedStream, stale: boolean) => void;
+type LivenessStream = WatchedStream | "keepalive";
+
+type Setpoints = {
+  target: number | null;
+  speed: number | null;
+};
 
 export class ArduinoBridge {
-  private device: BluetoothDevice | null = null;
+  private transport: Transport;
+  // 자동 재연결에 쓰는 마지막으로 연결한 기기 id
+  private deviceId: string | null = null;
   private state: ArduinoConnectionState = "disconnected";
-  private ecgListeners: Set<EcgListener> = new Set();
-  private speedListeners: Set<SpeedListener> = new Set();
-  private dataSubscription: BluetoothEventSubscription | null = null;
-  private receiveBuffer: string = "";
+  private stateListeners: Set<StateListener> = new Set();
+  private reconnect: ReconnectSupervisor;
+  // 기기가 확인한(ACK 모드가 아니면 전송이 끝난) 마지막 목표 심박/속도
+  private confirmedSetpoints: Setpoints = { target: null, speed: null };
+  private watchdog: LinkWatchdog<LivenessStream>;
+  private staleListeners: Set<StaleListener> = new Set();
+  private stallTimer: ReturnType<typeof setTimeout> | null = null;
+  private pingTimer: ReturnType<typeof setTimeout> | null = null;
+  private pingSeq = 0;
+  // 응답을 기다리는 PING seq → 보낸 시각 (epoch ms)
+  private pendingPings: Map<number, number> = new Map();
+  private clock: ClockSync = new ClockSync();
+  private options: ArduinoBridgeOptions;
+  private protocol: LinkProtocol = "text";
+  private negotiationTimer: ReturnType<typeof setTimeout> | null = null;
+  private telemetry: TelemetryDispatcher = new TelemetryDispatcher();
+  // 트랜스포트가 넘겨 주는 수신 데이터는 모두 여기로 들어온다
+  private sink: TransportSink = {
+    onText: (chunk, arrivedAtMs) => this.ingestText(chunk, arrivedAtMs),
+    onBytes: (chunk, arrivedAtMs) => this.ingestBytes(chunk, arrivedAtMs),
+    onLine: (line, arrivedAtMs) => this.ingestLine(line, arrivedAtMs),
+    onSample: (key, value, arrivedAtMs, deviceTimeMs) => {
+      this.sampleArrivedAt = arrivedAtMs;
+      const startedAt = monotonicNow();
+      this.telemetry.emit(key, value, deviceTimeMs);
+      this.metrics.recordFanOut(startedAt);
+      if (deviceTimeMs !== undefined) this.recordOneWay(deviceTimeMs);
+    },
+    onClosed: () => {
+      log.warn(`${this.transport.kind} link closed`);
+      this.handleLinkLost();
+    },
+  };
+  // 최근 원시 송수신 (네이티브 인제스트에서는 JS로 넘어온 텍스트 줄만)
+  private traffic: TrafficLog = new TrafficLog();
+  // startCapture() 중이면 받은 원시 청크 전부 (재생용)
+  private capture: CaptureRecorder | null = null;
+  private framer: LineFramer = new LineFramer(
+    (line) => this.parseLine(line),
+    RECEIVE_BUFFER_SIZE,
+    TELEMETRY_PREFIXES
+  );
+  private decoder: BinaryFrameDecoder = new BinaryFrameDecoder(
+    (key, value) => {
+      const startedAt = monotonicNow();
+      this.telemetry.emit(key, value);
+      this.metrics.recordFanOut(startedAt);
+    },
+    (byte) => this.framer.pushByte(byte)
+  );
+  private metrics: IngestMetrics = new IngestMetrics();
+  // 트랜스포트 안에서 이미 센 줄 (네이티브 인제스트)을 디스패치하는 중
+  private lineCountedUpstream = false;
+  // 지금 디스패치 중인 샘플이 도착한 시각 (epoch ms)
+  private sampleArrivedAt = 0;
+  private ecgWaveform: EcgRingBuffer = new EcgRingBuffer();
+  // 기기가 EHZ:로 알려 준 주파수가 있으면 도착 샘플 수로 추정하지 않는다
+  private ecgRateAnnounced = false;
+  private ecgRateEstimator: EcgRateEstimator = new EcgRateEstimator();
+  private qrs: QrsDetector = new QrsDetector(
+    ECG_DEFAULT_SAMPLE_RATE_HZ,
+    (beat) => this.handleBeat(beat)
+  );
+  // 기기 BPM:, 폰 검출 박동, 심박 벨트를 합쳐 onEcgSample로 내보낸다
+  private heartRateFusion: HeartRateFusion = new HeartRateFusion();
+  // 합치기 전에 소스마다 튀는 값(0, 255, 두 배/절반)을 거른다 (벨트는 자체 평균이 있어 창을 짧게)
+  private heartRateFilters: Record<HeartRateSourceKey, BpmFilter> = {
+    device: new BpmFilter(),
+    beat: new BpmFilter(),
+    strap: new BpmFilter({ window: 3 }),
+  };
+  private rawHeartRateListeners: Set<RawHeartRateListener> = new Set();
+  private heartRateListeners: Set<EcgListener> = new Set();
+  private beatListeners: Set<BeatListener> = new Set();
+  // 모든 송신은 이 큐 하나를 거친다 (같은 종류의 대기 명령은 최신 값만 전송)
+  private commands: CommandQueue;
+  // 명령 종류별 전송→ACK 왕복 시간
+  private commandLatency: Map<string, LatencyHistogram> = new Map();
+  private beltStopTime: LatencyHistogram = new LatencyHistogram();
+  // 벨트가 멈추기를 기다리는 STOP을 처음 누른 시각 (epoch ms)
+  private stopPressedAt: number | null = null;
+  // 지금 전송 중인 STOP (연타하면 이전 STOP을 누른 쪽도 이 결과를 기다린다)
+  private stopDelivery: Promise<void> | null = null;
+  // 링크가 끊긴 사이에 누른 STOP. 재연결 직후 설정값 재전송보다 먼저 보낸다
+  private pendingStop: {
+    promise: Promise<void>;
+    resolve: () => void;
+    reject: (error: unknown) => void;
+  } | null = null;
+  // STOP을 누를 때마다 증가. 그 전에 보낸 속도 명령이 늦게 끝나도 설정값으로 남기지 않는다
+  private stopGeneration = 0;
+  // ACK 모드가 아닐 때는 N: 에코로 T: 명령의 왕복 시간을 잰다
+  private targetEchoPending: { target: number; sentAt: number } | null = null;
+  // BLE 심박 벨트. 러닝머신 링크와 따로 연결/재연결한다
+  private heartRateSensor: HeartRateSensor;
+  private strapId: string | null = null;
+  private strapState: StrapState = "disconnected";
+  private strapStateListeners: Set<StrapStateListener> = new Set();
+  private strapReconnect: ReconnectSupervisor;
+  // 심박 추종 속도 제어. 자체 타이머로 돌고 명령은 송신 큐로 보낸다
+  private speedControl: SpeedController;
+  private speedControlListeners: Set<SpeedControlListener> = new Set();
+  // 사용자의 속도 → 심박 응답. 합친 심박과 벨트 속도로 맞추고 speedControl이 예측에 쓴다
+  private hrModel: HrResponseModel = new HrResponseModel();
+  private hrModelStore: HrModelStore;
+  // 지금 모델의 프로필 키 (setResponseModelProfile)
+  private hrModelKey: string | null = null;
+  // 기기가 마지막으로 보고한 벨트 속도 (없으면 NaN)
+  private beltSpeed = NaN;
+  // 인터벌 프로그램. 속도 구간은 직접 보내고 심박 구간은 speedControl에 맡긴다
+  private program: ProgramRunner;
+  private programListeners: Set<ProgramListener> = new Set();
+  private strapSink: HeartRateSensorSink = {
+    onMeasurement: (measurement, arrivedAtMs) =>
+      this.handleStrapMeasurement(measurement, arrivedAtMs),
+    onClosed: () => this.handleStrapLost(),
+  };
 
-  constructor() {}
+  constructor(options: ArduinoBridgeOptions = {}) {
+    this.options = options;
+    this.transport =
+      options.transport ??
+      (options.nativeIngest ? NativeIngestTransport.create() : null) ??
+      new ClassicTransport({ binary: options.binaryProtocol });
+    this.commands = new CommandQueue((data) => this.writeRaw(data), {
+      ackTimeoutMs: options.commandAcks ? COMMAND_ACK_TIMEOUT_MS : 0,
+      maxRetries: COMMAND_MAX_RETRIES,
+      onAcknowledged: (type, rttMs) => this.recordCommandLatency(type, rttMs),
+    });
+    const keepalive = (options.keepaliveIntervalMs ?? 0) > 0;
+    this.watchdog = new LinkWatchdog<LivenessStream>(
+      keepalive ? ["heartRate", "speed", "keepalive"] : ["heartRate", "speed"],
+      {
+        onStreamStale: (stream, stale) => {
+          if (stream !== "keepalive") this.notifyStale(stream, stale);
+        },
+        onLinkStall: (stalled) => this.handleLinkStall(stalled),
+      },
+      options.linkWatchdog
+    );
+    this.reconnect = new ReconnectSupervisor(() => this.reconnectOnce(), {
+      onAttempt: (attempt, delayMs) =>
+        log.info(
+          `Reconnect attempt ${attempt} (after ${Math.round(delayMs)} ms)`
+        ),
+      onRecovered: (attempts, elapsedMs) =>
+        this.handleReconnected(attempts, elapsedMs),
+      onGiveUp: (error) => {
+        log.warn("Giving up reconnect:", error);
+        this.rejectPendingStop(error);
+        this.setState("disconnected");
+      },
+    });
+    this.heartRateSensor = options.heartRateSensor ?? new BleHeartRateSensor();
+    this.strapReconnect = new ReconnectSupervisor(
+      () => this.reconnectStrapOnce(),
+      {
+        onRecovered: (attempts) => {
+          log.info(`Heart rate sensor reconnected after ${attempts} attempt(s)`);
+          this.setStrapState("connected");
+        },
+        onGiveUp: (error) => {
+          log.warn("Giving up heart rate sensor reconnect:", error);
+          this.strapId = null;
+          this.setStrapState("disconnected");
+        },
+      }
+    );
+    this.speedControl = new SpeedController(
+      {
+        heartRate: () => this.heartRateFusion.current(),
+        isConnected: () => this.state === "connected",
+        sendSpeed: (speed) => this.sendSpeed(speed),
+        responseModel: () => (this.hrModel.isReady ? this.hrModel : null),
+      },
+      options.speedControl
+    );
+    this.hrModelStore = options.hrModelStore ?? defaultHrModelStore;
+    this.speedControl.onStatusChange((status) =>
+      this.speedControlListeners.forEach((listener) => listener(status))
+    );
+    this.program = new ProgramRunner({
+      sendSpeed: (speed) => this.sendSpeed(speed),
+      trackBand: (band) =>
+        this.speedControl.start(band, this.confirmedSetpoints.speed ?? 0),
+      stopTracking: () => this.speedControl.stop(),
+      // ACK 모드가 아니면 write 완료까지라서 기기 처리 시간은 들어 있지 않다
+      commandLatencyMs: () =>
+        this.commandLatency.get("S")?.percentile(95) ?? NaN,
+    });
+    this.program.onStatusChange((status) =>
+      this.programListeners.forEach((listener) => listener(status))
+    );
+    this.attachInternalListeners();
+  }
 
   getState(): ArduinoConnectionState {
     return this.state;
   }
 
+  /** 연결 상태 변화 구독 (링크 끊김/자동 재연결 포함) */
+  onConnectionStateChange(listener: StateListener) {
+    this.stateListeners.add(listener);
+    return () => this.stateListeners.delete(listener);
+  }
+
+  /** 값 스트림이 예상 주기 안에 들어오지 않으면 stale=true, 다시 들어오면 false */
+  onStaleChange(listener: StaleListener) {
+    this.staleListeners.add(listener);
+    return () => this.staleListeners.delete(listener);
+  }
+
+  isStale(stream: WatchedStream): boolean {
+    return this.watchdog.isStale(stream);
+  }
+
+  private notifyStale(stream: WatchedStream, stale: boolean) {
+    log.warn(`${stream} ${stale ? "stale" : "resumed"}`);
+    this.staleListeners.forEach((listener) => listener(stream, stale));
+  }
+
+  private setState(state: ArduinoConnectionState) {
+    if (this.state === state) return;
+    this.state = state;
+    this.stateListeners.forEach((listener) => listener(state));
+  }
+
+  /** 현재 링크에서 사용 중인 프로토콜 */
+  getProtocol(): LinkProtocol {
+    return this.protocol;
+  }
+
+  getBinaryStats(): BinaryDecoderStats {
+    return this.decoder.getStats();
+  }
+
+  /** 수신 버퍼 오버플로우로 버려진 바이트/프레임 수 */
+  getFramerStats(): FramerStats {
+    return this.framer.getStats();
+  }
+
+  /**
+   * 원시 ECG 파형 링 버퍼. 샘플은 여기에 직접 쌓이고 React state를 거치지 않는다.
+   * 같은 객체가 계속 재사용되므로 한 번 받아 두고 읽으면 된다.
+   */
+  getEcgWaveform(): EcgRingBuffer {
+    return this.ecgWaveform;
+  }
+
+  /** 송신 큐 통계 (덮어쓴 명령 수, 실제 write 횟수 등) */
+  getCommandStats(): CommandQueueStats {
+    return this.commands.getStats();
+  }
+
+  /** 명령 종류(S, T, STOP …)별 전송→ACK 왕복 시간 p50/p95/p99 (ms) */
+  getCommandLatency(): Record<string, LatencySummary> {
+    const result: Record<string, LatencySummary> = {};
+    this.commandLatency.forEach((histogram, type) => {
+      result[type] = histogram.summary();
+    });
+    return result;
+  }
+
+  /** STOP을 누른 시점부터 기기가 속도 0을 보고하기까지 (벨트 감속 포함) */
+  getBeltStopTime(): LatencySummary {
+    return this.beltStopTime.summary();
+  }
+
+  private recordCommandLatency(type: string, rttMs: number) {
+    let histogram = this.commandLatency.get(type);
+    if (!histogram) {
+      histogram = new LatencyHistogram();
+      this.commandLatency.set(type, histogram);
+    }
+    histogram.record(rttMs);
+  }
+
+  /** 수신 파이프라인 카운터와 단계별 지연 (JS/네이티브/디코더 통계를 합친 값) */
+  getIngestMetrics(): IngestMetricsSnapshot {
+    const framer = this.framer.getStats();
+    const decoder = this.decoder.getStats();
+    const native = this.getNativeStats();
+    return this.metrics.snapshot({
+      frames: decoder.framesDecoded + (native?.frames ?? 0),
+      crcErrors: decoder.crcErrors + (native?.crcErrors ?? 0),
+      overflowBytes: framer.droppedBytes + (native?.droppedBytes ?? 0),
+      overflowFrames: framer.droppedFrames + (native?.droppedFrames ?? 0),
+      bytes: native?.bytes ?? 0,
+      chunks: native?.chunks ?? 0,
+      lines: native?.lines ?? 0,
+      parseFailures: native?.parseFailures ?? 0,
+      queueDrops: native?.queueDrops ?? 0,
+      textDrops: native?.textDrops ?? 0,
+    });
+  }
+
+  /** 지금 리스너에 전달 중인 샘플이 소켓에 도착한 시각 (epoch ms). 리스너 안에서만 의미 있다 */
+  getSampleArrivalTime(): number {
+    return this.sampleArrivedAt;
+  }
+
+  /**
+   * 지금 리스너에 전달 중인 샘플을 기기가 잰 시각 (앱 시계, epoch ms). 리스너 안에서만 의미 있다.
+   * 샘플에 @<기기 ms>가 있고 시계가 동기화되어 있으면 그 값, 아니면 도착 시각.
+   */
+  getSampleTime(): number {
+    const deviceTimeMs = this.telemetry.deviceTimeMs;
+    if (!Number.isNaN(deviceTimeMs) && this.clock.isSynced) {
+      return this.clock.toAppTime(deviceTimeMs);
+    }
+    return this.sampleArrivedAt;
+  }
+
+  /** 기기 시계 오프셋/드리프트 추정 상태 */
+  getClockSync(): ClockSyncStats {
+    return this.clock.stats();
+  }
+
+  /** 기기 측정 → 소켓 도착 (단방향 지연). 오차는 RTT 비대칭의 절반 이하 */
+  private recordOneWay(deviceTimeMs: number) {
+    if (Number.isNaN(deviceTimeMs) || !this.clock.isSynced) return;
+    this.metrics.recordOneWay(
+      this.sampleArrivedAt - this.clock.toAppTime(deviceTimeMs)
+    );
+  }
+
+  /** 도착 시각이 arrivedAtMs인 샘플이 React에 커밋됨 (WorkoutProvider에서 호출) */
+  recordCommit(arrivedAtMs: number) {
+    this.metrics.recordCommit(arrivedAtMs);
+  }
+
+  exportDiagnostics(): SessionDiagnostics {
+    return {
+      exportedAt: new Date().toISOString(),
+      state: this.state,
+      protocol: this.protocol,
+      ingest: this.getIngestMetrics(),
+      commands: this.commands.getStats(),
+      commandLatency: this.getCommandLatency(),
+      beltStop: this.beltStopTime.summary(),
+      native: this.getNativeStats(),
+      clock: this.clock.stats(),
+      heartRateSources: this.heartRateFusion.sourceStats(),
+      heartRateFilters: {
+        device: this.heartRateFilters.device.getStats(),
+        beat: this.heartRateFilters.beat.getStats(),
+        strap: this.heartRateFilters.strap.getStats(),
+      },
+      speedControl: this.speedControl.getStats(),
+      hrModel: this.hrModel.getStats(),
+      program: this.program.getStats(),
+      traffic: this.traffic.dump(),
+    };
+  }
+
+  /** 최근 원시 송수신 청크 기록. 현장 디버깅 시 dump()로 꺼낸다 */
+  getTrafficLog(): TrafficLog {
+    return this.traffic;
+  }
+
+  /**
+   * 받은 원시 청크를 타임스탬프/청크 경계와 함께 캡처하기 시작한다 (ReplayTransport로 재생).
+   * 네이티브 인제스트는 소켓 바이트가 JS로 오지 않으므로 텍스트 줄만 잡힌다.
+   */
+  startCapture() {
+    this.capture = new CaptureRecorder();
+  }
+
+  /** 캡처를 끝내고 캡처 파일 바이트를 돌려준다. 캡처 중이 아니었으면 null */
+  stopCapture(): Uint8Array | null {
+    const capture = this.capture;
+    this.capture = null;
+    if (!capture) return null;
+    if (capture.truncated > 0) {
+      log.warn(`Capture full, ${capture.truncated} chunk(s) not recorded`);
+    }
+    return capture.toBytes();
+  }
+
+  /** 네이티브 인제스트를 쓰는 중이면 그 통계 */
+  getNativeStats(): NativeIngestStats | null {
+    return this.transport.ingestStats?.() ?? null;
+  }
+
+  /** 사용 중인 링크 구현 이름 (classic, native, loopback, tcp, pty) */
+  getTransportKind(): string {
+    return this.transport.kind;
+  }
+
   async getBondedDevices(): Promise<BluetoothDevice[]> {
-    const devices = await RNBluetoothClassic.getBondedDevices();
+    const devices = await ClassicTransport.getBondedDevices();
     return devices;
   }
 
@@ -54,201 +615,826 @@ export class ArduinoBridge {
     durationMs: number = 10000
   ): Promise<void> {
     try {
-      const bonded = await RNBluetoothClassic.getBondedDevices();
+      const bonded = await ClassicTransport.getBondedDevices();
       bonded.forEach((dev) => {
         onDeviceFound(dev);
       });
     } catch (e) {
-      console.error("[BT] Scan error:", e);
+      log.error("Scan error:", e);
       throw e;
     }
   }
 
-  async connect(deviceId: string): Promise<void> {
-    // 이미 연결되어 있으면 먼저 연결 해제
-    if (this.device && this.state === "connected") {
-      console.log("[BT] Already connected, disconnecting first...");
-      await this.disconnect();
-    }
+  getStrapState(): StrapState {
+    return this.strapState;
+  }
 
-    this.state = "connecting";
-    this.receiveBuffer = "";
+  /** 심박 벨트 연결 상태 변화 구독 */
+  onStrapStateChange(listener: StrapStateListener) {
+    this.strapStateListeners.add(listener);
+    return () => this.strapStateListeners.delete(listener);
+  }
 
-    // 타임아웃 설정
-    const connectWithTimeout = async () => {
-      const timeoutPromise = new Promise<never>((_, reject) => {
-        setTimeout(() => {
-          reject(new Error("Connection timeout after 15 seconds"));
-        }, 15000);
-      });
+  private setStrapState(state: StrapState) {
+    if (this.strapState === state) return;
+    this.strapState = state;
+    this.strapStateListeners.forEach((listener) => listener(state));
+  }
 
-      const connectPromise = RNBluetoothClassic.connectToDevice(deviceId);
-      return Promise.race([connectPromise, timeoutPromise]);
-    };
+  /** 심박 서비스(0x180D)를 광고하는 BLE 벨트를 찾는다 */
+  scanHeartRateStraps(
+    onFound: (sensor: HeartRateSensorInfo) => void,
+    durationMs: number = 10000
+  ): Promise<void> {
+    return this.heartRateSensor.scan(onFound, durationMs);
+  }
+
+  /**
+   * 심박 벨트를 연결한다. 러닝머신 연결과 무관하게 붙였다 뗄 수 있고,
+   * 측정값은 onEcgSample로, RR 간격은 rr 텔레메트리 채널로 나간다.
+   */
+  async connectHeartRateStrap(deviceId: string): Promise<void> {
+    this.strapReconnect.cancel();
+    if (this.heartRateSensor.isOpen) {
+      await this.heartRateSensor.close().catch(() => undefined);
+    }
 
+    this.setStrapState("connecting");
+    this.heartRateFilters.strap.reset();
     try {
-      console.log(`[BT] Connecting to device: ${deviceId}`);
-      
-      const device = await connectWithTimeout();
-      
-      // 연결 상태 확인
-      const isConnected = await device.isConnected();
-      if (!isConnected) {
-        throw new Error("Device connected but not responding");
-      }
-      
-      this.device = device;
-      this.state = "connected";
-      
-      console.log(`[BT] Successfully connected to: ${device.name || deviceId}`);
-
-      // 데이터 수신 리스너 등록
-      this.dataSubscription = device.onDataReceived((event) => {
-        const raw = (event.data ?? "").toString();
-        console.log("[BT] Received raw:", raw);
-        this.receiveBuffer += raw;
-        this.processBuffer();
-      });
+      await this.heartRateSensor.open(
+        deviceId,
+        this.strapSink,
+        STRAP_CONNECT_TIMEOUT_MS
+      );
+    } catch (error) {
+      log.error("Heart rate sensor connection failed:", error);
+      this.strapId = null;
+      this.setStrapState("disconnected");
+      throw error;
+    }
+    this.strapId = deviceId;
+    this.setStrapState("connected");
+  }
 
-      // HC-06 초기화 메시지 전송
+  async disconnectHeartRateStrap(): Promise<void> {
+    this.strapReconnect.cancel();
+    this.strapId = null;
+    if (this.heartRateSensor.isOpen) {
       try {
-        await this.device.write("READY\n");
-        console.log("[BT] Sent initialization message");
+        await this.heartRateSensor.close();
       } catch (e) {
-        console.warn("[BT] Could not send init message:", e);
+        log.info("Heart rate sensor disconnect error:", e);
       }
-      
+    }
+    this.setStrapState("disconnected");
+  }
+
+  private handleStrapLost() {
+    if (!this.strapId || this.strapState !== "connected") return;
+    log.warn("Heart rate sensor lost, reconnecting");
+    this.setStrapState("reconnecting");
+    this.strapReconnect.start();
+  }
+
+  private async reconnectStrapOnce() {
+    const strapId = this.strapId;
+    if (!strapId) throw new Error("No heart rate sensor to reconnect to");
+    await this.heartRateSensor.open(
+      strapId,
+      this.strapSink,
+      RECONNECT_ATTEMPT_TIMEOUT_MS
+    );
+    if (!this.strapReconnect.active) {
+      await this.heartRateSensor.close();
+    }
+  }
+
+  /** 벨트 측정값 하나. 접촉이 떨어졌다고 알리는 값은 버린다 (벨트가 0이나 마지막 값을 보낸다) */
+  private handleStrapMeasurement(
+    measurement: HeartRateMeasurement,
+    arrivedAtMs: number
+  ) {
+    if (measurement.contact === false) return;
+
+    this.sampleArrivedAt = arrivedAtMs;
+    for (let i = 0; i < measurement.rrMs.length; i++) {
+      this.telemetry.emit("rr", measurement.rrMs[i]);
+    }
+    // 링크 감시는 러닝머신 링크만 본다 (벨트가 살아 있다고 멈춘 링크를 놓치면 안 된다)
+    this.fuseHeartRate("strap", measurement.bpm, arrivedAtMs);
+  }
+
+  async connect(deviceId: string): Promise<void> {
+    // 수동 연결이 시작되면 진행 중인 자동 재연결은 멈춘다
+    this.reconnect.cancel();
+
+    // 이미 연결되어 있으면 먼저 연결 해제
+    if (this.state === "connected" || this.state === "stalled") {
+      log.info("Already connected, disconnecting first...");
+      await this.disconnect();
+    }
+
+    this.setState("connecting");
+    // 새 세션: 계측과 송수신 기록을 비운다 (자동 재연결은 같은 세션)
+    this.metrics.reset();
+    this.traffic.clear();
+    this.heartRateFusion.reset();
+    this.heartRateFilters.device.reset();
+    this.heartRateFilters.beat.reset();
+    // 같은 프로필이면 지난 세션에서 맞춘 값으로 시작한다
+    this.saveResponseModel();
+    this.hrModel.reset(true);
+    this.beltSpeed = NaN;
+    try {
+      await this.openLink(deviceId, CONNECT_TIMEOUT_MS);
     } catch (error) {
-      console.error("[BT] Connection failed:", error);
-      this.state = "disconnected";
-      this.device = null;
-      this.receiveBuffer = "";
+      this.rejectPendingStop(error);
+      this.setState("disconnected");
       throw error;
     }
+    this.deviceId = deviceId;
+    this.setState("connected");
+    this.startLiveness();
+    this.flushPendingStop();
   }
 
-  async disconnect(): Promise<void> {
-    console.log("[BT] Disconnecting...");
-    
-    if (this.dataSubscription) {
-      this.dataSubscription.remove();
-      this.dataSubscription = null;
+  /** 트랜스포트를 열고 핸드셰이크까지 보낸다. 끊김은 sink.onClosed로 들어온다. 실패하면 정리 후 throw */
+  private async openLink(deviceId: string, timeoutMs: number) {
+    this.resetIngest();
+
+    try {
+      log.info(`Connecting to device (${this.transport.kind}): ${deviceId}`);
+      await this.transport.open(deviceId, this.sink, timeoutMs);
+      await this.sendHandshake();
+    } catch (error) {
+      log.error("Connection failed:", error);
+      this.transport.close().catch(() => undefined);
+      this.resetIngest();
+      throw error;
+    }
+  }
+
+  /**
+   * OS가 연결 끊김을 알리거나 링크가 오래 멈추면 링크를 정리하고 같은 기기 id로 자동 재연결을 시작한다.
+   * 재연결을 포기하면 그때 disconnected가 된다.
+   */
+  private handleLinkLost() {
+    if (this.state !== "connected" && this.state !== "stalled") return;
+
+    // 멈춘 링크는 소켓이 아직 열려 있을 수 있으므로 닫아 둔다 (결과는 기다리지 않음)
+    this.stopLiveness();
+    this.transport.close().catch(() => undefined);
+    this.commands.clear(new Error("Device disconnected"));
+    this.resetIngest();
+
+    if (!this.deviceId) {
+      this.setState("disconnected");
+      return;
+    }
+    log.warn("Link lost, reconnecting to", this.deviceId);
+    this.setState("reconnecting");
+    this.reconnect.start();
+  }
+
+  private async reconnectOnce() {
+    const deviceId = this.deviceId;
+    if (!deviceId) throw new Error("No device to reconnect to");
+    await this.openLink(deviceId, RECONNECT_ATTEMPT_TIMEOUT_MS);
+
+    // 시도 중에 사용자가 연결을 끊었으면 방금 연 링크를 닫는다
+    if (!this.reconnect.active) {
+      await this.closeLink();
     }
+  }
+
+  private handleReconnected(attempts: number, elapsedMs: number) {
+    log.info(
+      `Reconnected after ${attempts} attempt(s), ${Math.round(elapsedMs)} ms`
+    );
+    this.setState("connected");
+    this.startLiveness();
+    // 끊긴 사이에 누른 STOP이 설정값 재전송보다 먼저 나간다
+    this.flushPendingStop();
+    this.replaySetpoints();
+  }
 
-    if (this.device) {
+  /** 재연결 후 마지막으로 확인된 목표 심박과 속도를 다시 보낸다 */
+  private replaySetpoints() {
+    const { target, speed } = this.confirmedSetpoints;
+    if (target !== null) {
+      this.sendTargetHeartRate(target).catch((e) =>
+        log.warn("Could not replay target HR:", e)
+      );
+    }
+    if (this.program.isRunning) {
+      // 끊긴 사이에 구간이 바뀌었을 수 있으므로 마지막 확인 값이 아니라 지금 구간 목표를 보낸다
+      this.program.restage();
+    } else if (speed !== null) {
+      this.sendSpeed(speed).catch((e) =>
+        log.warn("Could not replay speed:", e)
+      );
+    }
+  }
+
+  private startLiveness() {
+    this.watchdog.start();
+    if (!this.pingTimer) this.schedulePing();
+  }
+
+  /** keepalive와 시계 동기화가 같은 PING을 쓴다. 간격은 둘 중 짧은 쪽 */
+  private schedulePing() {
+    const keepalive = this.options.keepaliveIntervalMs ?? 0;
+    const clockSync = this.options.clockSyncIntervalMs ?? 0;
+    let interval = Math.min(keepalive || Infinity, clockSync || Infinity);
+    if (interval === Infinity) return;
+    if (clockSync > 0 && this.clock.stats().exchanges < CLOCK_SYNC_BURST) {
+      interval = Math.min(interval, CLOCK_SYNC_BURST_INTERVAL_MS);
+    }
+    this.pingTimer = setTimeout(() => {
+      this.pingTimer = null;
+      this.sendPing();
+      this.schedulePing();
+    }, interval);
+  }
+
+  private stopLiveness() {
+    this.watchdog.stop();
+    if (this.pingTimer) {
+      clearTimeout(this.pingTimer);
+      this.pingTimer = null;
+    }
+    if (this.stallTimer) {
+      clearTimeout(this.stallTimer);
+      this.stallTimer = null;
+    }
+  }
+
+  private sendPing() {
+    this.pingSeq = (this.pingSeq + 1) % 1000;
+    const now = Date.now();
+    this.pendingPings.forEach((sentAt, seq) => {
+      if (now - sentAt > PING_EXPIRY_MS) this.pendingPings.delete(seq);
+    });
+    this.pendingPings.set(this.pingSeq, now);
+    this.writeRaw(`PING:${this.pingSeq}\n`).catch((e) =>
+      log.warn("Keepalive write failed:", e)
+    );
+  }
+
+  private handlePong(seq: number) {
+    this.watchdog.feed("keepalive");
+    const sentAt = this.pendingPings.get(seq);
+    if (sentAt === undefined) return;
+    this.pendingPings.delete(seq);
+    const deviceTimeMs = this.telemetry.deviceTimeMs;
+    if (!Number.isNaN(deviceTimeMs)) {
+      // 받은 시각은 처리 시각이 아니라 PONG 줄의 도착 시각 (네이티브 경로는 drain 주기만큼 이르다)
+      this.clock.addExchange(sentAt, this.sampleArrivedAt, deviceTimeMs);
+    }
+  }
+
+  /**
+   * 감시 중인 스트림이 모두 멈추면 stalled, 다시 들어오면 connected.
+   * stalled가 STALL_RECONNECT_MS 이상 이어지면 링크 끊김으로 처리해서 재연결한다.
+   */
+  private handleLinkStall(stalled: boolean) {
+    if (stalled && this.state === "connected") {
+      log.warn("Link stalled");
+      this.setState("stalled");
+      this.stallTimer = setTimeout(() => {
+        this.stallTimer = null;
+        log.warn("Link stalled too long, reconnecting");
+        this.handleLinkLost();
+      }, STALL_RECONNECT_MS);
+    } else if (!stalled && this.state === "stalled") {
+      log.info("Link resumed");
+      if (this.stallTimer) {
+        clearTimeout(this.stallTimer);
+        this.stallTimer = null;
+      }
+      this.setState("connected");
+    }
+  }
+
+  // HC-06 초기화 메시지 전송
+  private async sendHandshake() {
+    try {
+      await this.writeRaw("READY\n");
+      log.info("Sent initialization message");
+
+      if (this.options.binaryProtocol) {
+        await this.requestBinaryProtocol();
+      }
+    } catch (e) {
+      log.warn("Could not send init message:", e);
+    }
+  }
+
+  async disconnect(): Promise<void> {
+    log.info("Disconnecting...");
+    this.reconnect.cancel();
+    this.program.stop();
+    this.speedControl.stop();
+    this.saveResponseModel();
+    this.deviceId = null;
+    this.confirmedSetpoints = { target: null, speed: null };
+    this.stopPressedAt = null;
+    this.rejectPendingStop(new Error("Disconnected before STOP was sent"));
+    await this.closeLink();
+    this.setState("disconnected");
+  }
+
+  private async closeLink() {
+    this.stopLiveness();
+    this.commands.clear(new Error("Device disconnected"));
+
+    if (this.transport.isOpen) {
       try {
-        await this.device.disconnect();
-        console.log("[BT] Disconnected successfully");
+        await this.transport.close();
+        log.info("Disconnected successfully");
       } catch (e) {
-        console.log("[BT] Disconnect error (may be already disconnected):", e);
+        log.info("Disconnect error (may be already disconnected):", e);
       }
-      this.device = null;
     }
 
-    this.state = "disconnected";
-    this.receiveBuffer = "";
+    this.resetIngest();
+  }
+
+  private async writeRaw(data: string): Promise<void> {
+    if (!this.transport.isOpen) {
+      throw new Error("Device not connected");
+    }
+    this.traffic.record("tx", data);
+    await this.transport.write(data);
   }
 
   private async sendCommand(command: string): Promise<void> {
-    if (!this.device) {
+    if (!this.transport.isOpen) {
       throw new Error("Device not connected");
     }
-    
-    console.log(`[BT] Sending command: ${command}`);
-    await this.device.write(command + "\n");
+
+    log.info(`Sending command: ${command}`);
+    await this.commands.enqueue(command);
   }
 
   async sendTargetHeartRate(target: number): Promise<void> {
+    if (!this.options.commandAcks) {
+      this.targetEchoPending = { target, sentAt: Date.now() };
+    }
     await this.sendCommand(`T:${target}`);
+    this.confirmedSetpoints.target = target;
   }
 
+  /**
+   * 비상 정지. 송신 큐를 건너뛰어 바로 쓰고, 대기 중인 속도 명령은 취소한다.
+   * ACK 모드에서는 ACK가 올 때까지 STOP_RESEND_INTERVAL_MS마다 다시 보내고, 아니면 write가 끝나면 완료된다.
+   * 누른 시점부터 ACK(또는 write 완료)까지는 getCommandLatency().STOP에,
+   * 벨트가 실제로 멈춘 것(SPD:0)까지는 getBeltStopTime()에 따로 기록된다.
+   *
+   * 프로그램/속도 제어를 끄고 재전송할 속도를 0으로 만드는 것은 링크 상태와 무관하게 먼저 한다.
+   * 재연결 중이면 STOP을 걸어 두고, 재연결 직후 설정값 재전송보다 먼저 보낸 뒤 resolve된다.
+   */
   async sendEmergencyStop(): Promise<void> {
-    await this.sendCommand("STOP");
+    this.program.stop();
+    this.speedControl.stop();
+    this.confirmedSetpoints.speed = 0;
+    this.stopGeneration++;
+    if (this.stopPressedAt === null) this.stopPressedAt = Date.now();
+
+    if (this.state === "reconnecting") {
+      log.warn("Link down, STOP will be sent on reconnect");
+      return this.latchStop();
+    }
+    if (!this.transport.isOpen) {
+      throw new Error("Device not connected");
+    }
+    return this.deliverStop();
+  }
+
+  private deliverStop(): Promise<void> {
+    log.info("Sending command: STOP (priority)");
+    const delivery: Promise<void> = this.commands
+      .sendUrgent("STOP", {
+        cancel: ["S"],
+        resendIntervalMs: STOP_RESEND_INTERVAL_MS,
+        maxDurationMs: STOP_MAX_DURATION_MS,
+      })
+      .catch((error) => {
+        // 연타로 새 STOP이 이 STOP을 대체했으면 그 결과를 따른다
+        if (
+          error instanceof CommandCancelledError &&
+          this.stopDelivery &&
+          this.stopDelivery !== delivery
+        ) {
+          return this.stopDelivery;
+        }
+        // 확인 전에 링크가 끊겼으면 재연결 후 다시 보낸다
+        if (this.state === "reconnecting") return this.latchStop();
+        throw error;
+      })
+      .finally(() => {
+        if (this.stopDelivery === delivery) this.stopDelivery = null;
+      });
+    this.stopDelivery = delivery;
+    return delivery;
+  }
+
+  private latchStop(): Promise<void> {
+    if (!this.pendingStop) {
+      let resolve: () => void = () => undefined;
+      let reject: (error: unknown) => void = () => undefined;
+      const promise = new Promise<void>((res, rej) => {
+        resolve = res;
+        reject = rej;
+      });
+      this.pendingStop = { promise, resolve, reject };
+    }
+    return this.pendingStop.promise;
+  }
+
+  private flushPendingStop() {
+    const pending = this.pendingStop;
+    if (!pending) return;
+    this.pendingStop = null;
+    this.deliverStop().then(pending.resolve, pending.reject);
   }
 
+  private rejectPendingStop(error: unknown) {
+    const pending = this.pendingStop;
+    if (!pending) return;
+    this.pendingStop = null;
+    pending.reject(error);
+  }
+
+  /** 수동 속도 변경. 프로그램이나 속도 제어가 돌고 있으면 끈다 (사용자 입력이 우선) */
   async setSpeed(targetSpeed: number): Promise<void> {
+    if (this.program.isRunning) {
+      log.info("Manual speed change, stopping program");
+      this.program.stop();
+    }
+    if (this.speedControl.isActive) {
+      log.info("Manual speed change, stopping speed control");
+      this.speedControl.stop();
+    }
+    await this.sendSpeed(targetSpeed);
+  }
+
+  private async sendSpeed(targetSpeed: number): Promise<void> {
     const safe = Math.max(0, parseFloat(targetSpeed.toFixed(1)));
+    // 멈추기 전에 다시 출발하면 정지 시간은 재지 않는다
+    if (safe > 0) this.stopPressedAt = null;
+    const stops = this.stopGeneration;
     await this.sendCommand(`S:${safe.toFixed(1)}`);
+    // 전송 중에 STOP을 눌렀으면 재연결 때 이 속도를 다시 보내면 안 된다
+    if (stops === this.stopGeneration) this.confirmedSetpoints.speed = safe;
+  }
+
+  /**
+   * 합친 심박수가 band 안에 머물도록 속도를 자동으로 조절한다 (이미 켜져 있으면 구간만 바꾼다).
+   * 마지막으로 보낸 속도에서 이어받는다. 수동 속도 변경, 비상 정지, 연결 해제로 꺼진다.
+   */
+  startSpeedControl(band: HeartRateBand) {
+    this.speedControl.start(band, this.confirmedSetpoints.speed ?? 0);
   }
 
-  private processBuffer() {
-    // HC-06은 \r 또는 \r\n 또는 \\r로 끝날 수 있으므로 모두 처리
-    this.receiveBuffer = this.receiveBuffer.replace(/\r\n/g, "\n");
-    this.receiveBuffer = this.receiveBuffer.replace(/\r/g, "\n");
-    this.receiveBuffer = this.receiveBuffer.replace(/\\r/g, "\n");
+  stopSpeedControl() {
+    this.speedControl.stop();
+  }
 
-    let newlineIndex;
-    while ((newlineIndex = this.receiveBuffer.indexOf("\n")) !== -1) {
-      const line = this.receiveBuffer.substring(0, newlineIndex).trim();
-      this.receiveBuffer = this.receiveBuffer.substring(newlineIndex + 1);
+  getSpeedControlStatus(): SpeedControlStatus {
+    return this.speedControl.getStatus();
+  }
 
-      if (line.length > 0) {
-        this.parseLine(line);
-      }
+  onSpeedControlChange(listener: SpeedControlListener) {
+    this.speedControlListeners.add(listener);
+    return () => this.speedControlListeners.delete(listener);
+  }
+
+  /**
+   * 인터벌 프로그램을 컴파일해서 시작한다 (돌고 있던 것은 멈춘다). 잘못된 구간이 있으면 throw.
+   * 수동 속도 변경, 비상 정지, 연결 해제로 멈춘다.
+   */
+  startProgram(program: WorkoutProgram) {
+    if (this.state !== "connected") {
+      throw new Error("Device not connected");
     }
-    
+    this.program.start(compileProgram(program));
+  }
+
+  stopProgram() {
+    if (!this.program.isRunning) return;
+    this.program.stop();
+    this.speedControl.stop();
+  }
+
+  getProgramStatus(): ProgramStatus {
+    return this.program.getStatus();
+  }
+
+  onProgramChange(listener: ProgramListener) {
+    this.programListeners.add(listener);
+    return () => this.programListeners.delete(listener);
+  }
 
-    // 버퍼 폭주 방지
-    if (this.receiveBuffer.length > 500) {
-      console.warn("[BT] Buffer overflow, clearing");
-      this.receiveBuffer = "";
+  /**
+   * 심박 응답 모델의 주인(프로필)을 정한다. 이전 프로필에서 이번 세션에 맞춘 값은 저장하고,
+   * 새 프로필의 저장된 값이 있으면 그것으로 시작한다 (없으면 PI로 조절하면서 새로 배운다).
+   */
+  async setResponseModelProfile(key: string): Promise<void> {
+    if (key === this.hrModelKey) return;
+    this.saveResponseModel();
+    this.hrModel.reset(false);
+    this.hrModelKey = key;
+    try {
+      const params = await this.hrModelStore.load(key);
+      // 불러오는 사이에 프로필이 또 바뀌었으면 버린다
+      if (params && this.hrModelKey === key) this.hrModel.warmStart(params);
+    } catch (e) {
+      log.warn("Could not load HR model:", e);
     }
   }
 
-  private parseLine(line: string) {
-    console.log("[BT] Parsing line:", line);
+  getResponseModelStats(): HrModelStats {
+    return this.hrModel.getStats();
+  }
+
+  /** 이번 세션에서 맞춘 값이 있을 때만 저장한다 (저장된 값을 그대로 다시 쓰지 않는다) */
+  private saveResponseModel() {
+    const { source, params } = this.hrModel.getStats();
+    if (!this.hrModelKey || source !== "session" || !params) return;
+    this.hrModelStore
+      .save(this.hrModelKey, params)
+      .catch((e) => log.warn("Could not save HR model:", e));
+  }
+
+  private ingestText(chunk: string, arrivedAtMs: number) {
+    this.traffic.record("rx", chunk, arrivedAtMs);
+    this.capture?.recordText(chunk);
+    ingestLog.debug(() => `Received raw: ${JSON.stringify(chunk)}`);
+    this.sampleArrivedAt = arrivedAtMs;
+    this.metrics.recordChunk(chunk.length);
+    this.framer.pushString(chunk);
+  }
 
-    if (line.startsWith("BPM:")) {
-      const value = parseInt(line.substring(4).trim(), 10);
-      if (!isNaN(value)) {
-        this.notifyEcgListeners(value);
+  private ingestBytes(chunk: Uint8Array, arrivedAtMs: number) {
+    this.traffic.recordBytes("rx", chunk, arrivedAtMs);
+    this.capture?.recordBytes(chunk);
+    ingestLog.debug(() => `Received ${chunk.length} bytes`);
+    this.sampleArrivedAt = arrivedAtMs;
+    this.metrics.recordChunk(chunk.length);
+    if (this.protocol === "binary") {
+      this.decoder.pushBytes(chunk);
+    } else if (this.negotiationTimer) {
+      // 협상 중: BIN:<v> 응답 줄이 끝나는 바로 다음 바이트부터 프레임으로 온다
+      for (let i = 0; i < chunk.length; i++) {
+        if (this.protocol === "binary") this.decoder.pushByte(chunk[i]);
+        else this.framer.pushByte(chunk[i]);
       }
-      return;
+    } else {
+      this.framer.pushBytes(chunk);
     }
+  }
 
-    if (line.startsWith("SPD:")) {
-      const value = parseFloat(line.substring(4).trim());
-      if (!isNaN(value)) {
-        this.notifySpeedListeners(value);
-      }
-      return;
+  /** 네이티브 경로에서 넘어온 줄은 네이티브 통계에 이미 세어져 있다 */
+  private ingestLine(line: string, arrivedAtMs: number) {
+    this.traffic.record("rx", line, arrivedAtMs);
+    this.capture?.recordText(line + "\n");
+    this.sampleArrivedAt = arrivedAtMs;
+    this.lineCountedUpstream = true;
+    this.framer.pushString(line + "\n");
+    this.lineCountedUpstream = false;
+  }
+
+  private resetIngest() {
+    // 기기가 리셋됐을 수 있으므로 시계 동기화도 처음부터
+    this.clock.reset();
+    this.pendingPings.clear();
+    this.ecgWaveform.clear();
+    this.ecgRateAnnounced = false;
+    this.ecgRateEstimator.reset();
+    this.qrs.reset(this.ecgWaveform.totalWritten);
+    this.targetEchoPending = null;
+    this.framer.reset();
+    this.decoder.reset();
+    this.protocol = "text";
+    if (this.negotiationTimer) {
+      clearTimeout(this.negotiationTimer);
+      this.negotiationTimer = null;
+      this.transport.setBinaryNegotiation?.(false);
     }
+  }
 
-    if (line.startsWith("N:")) {
-      console.log("[BT] Received Target N:", line.substring(2).trim());
-      return;
+  /**
+   * READY 직후 BIN:<version>을 보낸다. 기기가 제한 시간 안에 같은 BIN:<version>으로 응답해야
+   * 바이너리 디코더를 켠다. 응답이 없으면 BIN:0을 보내 (늦게 전환한 기기도) 텍스트로 되돌리고,
+   * 그 뒤에 오는 BIN:<version> 응답은 무시한다. 네이티브 인제스트도 같은 창 안에서만 전환하도록
+   * 창을 열고 닫을 때 transport.setBinaryNegotiation으로 알린다.
+   */
+  private async requestBinaryProtocol() {
+    this.transport.setBinaryNegotiation?.(true);
+    this.negotiationTimer = setTimeout(() => {
+      this.negotiationTimer = null;
+      this.transport.setBinaryNegotiation?.(false);
+      if (this.protocol === "binary") return;
+      log.info("No binary protocol ack, falling back to text protocol");
+      this.sendCommand("BIN:0").catch((e) =>
+        log.warn("Could not request text protocol:", e)
+      );
+    }, PROTOCOL_NEGOTIATION_TIMEOUT_MS);
+
+    await this.sendCommand(`BIN:${BINARY_PROTOCOL_VERSION}`);
+  }
+
+  private parseLine(line: LineView) {
+    ingestLog.debug(() => `Parsing line: ${line.toString()}`);
+    if (!this.lineCountedUpstream) this.metrics.counters.lines++;
+
+    const startedAt = monotonicNow();
+    const result = this.telemetry.dispatch(line);
+    this.metrics.recordFanOut(startedAt);
+    if (result === "ok") this.recordOneWay(this.telemetry.deviceTimeMs);
+
+    if (result === "invalid") {
+      this.metrics.counters.parseFailures++;
+    } else if (result === "unknown") {
+      this.metrics.counters.unknownLines++;
+      log.debug(() => `Unknown message: ${line.toString()}`);
     }
+  }
 
-    console.log("[BT] Unknown message:", line);
+  /** ECG 스트림의 샘플링 주파수가 바뀌면 파형 버퍼와 QRS 검출기를 그 주파수로 다시 만든다 */
+  private setEcgSampleRate(hz: number) {
+    if (hz === this.ecgWaveform.sampleRateHz) return;
+    log.info(
+      `ECG sample rate ${this.ecgWaveform.sampleRateHz} Hz -> ${hz} Hz` +
+        (this.ecgRateAnnounced ? "" : " (measured)")
+    );
+    this.ecgWaveform.setSampleRate(hz);
+    // 필터 계수/창/불응기가 모두 주파수에 묶여 있으므로 검출기를 새로 만든다.
+    // 잘못된 주파수로 잰 박동(RR이 배/절반)은 필터에서도 비운다
+    this.qrs = new QrsDetector(hz, (beat) => this.handleBeat(beat));
+    this.qrs.reset(this.ecgWaveform.totalWritten);
+    this.heartRateFilters.beat.reset();
   }
 
+  private attachInternalListeners() {
+    this.telemetry.on("ecg", (value) => {
+      if (!this.ecgRateAnnounced) {
+        const hz = this.ecgRateEstimator.push(this.sampleArrivedAt);
+        if (!Number.isNaN(hz)) this.setEcgSampleRate(hz);
+      }
+      this.ecgWaveform.push(value);
+      this.qrs.push(value);
+    });
+
+    this.telemetry.on("ecgRate", (hz) => {
+      if (hz <= 0 || hz > MAX_ECG_SAMPLE_RATE_HZ) {
+        log.warn("Ignoring invalid ECG sample rate:", hz);
+        return;
+      }
+      this.ecgRateAnnounced = true;
+      this.setEcgSampleRate(hz);
+    });
+
+    this.telemetry.on("bpm", (bpm) => {
+      this.watchdog.feed("heartRate");
+      this.fuseHeartRate("device", bpm, this.getSampleTime());
+    });
+
+    this.telemetry.on("targetEcho", (target) => {
+      log.info("Received Target N:", target);
+      const pending = this.targetEchoPending;
+      if (pending && pending.target === target) {
+        this.recordCommandLatency("T", Date.now() - pending.sentAt);
+        this.targetEchoPending = null;
+      }
+    });
+
+    this.telemetry.on("ack", (seq) =>
+      this.commands.acknowledge(seq, this.sampleArrivedAt)
+    );
+
+    this.telemetry.on("pong", (seq) => this.handlePong(seq));
+
+    this.telemetry.on("speed", (speed) => {
+      this.watchdog.feed("speed");
+      this.beltSpeed = speed;
+      if (speed <= 0 && this.stopPressedAt !== null) {
+        this.beltStopTime.record(this.sampleArrivedAt - this.stopPressedAt);
+        this.stopPressedAt = null;
+      }
+    });
+
+    this.telemetry.on("protocol", (version) => {
+      if (version === 0 && this.protocol === "binary") {
+        log.warn("Device switched back to text protocol");
+        this.protocol = "text";
+        this.decoder.reset();
+        return;
+      }
+      // 협상 창 밖의 응답(시간 초과 뒤 늦게 온 것)은 받지 않는다
+      if (!this.negotiationTimer || version !== BINARY_PROTOCOL_VERSION) {
+        return;
+      }
+      this.protocol = "binary";
+      if (this.negotiationTimer) {
+        clearTimeout(this.negotiationTimer);
+        this.negotiationTimer = null;
+      }
+      this.transport.setBinaryNegotiation?.(false);
+      log.info("Binary protocol negotiated:", version);
+    });
+  }
+
+  /**
+   * 심박수 스트림. 기기의 평균 BPM:, 폰에서 검출한 박동, 심박 벨트 중 들어오는 것을
+   * 시간 정렬해서 합친 값(HeartRateFusion)으로, 어느 소스든 측정이 합쳐질 때마다 호출된다.
+   */
   onEcgSample(listener: EcgListener) {
-    this.ecgListeners.add(listener);
-    return () => this.ecgListeners.delete(listener);
+    this.heartRateListeners.add(listener);
+    return () => this.heartRateListeners.delete(listener);
+  }
+
+  /** 합친 심박 추정 (기울기, 불확실성 포함). 아직 측정이 없으면 null */
+  getHeartRateEstimate(): HeartRateEstimate | null {
+    return this.heartRateFusion.current();
+  }
+
+  /** 거르기 전의 소스별 원시 BPM (버려지는 값 포함). 걸러서 합친 값은 onEcgSample */
+  onRawHeartRate(listener: RawHeartRateListener) {
+    this.rawHeartRateListeners.add(listener);
+    return () => this.rawHeartRateListeners.delete(listener);
+  }
+
+  /** 폰에서 검출한 R 피크마다 RR 간격과 순간 BPM */
+  onBeat(listener: BeatListener) {
+    this.beatListeners.add(listener);
+    return () => this.beatListeners.delete(listener);
   }
 
   onSpeed(listener: SpeedListener) {
-    this.speedListeners.add(listener);
-    return () => this.speedListeners.delete(listener);
+    return this.telemetry.on("speed", listener);
   }
 
-  teardownStreams() {
-    this.ecgListeners.clear();
-    this.speedListeners.clear();
-    this.receiveBuffer = "";
+  /** 임의의 텔레메트리 채널 구독 (RR, 경사, 거리, 상태 등) */
+  onTelemetry<K extends TelemetryChannelKey>(
+    key: K,
+    listener: TelemetryListener<K>
+  ) {
+    return this.telemetry.on(key, listener);
+  }
 
-    if (this.dataSubscription) {
-      this.dataSubscription.remove();
-      this.dataSubscription = null;
-    }
+  teardownStreams() {
+    this.program.stop();
+    this.speedControl.stop();
+    this.saveResponseModel();
+    this.telemetry.clear();
+    this.heartRateListeners.clear();
+    this.rawHeartRateListeners.clear();
+    this.beatListeners.clear();
+    this.stateListeners.clear();
+    this.staleListeners.clear();
+    this.strapStateListeners.clear();
+    this.speedControlListeners.clear();
+    this.programListeners.clear();
+    this.attachInternalListeners();
+    this.resetIngest();
+    this.transport.resetIngest?.();
   }
 
-  private notifyEcgListeners(bpm: number) {
-    this.ecgListeners.forEach((listener) => listener(bpm));
+  private handleBeat(beat: BeatEvent) {
+    this.telemetry.emit("rr", beat.rrMs);
+    this.beatListeners.forEach((listener) => listener(beat));
+    this.watchdog.feed("heartRate");
+    this.fuseHeartRate("beat", beat.bpm, this.sampleArrivedAt);
   }
 
-  private notifySpeedListeners(speed: number) {
-    this.speedListeners.forEach((listener) => listener(speed));
+  /**
+   * 측정 하나를 소스 필터로 거른 뒤 합치고, 게이트를 모두 통과하면 합친 심박수를
+   * onEcgSample 리스너에 알린다. 원시 값은 거르기 전에 onRawHeartRate로 나간다.
+   */
+  private fuseHeartRate(
+    source: HeartRateSourceKey,
+    bpm: number,
+    arrivedAtMs: number
+  ) {
+    const atMs = arrivedAtMs || Date.now();
+    if (this.rawHeartRateListeners.size > 0) {
+      this.rawHeartRateListeners.forEach((listener) => listener(source, bpm));
+    }
+    const filtered = this.heartRateFilters[source].push(bpm, atMs);
+    if (Number.isNaN(filtered)) return;
+
+    const fusion = this.heartRateFusion;
+    if (!fusion.update(source, filtered, atMs)) return;
+    // 벨트 속도 보고가 없으면 마지막으로 보낸 속도를 쓴다
+    const speed = Number.isNaN(this.beltSpeed)
+      ? (this.confirmedSetpoints.speed ?? 0)
+      : this.beltSpeed;
+    this.hrModel.observe(speed, fusion.bpm, atMs);
+    const fused = Math.round(fusion.bpm);
+    this.heartRateListeners.forEach((listener) => listener(fused));
   }
 
   static computeTargetHr(
@@ -263,6 +1449,18 @@ export class ArduinoBridge {
     return Math.round(hrr * intensity + body.restingHr);
   }
 
+  /** 목적의 강도 구간 양 끝을 목표 심박으로 (속도 제어 목표) */
+  static computeTargetHrBand(
+    body: BodyInfo,
+    purpose: WorkoutPurposeKey
+  ): HeartRateBand {
+    const range = PURPOSE_INTENSITY[purpose];
+    return {
+      low: ArduinoBridge.computeTargetHr(body, purpose, range.low),
+      high: ArduinoBridge.computeTargetHr(body, purpose, range.high),
+    };
+  }
+
   static getIntensityRange(purpose: WorkoutPurposeKey): IntensityRange {
     return PURPOSE_INTENSITY[purpose];
   }
@@ -0,0 +1,231 @@
+// services/binaryProtocol.ts
+// 선택적 바이너리 프레임 프로토콜 (BIN:1).
+//
+//   [SYNC 0xA5][채널 id][seq][count][count × 필드(고정 폭, little-endian)][CRC-8]
+//
+// CRC-8(poly 0x07)은 채널 id부터 마지막 필드까지 계산한다. seq는 링크 전체에서
+// 프레임마다 1씩 증가(mod 256)하므로 빠진 프레임 수를 알 수 있다.
+// 프레임 밖의 바이트(ASCII 텍스트 줄)는 그대로 텍스트 프레이머로 넘긴다.
+// 예) BPM 1개: 9바이트("BPM:123\r\n") → 6바이트, 여러 샘플을 한 프레임에 묶으면 1~2바이트/샘플.
+// 원시 ECG(0x08)는 프레임당 최대 32샘플을 묶어 보내므로 500 Hz에서도 약 1.1 KB/s면 된다.
+
+import { TelemetryChannelKey } from "./telemetryChannels";
+
+export const BINARY_PROTOCOL_VERSION = 1;
+export const FRAME_SYNC = 0xa5;
+export const MAX_SAMPLES_PER_FRAME = 32;
+
+const HEADER_BYTES = 4;
+const CRC_BYTES = 1;
+
+type FieldType = "u8" | "u16" | "i16";
+
+type BinaryChannelSpec = {
+  id: number;
+  key: TelemetryChannelKey;
+  field: FieldType;
+  /** 실제 값 = 전송 값 / divisor */
+  divisor: number;
+};
+
+export const BINARY_CHANNELS: BinaryChannelSpec[] = [
+  { id: 0x01, key: "bpm", field: "u8", divisor: 1 },
+  { id: 0x02, key: "speed", field: "u16", divisor: 100 },
+  { id: 0x03, key: "targetEcho", field: "u8", divisor: 1 },
+  { id: 0x04, key: "rr", field: "u16", divisor: 1 },
+  { id: 0x05, key: "incline", field: "i16", divisor: 10 },
+  { id: 0x06, key: "distance", field: "u16", divisor: 100 },
+  { id: 0x08, key: "ecg", field: "i16", divisor: 1 },
+];
+
+const FIELD_WIDTH: Record<FieldType, number> = { u8: 1, u16: 2, i16: 2 };
+
+const CHANNEL_BY_ID: (BinaryChannelSpec | undefined)[] = [];
+BINARY_CHANNELS.forEach((spec) => {
+  CHANNEL_BY_ID[spec.id] = spec;
+});
+
+const MAX_FRAME_BYTES = HEADER_BYTES + MAX_SAMPLES_PER_FRAME * 2 + CRC_BYTES;
+
+// CRC-8 (poly 0x07, init 0x00) 테이블
+const CRC8_TABLE = (() => {
+  const table = new Uint8Array(256);
+  for (let i = 0; i < 256; i++) {
+    let crc = i;
+    for (let bit = 0; bit < 8; bit++) {
+      crc = crc & 0x80 ? ((crc << 1) ^ 0x07) & 0xff : (crc << 1) & 0xff;
+    }
+    table[i] = crc;
+  }
+  return table;
+})();
+
+export function crc8(bytes: Uint8Array, start: number, end: number): number {
+  let crc = 0;
+  for (let i = start; i < end; i++) {
+    crc = CRC8_TABLE[crc ^ bytes[i]];
+  }
+  return crc;
+}
+
+/** 시뮬레이터/테스트용 프레임 인코더 */
+export function encodeFrame(
+  key: TelemetryChannelKey,
+  seq: number,
+  values: number[]
+): Uint8Array {
+  const spec = BINARY_CHANNELS.find((c) => c.key === key);
+  if (!spec) throw new Error(`Channel ${key} has no binary encoding`);
+  if (values.length === 0 || values.length > MAX_SAMPLES_PER_FRAME) {
+    throw new Error(`Invalid sample count: ${values.length}`);
+  }
+
+  const width = FIELD_WIDTH[spec.field];
+  const frame = new Uint8Array(HEADER_BYTES + values.length * width + 1);
+  frame[0] = FRAME_SYNC;
+  frame[1] = spec.id;
+  frame[2] = seq & 0xff;
+  frame[3] = values.length;
+
+  let pos = HEADER_BYTES;
+  values.forEach((value) => {
+    const raw = Math.round(value * spec.divisor);
+    frame[pos++] = raw & 0xff;
+    if (width === 2) frame[pos++] = (raw >> 8) & 0xff;
+  });
+  frame[pos] = crc8(frame, 1, pos);
+  return frame;
+}
+
+export type BinaryDecoderStats = {
+  framesDecoded: number;
+  crcErrors: number;
+  /** seq 번호로 감지한 누락 프레임 수 */
+  seqGaps: number;
+  /** 잘못된 헤더/CRC로 버린 바이트 수 */
+  discardedBytes: number;
+};
+
+export type SampleHandler = (key: TelemetryChannelKey, value: number) => void;
+export type TextByteHandler = (byte: number) => void;
+
+/**
+ * 바이트 스트림에서 바이너리 프레임을 골라내고, 나머지 바이트는 텍스트 경로로 넘긴다.
+ * CRC가 틀리면 프레임 안의 다음 SYNC부터 다시 스캔해서 재동기화한다.
+ */
+export class BinaryFrameDecoder {
+  private onSample: SampleHandler;
+  private onText: TextByteHandler;
+  private frame = new Uint8Array(MAX_FRAME_BYTES);
+  private filled = 0;
+  private expected = 0;
+  private lastSeq = -1;
+  private stats: BinaryDecoderStats = {
+    framesDecoded: 0,
+    crcErrors: 0,
+    seqGaps: 0,
+    discardedBytes: 0,
+  };
+
+  constructor(onSample: SampleHandler, onText: TextByteHandler) {
+    this.onSample = onSample;
+    this.onText = onText;
+  }
+
+  getStats(): BinaryDecoderStats {
+    return { ...this.stats };
+  }
+
+  reset() {
+    this.filled = 0;
+    this.expected = 0;
+    this.lastSeq = -1;
+  }
+
+  pushBytes(bytes: Uint8Array, offset: number = 0, length?: number) {
+    const stop = length === undefined ? bytes.length : offset + length;
+    for (let i = offset; i < stop; i++) {
+      this.pushByte(bytes[i]);
+    }
+  }
+
+  pushByte(b: number) {
+    if (this.filled === 0) {
+      if (b === FRAME_SYNC) {
+        this.frame[0] = b;
+        this.filled = 1;
+      } else {
+        this.onText(b);
+      }
+      return;
+    }
+
+    this.frame[this.filled++] = b;
+
+    if (this.filled === HEADER_BYTES) {
+      const spec = CHANNEL_BY_ID[this.frame[1]];
+      const count = this.frame[3];
+      if (!spec || count === 0 || count > MAX_SAMPLES_PER_FRAME) {
+        this.resync();
+        return;
+      }
+      this.expected = HEADER_BYTES + count * FIELD_WIDTH[spec.field] + CRC_BYTES;
+      return;
+    }
+
+    if (this.filled > HEADER_BYTES && this.filled === this.expected) {
+      const crcAt = this.expected - 1;
+      if (crc8(this.frame, 1, crcAt) !== this.frame[crcAt]) {
+        this.stats.crcErrors++;
+        this.resync();
+        return;
+      }
+      this.deliver();
+    }
+  }
+
+  private deliver() {
+    const spec = CHANNEL_BY_ID[this.frame[1]]!;
+    const seq = this.frame[2];
+    const count = this.frame[3];
+
+    if (this.lastSeq >= 0) {
+      this.stats.seqGaps += (seq - this.lastSeq - 1) & 0xff;
+    }
+    this.lastSeq = seq;
+    this.stats.framesDecoded++;
+
+    const width = FIELD_WIDTH[spec.field];
+    this.filled = 0;
+    this.expected = 0;
+
+    let pos = HEADER_BYTES;
+    for (let i = 0; i < count; i++) {
+      let raw = this.frame[pos];
+      if (width === 2) {
+        raw |= this.frame[pos + 1] << 8;
+        if (spec.field === "i16" && raw & 0x8000) raw -= 0x10000;
+      }
+      pos += width;
+      this.onSample(spec.key, raw / spec.divisor);
+    }
+  }
+
+  /** 깨진 프레임 안에서 다음 SYNC를 찾아 거기서부터 다시 스캔 (텍스트로는 넘기지 않음) */
+  private resync() {
+    const pending = this.filled;
+    this.filled = 0;
+    this.expected = 0;
+
+    let next = 1;
+    while (next < pending && this.frame[next] !== FRAME_SYNC) next++;
+    this.stats.discardedBytes += next;
+    if (next >= pending) return;
+
+    // 재스캔 중 frame 버퍼가 다시 쓰이므로 복사해 둔다 (오류 경로에서만 발생)
+    const replay = this.frame.slice(next, pending);
+    for (let i = 0; i < replay.length; i++) {
+      this.pushByte(replay[i]);
+    }
+  }
+}
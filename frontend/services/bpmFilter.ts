@@ -0,0 +1,146 @@
+// services/bpmFilter.ts
+// 심박 소스 하나의 BPM 값을 합치기 전에 거르는 스트리밍 필터. 샘플마다 상수 시간, 할당 없음.
+//
+//   1) 범위 게이트: 생리적으로 불가능한 값(센서가 내보내는 0, 255 등)은 버린다.
+//   2) 변화율 게이트: 최근 통과한 N개의 중앙값에서 경과 시간 × 최대 변화율 + 여유보다 멀면 버린다
+//      (두 배로 튄 값, QRS 검출이 박동을 놓치거나 두 번 세서 생기는 절반/두 배 값).
+//      중앙값이라 튄 값 하나가 기준을 끌고 가지 않는다.
+//      연달아 이만큼 버려졌으면 값이 실제로 바뀐 것이므로 그 값에서 다시 시작한다.
+//
+// 통과한 값은 그대로 내보낸다. 중앙값을 내보내면 (N-1)/2 샘플만큼 늦어지는데,
+// 뒤의 HeartRateFusion이 시간 정렬까지 하면서 다듬으므로 여기서 한 번 더 늦출 이유가 없다.
+// 소스 하나의 다듬은 값이 필요하면 median을 읽는다.
+
+export type BpmFilterStats = {
+  accepted: number;
+  /** 범위 밖이라 버린 값 */
+  rejectedRange: number;
+  /** 변화율 게이트에 걸려 버린 값 */
+  rejectedRate: number;
+  /** 게이트가 계속 막아서 새 값에서 다시 시작한 횟수 */
+  reseeds: number;
+};
+
+export type BpmFilterOptions = {
+  /** 중앙값 창 길이 (홀수) */
+  window?: number;
+  minBpm?: number;
+  maxBpm?: number;
+  /** 허용하는 최대 변화율 (bpm/s) */
+  maxRateBpmPerS?: number;
+  /** 변화율 한도에 더해 주는 여유 (박동 간 변이) */
+  rateMarginBpm?: number;
+};
+
+const DEFAULT_WINDOW = 5;
+const DEFAULT_MIN_BPM = 30;
+const DEFAULT_MAX_BPM = 240;
+const DEFAULT_MAX_RATE_BPM_PER_S = 3;
+const DEFAULT_RATE_MARGIN_BPM = 20;
+// 변화율 게이트에 연달아 이만큼 걸리면 다시 시작한다
+const MAX_CONSECUTIVE_REJECTS = 4;
+// 이보다 오래 샘플이 없었으면 이전 창은 버린다
+const RESET_AFTER_MS = 10000;
+
+export class BpmFilter {
+  private size: number;
+  private minBpm: number;
+  private maxBpm: number;
+  private maxRatePerMs: number;
+  private rateMarginBpm: number;
+  // 통과한 값의 링 버퍼와 정렬용 작업 배열
+  private ring: Float64Array;
+  private sorted: Float64Array;
+  private count = 0;
+  private head = 0;
+  private center = NaN;
+  private lastAcceptedAt = 0;
+  private consecutiveRejects = 0;
+  private stats: BpmFilterStats = {
+    accepted: 0,
+    rejectedRange: 0,
+    rejectedRate: 0,
+    reseeds: 0,
+  };
+
+  constructor(options: BpmFilterOptions = {}) {
+    this.size = options.window ?? DEFAULT_WINDOW;
+    this.minBpm = options.minBpm ?? DEFAULT_MIN_BPM;
+    this.maxBpm = options.maxBpm ?? DEFAULT_MAX_BPM;
+    this.maxRatePerMs =
+      (options.maxRateBpmPerS ?? DEFAULT_MAX_RATE_BPM_PER_S) / 1000;
+    this.rateMarginBpm = options.rateMarginBpm ?? DEFAULT_RATE_MARGIN_BPM;
+    this.ring = new Float64Array(this.size);
+    this.sorted = new Float64Array(this.size);
+  }
+
+  /** 통과하면 bpm 그대로, 버렸으면 NaN */
+  push(bpm: number, atMs: number): number {
+    if (!(bpm >= this.minBpm && bpm <= this.maxBpm)) {
+      this.stats.rejectedRange++;
+      return NaN;
+    }
+
+    if (this.count > 0 && atMs - this.lastAcceptedAt > RESET_AFTER_MS) {
+      this.count = 0;
+    }
+
+    if (this.count > 0) {
+      const allowed =
+        this.rateMarginBpm +
+        this.maxRatePerMs * Math.max(0, atMs - this.lastAcceptedAt);
+      if (Math.abs(bpm - this.center) > allowed) {
+        if (++this.consecutiveRejects < MAX_CONSECUTIVE_REJECTS) {
+          this.stats.rejectedRate++;
+          return NaN;
+        }
+        this.stats.reseeds++;
+        this.count = 0;
+      }
+    }
+
+    this.consecutiveRejects = 0;
+    this.lastAcceptedAt = atMs;
+    this.stats.accepted++;
+    this.ring[this.head] = bpm;
+    this.head = (this.head + 1) % this.size;
+    if (this.count < this.size) this.count++;
+    this.center = this.computeMedian();
+    return bpm;
+  }
+
+  /** 최근 통과한 값들의 중앙값. 아직 없으면 NaN */
+  get median(): number {
+    return this.center;
+  }
+
+  getStats(): BpmFilterStats {
+    return { ...this.stats };
+  }
+
+  /** 창만 비운다 (새 연결). 통계는 세션 내보내기용으로 남긴다 */
+  reset() {
+    this.count = 0;
+    this.head = 0;
+    this.center = NaN;
+    this.consecutiveRejects = 0;
+  }
+
+  /** 최근 count개의 중앙값. N이 작은 상수라 삽입 정렬로 충분하다 */
+  private computeMedian(): number {
+    const sorted = this.sorted;
+    const n = this.count;
+    for (let i = 0; i < n; i++) {
+      const value = this.ring[(this.head - 1 - i + this.size) % this.size];
+      let j = i;
+      while (j > 0 && sorted[j - 1] > value) {
+        sorted[j] = sorted[j - 1];
+        j--;
+      }
+      sorted[j] = value;
+    }
+    return n % 2 === 1
+      ? sorted[(n - 1) >> 1]
+      : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+  }
+}
@@ -0,0 +1,103 @@
+// services/classicTransport.ts
+// react-native-bluetooth-classic(SPP) 위의 Transport. HC-06 기본 경로.
+// 바이너리 모드에서는 라이브러리가 base64로 넘겨 주므로 바이트로 풀어서 onBytes로 넘긴다.
+
+import RNBluetoothClassic, {
+  BluetoothDevice,
+  BluetoothEventSubscription,
+} from "react-native-bluetooth-classic";
+import { Buffer } from "buffer";
+
+import { createLogger } from "./logger";
+import { Transport, TransportSink, withTimeout } from "./transport";
+
+const log = createLogger("BT:classic");
+
+export type ClassicTransportOptions = {
+  /** 바이트를 그대로 받는다 (바이너리 프로토콜 협상 시) */
+  binary?: boolean;
+};
+
+export class ClassicTransport implements Transport {
+  readonly kind = "classic";
+  private binary: boolean;
+  private device: BluetoothDevice | null = null;
+  private dataSubscription: BluetoothEventSubscription | null = null;
+  private linkLostSubscription: BluetoothEventSubscription | null = null;
+
+  constructor(options: ClassicTransportOptions = {}) {
+    this.binary = options.binary ?? false;
+  }
+
+  static getBondedDevices(): Promise<BluetoothDevice[]> {
+    return RNBluetoothClassic.getBondedDevices();
+  }
+
+  get isOpen(): boolean {
+    return this.device !== null;
+  }
+
+  async open(
+    address: string,
+    sink: TransportSink,
+    timeoutMs: number
+  ): Promise<void> {
+    const device = await withTimeout(
+      RNBluetoothClassic.connectToDevice(
+        address,
+        this.binary ? { connectionType: "binary" } : undefined
+      ),
+      timeoutMs
+    );
+
+    // 연결 상태 확인
+    const isConnected = await device.isConnected();
+    if (!isConnected) {
+      device.disconnect().catch(() => undefined);
+      throw new Error("Device connected but not responding");
+    }
+
+    this.device = device;
+    log.info(`Successfully connected to: ${device.name || address}`);
+
+    this.dataSubscription = device.onDataReceived((event) => {
+      const raw = (event.data ?? "").toString();
+      if (this.binary) sink.onBytes(Buffer.from(raw, "base64"), Date.now());
+      else sink.onText(raw, Date.now());
+    });
+    this.linkLostSubscription = RNBluetoothClassic.onDeviceDisconnected(
+      (event) => {
+        const lost = event.device;
+        if (lost?.address === address || lost?.id === address) {
+          this.release();
+          sink.onClosed();
+        }
+      }
+    );
+  }
+
+  async write(data: string): Promise<void> {
+    if (!this.device) {
+      throw new Error("Device not connected");
+    }
+    await this.device.write(data);
+  }
+
+  async close(): Promise<void> {
+    const device = this.device;
+    this.release();
+    if (device) await device.disconnect();
+  }
+
+  private release() {
+    if (this.dataSubscription) {
+      this.dataSubscription.remove();
+      this.dataSubscription = null;
+    }
+    if (this.linkLostSubscription) {
+      this.linkLostSubscription.remove();
+      this.linkLostSubscription = null;
+    }
+    this.device = null;
+  }
+}
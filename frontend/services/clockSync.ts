@@ -0,0 +1,140 @@
+// services/clockSync.ts
+// 기기 단조 시계(@<ms>)와 앱 시계(epoch ms) 사이의 오프셋/드리프트 추정 (NTP 방식).
+//
+//   앱이 t0에 PING:<n>을 보내고 t3에 PONG:<n>@<d>를 받으면, d는 기기가 요청을 처리한 시점이므로
+//   offset ≈ d - (t0 + t3) / 2,  오차는 RTT 비대칭의 절반 이하.
+//
+// 최근 교환 중 RTT가 최소에 가까운 것만 쓴다 (BT 버퍼링이나 JS 지연으로 늦게 처리된 응답은 버림).
+// 관측 구간이 충분하면 offset = a + b·(t - ref)로 직선 맞춤해서 드리프트 b를 얻는다.
+// 아두이노는 세라믹 레조네이터라 드리프트가 수백~수천 ppm이라 무시할 수 없다.
+
+const MAX_EXCHANGES = 32;
+// 이보다 긴 왕복은 쓰지 않는다
+const MAX_RTT_MS = 1000;
+// 최소 RTT보다 이만큼(또는 그 25%)까지 긴 교환은 좋은 교환으로 본다
+const RTT_SLACK_MS = 5;
+// 드리프트는 좋은 교환이 이만큼 떨어진 구간에 걸쳐 있을 때만 추정한다
+const MIN_DRIFT_SPAN_MS = 5000;
+const MIN_DRIFT_EXCHANGES = 3;
+const MAX_DRIFT_PPM = 10000;
+
+type Exchange = {
+  /** 왕복 중간 시각 (앱 시계) */
+  appMidMs: number;
+  offsetMs: number;
+  rttMs: number;
+};
+
+export type ClockSyncStats = {
+  synced: boolean;
+  /** 기기 시계 - 앱 시계 (ms, 최근 교환 시점 기준) */
+  offsetMs: number;
+  driftPpm: number;
+  /** 최근 창의 최소 왕복 시간 */
+  minRttMs: number;
+  exchanges: number;
+};
+
+export class ClockSync {
+  private exchanges: Exchange[] = [];
+  private total = 0;
+  // offset(t) = offsetMs + drift · (t - refMs)
+  private synced = false;
+  private refMs = 0;
+  private offsetMs = 0;
+  private drift = 0;
+  private minRttMs = 0;
+
+  get isSynced(): boolean {
+    return this.synced;
+  }
+
+  /** PING을 보낸 시각, PONG이 도착한 시각 (앱 시계), PONG에 실린 기기 시각 */
+  addExchange(sentAtMs: number, receivedAtMs: number, deviceMs: number) {
+    const rttMs = receivedAtMs - sentAtMs;
+    if (!(rttMs >= 0 && rttMs <= MAX_RTT_MS) || !isFinite(deviceMs)) return;
+
+    const appMidMs = (sentAtMs + receivedAtMs) / 2;
+    this.exchanges.push({ appMidMs, offsetMs: deviceMs - appMidMs, rttMs });
+    if (this.exchanges.length > MAX_EXCHANGES) this.exchanges.shift();
+    this.total++;
+    this.refit();
+  }
+
+  /** 기기 시각을 앱 시계(epoch ms)로. 동기화 전이면 NaN */
+  toAppTime(deviceMs: number): number {
+    if (!this.synced) return NaN;
+    // deviceMs = t + offsetMs + drift · (t - refMs) 를 t에 대해 푼다
+    return (
+      (deviceMs - this.offsetMs + this.drift * this.refMs) / (1 + this.drift)
+    );
+  }
+
+  stats(): ClockSyncStats {
+    return {
+      synced: this.synced,
+      offsetMs: Math.round(this.offsetMs * 10) / 10,
+      driftPpm: Math.round(this.drift * 1e6),
+      minRttMs: this.minRttMs,
+      exchanges: this.total,
+    };
+  }
+
+  /** 링크를 새로 열면 기기가 리셋됐을 수 있으므로 처음부터 다시 잰다 */
+  reset() {
+    this.exchanges = [];
+    this.total = 0;
+    this.synced = false;
+    this.refMs = 0;
+    this.offsetMs = 0;
+    this.drift = 0;
+    this.minRttMs = 0;
+  }
+
+  private refit() {
+    let minRtt = Infinity;
+    for (const exchange of this.exchanges) {
+      minRtt = Math.min(minRtt, exchange.rttMs);
+    }
+    const limit = minRtt + Math.max(RTT_SLACK_MS, minRtt * 0.25);
+    const good = this.exchanges.filter((exchange) => exchange.rttMs <= limit);
+
+    const ref = good[good.length - 1].appMidMs;
+    let drift = this.drift;
+    const span = ref - good[0].appMidMs;
+    if (good.length >= MIN_DRIFT_EXCHANGES && span >= MIN_DRIFT_SPAN_MS) {
+      // 최소제곱 직선
+      let sx = 0;
+      let sy = 0;
+      for (const exchange of good) {
+        sx += exchange.appMidMs - ref;
+        sy += exchange.offsetMs;
+      }
+      const mx = sx / good.length;
+      const my = sy / good.length;
+      let sxx = 0;
+      let sxy = 0;
+      for (const exchange of good) {
+        const dx = exchange.appMidMs - ref - mx;
+        sxx += dx * dx;
+        sxy += dx * (exchange.offsetMs - my);
+      }
+      if (sxx > 0) {
+        const limitDrift = MAX_DRIFT_PPM * 1e-6;
+        drift = Math.max(-limitDrift, Math.min(limitDrift, sxy / sxx));
+      }
+    }
+
+    // 드리프트를 뺀 오프셋의 평균을 ref 시점의 오프셋으로
+    let sum = 0;
+    for (const exchange of good) {
+      sum += exchange.offsetMs - drift * (exchange.appMidMs - ref);
+    }
+
+    this.synced = true;
+    this.refMs = ref;
+    this.offsetMs = sum / good.length;
+    this.drift = drift;
+    this.minRttMs = minRtt;
+  }
+}
@@ -0,0 +1,427 @@
+// services/commandQueue.ts
+// 단일 writer 송신 큐. 같은 종류의 명령(S:, T: …)이 아직 전송 전이면 마지막 값으로 덮어쓰고
+// (last-writer-wins), 대기 중인 명령 여러 개를 한 번의 write로 묶어 보낸다.
+// 동시에 진행 중인 write 수는 maxInFlight로 제한한다.
+//
+// ackTimeoutMs > 0 이면 각 명령 뒤에 "#<seq>"를 붙여 보내고 기기의 "ACK:<seq>"를 기다린다.
+// 시간 안에 ACK가 없으면 같은 seq로 다시 보내고, maxRetries를 넘기면 실패로 처리한다.
+// 같은 종류의 새 명령이 전송되면 ACK를 기다리던 이전 명령은 재전송하지 않는다
+// (늦게 도착한 이전 값이 최신 값을 덮어쓰지 않도록). 대체된 명령의 Promise는 새 명령과 함께
+// resolve되며, 항상 요청된 순서대로(이전 명령이 먼저) resolve된다.
+//
+// sendUrgent()는 우선순위 레인이다(STOP). 큐와 in-flight 제한을 건너뛰어 바로 쓰고,
+// 지정한 종류의 대기/재전송 중인 명령을 취소한 뒤 ACK가 올 때까지 짧은 간격으로 다시 보낸다.
+// ACK 모드가 아니면 다시 보내도 확인할 방법이 없으므로 첫 write가 끝나면 완료된다.
+
+export type CommandWriter = (data: string) => Promise<void>;
+
+export type CommandQueueOptions = {
+  /** 동시에 진행 중인 write 수 (HC-06 직렬 링크는 1) */
+  maxInFlight?: number;
+  /** 한 번의 write에 묶을 최대 바이트 수 */
+  maxBatchBytes?: number;
+  /** ACK 대기 시간. 0이면 ACK 없이 write 완료로 끝난다 */
+  ackTimeoutMs?: number;
+  /** ACK가 없을 때 재전송 횟수 */
+  maxRetries?: number;
+  /** ACK를 받은 명령의 종류와 첫 전송부터 ACK까지의 시간 */
+  onAcknowledged?: (type: string, rttMs: number, attempts: number) => void;
+};
+
+export type UrgentCommandOptions = {
+  /** 취소할 명령 종류 (대기 중이거나 ACK를 기다리는 것 모두) */
+  cancel?: string[];
+  /** ACK가 올 때까지 다시 보내는 간격 (ACK 모드에서만) */
+  resendIntervalMs: number;
+  /** 이 시간이 지나도 ACK가 없으면 실패로 처리 */
+  maxDurationMs: number;
+};
+
+/** 우선순위 명령에 밀려 취소된 명령의 Promise는 이 에러로 reject된다 */
+export class CommandCancelledError extends Error {
+  constructor(command: string, by: string) {
+    super(`${command} cancelled by ${by}`);
+    this.name = "CommandCancelledError";
+  }
+}
+
+export type CommandQueueStats = {
+  enqueued: number;
+  /** 전송 전에 더 최신 값으로 대체된 명령 수 */
+  coalesced: number;
+  writes: number;
+  bytesWritten: number;
+  acked: number;
+  retries: number;
+  /** 재전송을 모두 써도 ACK가 없던 명령 수 */
+  ackTimeouts: number;
+  /** ACK 전에 같은 종류의 새 명령으로 대체된 명령 수 */
+  superseded: number;
+  urgent: number;
+  /** 우선순위 명령에 밀려 취소된 명령 수 */
+  cancelled: number;
+};
+
+type Waiter = {
+  resolve: () => void;
+  reject: (error: unknown) => void;
+};
+
+type PendingCommand = {
+  type: string;
+  line: string;
+  waiters: Waiter[];
+  // ACK 모드: 재전송이면 처음 받은 seq를 유지한다
+  seq: number;
+  attempts: number;
+  firstSentAt: number;
+};
+
+type AwaitingAck = {
+  command: PendingCommand;
+  timer: ReturnType<typeof setTimeout>;
+  // 우선순위 레인: ACK까지 주기적으로 다시 보내는 타이머
+  resendTimer: ReturnType<typeof setInterval> | null;
+};
+
+const DEFAULT_MAX_IN_FLIGHT = 1;
+const DEFAULT_MAX_BATCH_BYTES = 64;
+const DEFAULT_MAX_RETRIES = 3;
+const SEQ_MODULO = 256;
+
+/** "S:5.0" → "S", "STOP" → "STOP" */
+export function commandType(command: string): string {
+  const colon = command.indexOf(":");
+  return colon < 0 ? command : command.substring(0, colon);
+}
+
+export class CommandQueue {
+  private writer: CommandWriter;
+  private maxInFlight: number;
+  private maxBatchBytes: number;
+  private ackTimeoutMs: number;
+  private maxRetries: number;
+  private onAcknowledged?: CommandQueueOptions["onAcknowledged"];
+  // Map은 삽입 순서를 유지하므로 덮어써도 처음 요청된 순서가 보존된다
+  private pending: Map<string, PendingCommand> = new Map();
+  private awaiting: Map<number, AwaitingAck> = new Map();
+  private awaitingByType: Map<string, number> = new Map();
+  private nextSeq = 0;
+  private inFlight = 0;
+  private stats: CommandQueueStats = {
+    enqueued: 0,
+    coalesced: 0,
+    writes: 0,
+    bytesWritten: 0,
+    acked: 0,
+    retries: 0,
+    ackTimeouts: 0,
+    superseded: 0,
+    urgent: 0,
+    cancelled: 0,
+  };
+
+  constructor(writer: CommandWriter, options: CommandQueueOptions = {}) {
+    this.writer = writer;
+    this.maxInFlight = options.maxInFlight ?? DEFAULT_MAX_IN_FLIGHT;
+    this.maxBatchBytes = options.maxBatchBytes ?? DEFAULT_MAX_BATCH_BYTES;
+    this.ackTimeoutMs = options.ackTimeoutMs ?? 0;
+    this.maxRetries = options.maxRetries ?? DEFAULT_MAX_RETRIES;
+    this.onAcknowledged = options.onAcknowledged;
+  }
+
+  getStats(): CommandQueueStats {
+    return { ...this.stats };
+  }
+
+  get pendingCount(): number {
+    return this.pending.size;
+  }
+
+  get awaitingAckCount(): number {
+    return this.awaiting.size;
+  }
+
+  /**
+   * 명령을 큐에 넣는다. 같은 종류가 대기 중이면 값만 바꾼다.
+   * 이 명령(또는 이를 대체한 최신 명령)이 전송되면 resolve된다.
+   * ACK 모드에서는 ACK를 받아야 resolve된다.
+   */
+  enqueue(
+    command: string,
+    type: string = commandType(command)
+  ): Promise<void> {
+    this.stats.enqueued++;
+
+    return new Promise<void>((resolve, reject) => {
+      const existing = this.pending.get(type);
+      if (existing) {
+        existing.line = command;
+        existing.waiters.push({ resolve, reject });
+        // 재전송을 기다리던 이전 값이었다면 새 명령으로 취급한다
+        existing.seq = -1;
+        existing.attempts = 0;
+        this.stats.coalesced++;
+      } else {
+        this.pending.set(type, {
+          type,
+          line: command,
+          waiters: [{ resolve, reject }],
+          seq: -1,
+          attempts: 0,
+          firstSentAt: 0,
+        });
+      }
+      this.pump();
+    });
+  }
+
+  /**
+   * 우선순위 레인으로 바로 보낸다. ACK가 오면(ACK 모드가 아니면 첫 write가 끝나면) resolve되고,
+   * 첫 write가 실패하거나 maxDurationMs 안에 ACK가 없으면 reject된다.
+   */
+  sendUrgent(command: string, options: UrgentCommandOptions): Promise<void> {
+    const type = commandType(command);
+    this.stats.enqueued++;
+    this.stats.urgent++;
+    this.cancelTypes([type, ...(options.cancel ?? [])], command);
+
+    const acked = this.ackTimeoutMs > 0;
+    return new Promise<void>((resolve, reject) => {
+      const urgent: PendingCommand = {
+        type,
+        line: command,
+        waiters: [{ resolve, reject }],
+        seq: this.nextSeq,
+        attempts: 1,
+        firstSentAt: Date.now(),
+      };
+      this.nextSeq = (this.nextSeq + 1) % SEQ_MODULO;
+
+      const data = acked ? `${command}#${urgent.seq}\n` : command + "\n";
+      const write = () => {
+        this.stats.writes++;
+        this.stats.bytesWritten += data.length;
+        return this.writer(data);
+      };
+
+      const entry: AwaitingAck = {
+        command: urgent,
+        timer: setTimeout(() => {
+          if (this.awaiting.get(urgent.seq) !== entry) return;
+          this.forgetAwaiting(urgent.seq, entry);
+          this.stats.ackTimeouts++;
+          reject(
+            new Error(
+              `No ACK for ${command} after ${urgent.attempts} attempts`
+            )
+          );
+        }, options.maxDurationMs),
+        resendTimer: acked
+          ? setInterval(() => {
+              urgent.attempts++;
+              this.stats.retries++;
+              // 재전송 실패는 무시하고 다음 주기에 다시 시도한다
+              write().catch(() => undefined);
+            }, options.resendIntervalMs)
+          : null,
+      };
+      this.awaiting.set(urgent.seq, entry);
+      this.awaitingByType.set(type, urgent.seq);
+
+      write().then(
+        () => {
+          if (!acked && this.awaiting.get(urgent.seq) === entry) {
+            this.completeAwaiting(urgent.seq, entry);
+          }
+        },
+        (error) => {
+          if (this.awaiting.get(urgent.seq) !== entry) return;
+          this.forgetAwaiting(urgent.seq, entry);
+          reject(error);
+        }
+      );
+    });
+  }
+
+  /** 기기가 보낸 ACK:<seq> 처리. ackedAt은 ACK 줄이 도착한 시각 (네이티브 경로는 drain보다 이르다) */
+  acknowledge(seq: number, ackedAt: number = Date.now()) {
+    const entry = this.awaiting.get(seq);
+    // 재전송 후 늦게 온 중복 ACK이거나 이미 대체된 명령
+    if (!entry) return;
+    this.completeAwaiting(seq, entry, ackedAt);
+  }
+
+  private completeAwaiting(
+    seq: number,
+    entry: AwaitingAck,
+    completedAt: number = Date.now()
+  ) {
+    this.forgetAwaiting(seq, entry);
+    this.stats.acked++;
+    const command = entry.command;
+    this.onAcknowledged?.(
+      command.type,
+      completedAt - command.firstSentAt,
+      command.attempts
+    );
+    command.waiters.forEach((waiter) => waiter.resolve());
+  }
+
+  /** 아직 전송되지 않았거나 ACK를 기다리는 명령을 버린다 (연결 해제 시) */
+  clear(reason: unknown = new Error("Command queue cleared")) {
+    const dropped = Array.from(this.pending.values());
+    this.pending.clear();
+    this.awaiting.forEach((entry) => {
+      clearTimeout(entry.timer);
+      if (entry.resendTimer) clearInterval(entry.resendTimer);
+      dropped.push(entry.command);
+    });
+    this.awaiting.clear();
+    this.awaitingByType.clear();
+    dropped.forEach((command) =>
+      command.waiters.forEach((waiter) => waiter.reject(reason))
+    );
+  }
+
+  private pump() {
+    while (this.inFlight < this.maxInFlight && this.pending.size > 0) {
+      this.writeBatch();
+    }
+  }
+
+  private writeBatch() {
+    const acked = this.ackTimeoutMs > 0;
+    const now = Date.now();
+    let data = "";
+    const batch: PendingCommand[] = [];
+
+    for (const [type, command] of this.pending) {
+      if (acked && command.seq < 0) {
+        command.seq = this.nextSeq;
+        this.nextSeq = (this.nextSeq + 1) % SEQ_MODULO;
+        command.firstSentAt = now;
+      }
+      const line = acked
+        ? `${command.line}#${command.seq}\n`
+        : command.line + "\n";
+      if (batch.length > 0 && data.length + line.length > this.maxBatchBytes) {
+        break;
+      }
+      data += line;
+      batch.push(command);
+      this.pending.delete(type);
+    }
+
+    this.inFlight++;
+    this.stats.writes++;
+    this.stats.bytesWritten += data.length;
+    if (acked) {
+      batch.forEach((command) => this.awaitAck(command));
+    }
+
+    this.writer(data).then(
+      () => {
+        this.inFlight--;
+        if (!acked) {
+          batch.forEach((command) =>
+            command.waiters.forEach((waiter) => waiter.resolve())
+          );
+        }
+        this.pump();
+      },
+      (error) => {
+        this.inFlight--;
+        batch.forEach((command) => {
+          const entry = this.awaiting.get(command.seq);
+          if (entry && entry.command === command) {
+            this.forgetAwaiting(command.seq, entry);
+          }
+          command.waiters.forEach((waiter) => waiter.reject(error));
+        });
+        this.pump();
+      }
+    );
+  }
+
+  /** 전송한 명령의 ACK 타이머를 건다. ACK를 기다리던 같은 종류의 이전 명령은 대체한다 */
+  private awaitAck(command: PendingCommand) {
+    command.attempts++;
+
+    const previousSeq = this.awaitingByType.get(command.type);
+    if (previousSeq !== undefined && previousSeq !== command.seq) {
+      const previous = this.awaiting.get(previousSeq);
+      if (previous) {
+        this.forgetAwaiting(previousSeq, previous);
+        // 이전 명령을 기다리던 쪽이 먼저 resolve되어야 최신 값이 마지막에 남는다
+        command.waiters.unshift(...previous.command.waiters);
+        this.stats.superseded++;
+      }
+    }
+
+    const timer = setTimeout(
+      () => this.handleAckTimeout(command),
+      this.ackTimeoutMs
+    );
+    this.awaiting.set(command.seq, { command, timer, resendTimer: null });
+    this.awaitingByType.set(command.type, command.seq);
+  }
+
+  private handleAckTimeout(command: PendingCommand) {
+    const entry = this.awaiting.get(command.seq);
+    if (!entry || entry.command !== command) return;
+    this.forgetAwaiting(command.seq, entry);
+
+    if (command.attempts > this.maxRetries) {
+      this.stats.ackTimeouts++;
+      const error = new Error(
+        `No ACK for ${command.line} after ${command.attempts} attempts`
+      );
+      command.waiters.forEach((waiter) => waiter.reject(error));
+      return;
+    }
+
+    // 같은 종류의 새 명령이 이미 대기 중이면 그 명령이 대신 전송된다
+    const newer = this.pending.get(command.type);
+    if (newer) {
+      newer.waiters.unshift(...command.waiters);
+      this.stats.superseded++;
+    } else {
+      this.stats.retries++;
+      this.pending.set(command.type, command);
+    }
+    this.pump();
+  }
+
+  /** 대기 중이거나 ACK를 기다리는 해당 종류의 명령을 모두 취소한다 */
+  private cancelTypes(types: string[], by: string) {
+    types.forEach((type) => {
+      const cancelled: PendingCommand[] = [];
+      const pending = this.pending.get(type);
+      if (pending) {
+        this.pending.delete(type);
+        cancelled.push(pending);
+      }
+      const seq = this.awaitingByType.get(type);
+      const entry = seq === undefined ? undefined : this.awaiting.get(seq);
+      if (seq !== undefined && entry) {
+        this.forgetAwaiting(seq, entry);
+        cancelled.push(entry.command);
+      }
+      cancelled.forEach((command) => {
+        this.stats.cancelled++;
+        const error = new CommandCancelledError(command.line, by);
+        command.waiters.forEach((waiter) => waiter.reject(error));
+      });
+    });
+  }
+
+  private forgetAwaiting(seq: number, entry: AwaitingAck) {
+    clearTimeout(entry.timer);
+    if (entry.resendTimer) clearInterval(entry.resendTimer);
+    this.awaiting.delete(seq);
+    if (this.awaitingByType.get(entry.command.type) === seq) {
+      this.awaitingByType.delete(entry.command.type);
+    }
+  }
+}
@@ -0,0 +1,166 @@
+// services/ecgBuffer.ts
+// 원시 ECG 파형(250~500 Hz)을 React state 대신 미리 할당된 Int16Array 링 버퍼에 저장한다.
+// 샘플마다 증가하는 일련번호(seq)로 위치를 나타내므로, 소비자는 마지막으로 읽은 seq 이후만 읽으면 된다.
+//
+// 샘플링 주파수는 기기가 EHZ:<hz>로 알려 주면 그 값을 쓰고, 없으면 EcgRateEstimator가
+// 도착한 샘플 수로 추정한다. 주파수가 바뀌면 버퍼는 같은 길이(초)로 다시 할당된다.
+
+// 기기가 알려 주거나 추정하기 전의 가정값
+export const ECG_DEFAULT_SAMPLE_RATE_HZ = 250;
+export const ECG_BUFFER_SECONDS = 16;
+// 추정값을 맞춰 넣는 흔한 ADC 샘플링 주파수
+export const ECG_STANDARD_RATES_HZ = [125, 250, 360, 500, 1000];
+
+// 도착 샘플 수를 세는 창. 이보다 긴 공백이 있으면 창을 다시 시작한다
+const RATE_WINDOW_MS = 2000;
+const RATE_GAP_MS = 500;
+// 표준 주파수와 이 비율 안이면 그 값으로 본다
+const RATE_SNAP_TOLERANCE = 0.15;
+
+function roundUpPow2(n: number): number {
+  let size = 1;
+  while (size < n) size <<= 1;
+  return size;
+}
+
+/** 추정한 주파수를 가까운 표준 주파수로 맞춘다. 먼 값이면 정수로 반올림만 한다 */
+export function snapEcgSampleRate(hz: number): number {
+  let best = ECG_STANDARD_RATES_HZ[0];
+  for (const rate of ECG_STANDARD_RATES_HZ) {
+    if (Math.abs(rate - hz) < Math.abs(best - hz)) best = rate;
+  }
+  return Math.abs(best - hz) <= best * RATE_SNAP_TOLERANCE
+    ? best
+    : Math.round(hz);
+}
+
+/** 샘플 도착 시각으로 스트림의 샘플링 주파수를 잰다 (기기가 EHZ:를 보내지 않을 때) */
+export class EcgRateEstimator {
+  private windowStart = NaN;
+  private lastAt = NaN;
+  private count = 0;
+
+  /** 샘플 하나의 도착 시각 (ms). 창이 찼으면 추정한 주파수, 아니면 NaN */
+  push(arrivedAtMs: number): number {
+    const resume = !(arrivedAtMs - this.lastAt <= RATE_GAP_MS);
+    this.lastAt = arrivedAtMs;
+    if (resume) {
+      this.windowStart = arrivedAtMs;
+      this.count = 0;
+      return NaN;
+    }
+
+    this.count++;
+    const elapsed = arrivedAtMs - this.windowStart;
+    if (elapsed < RATE_WINDOW_MS) return NaN;
+    const hz = (this.count * 1000) / elapsed;
+    this.windowStart = arrivedAtMs;
+    this.count = 0;
+    return snapEcgSampleRate(hz);
+  }
+
+  reset() {
+    this.windowStart = NaN;
+    this.lastAt = NaN;
+    this.count = 0;
+  }
+}
+
+export class EcgRingBuffer {
+  private buffer: Int16Array;
+  private rateHz: number;
+  private mask: number;
+  private written = 0;
+
+  constructor(
+    capacity: number = ECG_DEFAULT_SAMPLE_RATE_HZ * ECG_BUFFER_SECONDS,
+    sampleRateHz: number = ECG_DEFAULT_SAMPLE_RATE_HZ
+  ) {
+    const size = roundUpPow2(Math.max(2, capacity));
+    this.buffer = new Int16Array(size);
+    this.mask = size - 1;
+    this.rateHz = sampleRateHz;
+  }
+
+  get samples(): Int16Array {
+    return this.buffer;
+  }
+
+  get sampleRateHz(): number {
+    return this.rateHz;
+  }
+
+  /**
+   * 샘플링 주파수를 바꾼다. 담을 수 있는 길이(초)가 유지되도록 다시 할당하고 비운다.
+   * 이전 주파수로 쌓인 샘플과 seq는 버려진다.
+   */
+  setSampleRate(sampleRateHz: number) {
+    if (sampleRateHz === this.rateHz) return;
+    const seconds = this.buffer.length / this.rateHz;
+    const size = roundUpPow2(Math.max(2, Math.ceil(seconds * sampleRateHz)));
+    this.buffer = new Int16Array(size);
+    this.mask = size - 1;
+    this.rateHz = sampleRateHz;
+    this.written = 0;
+  }
+
+  get capacity(): number {
+    return this.buffer.length;
+  }
+
+  /** 지금까지 쓰인 전체 샘플 수 (= 다음 샘플의 seq) */
+  get totalWritten(): number {
+    return this.written;
+  }
+
+  /** 버퍼에 남아 있는 샘플 수 */
+  get length(): number {
+    return Math.min(this.written, this.buffer.length);
+  }
+
+  /** 버퍼에 남아 있는 가장 오래된 seq */
+  get oldestSeq(): number {
+    return this.written - this.length;
+  }
+
+  push(value: number) {
+    this.buffer[this.written & this.mask] = value;
+    this.written++;
+  }
+
+  /** seq 위치의 값. 이미 덮어쓴 위치면 NaN */
+  at(seq: number): number {
+    if (seq < this.oldestSeq || seq >= this.written) return NaN;
+    return this.buffer[seq & this.mask];
+  }
+
+  /**
+   * fromSeq 이후 샘플을 순서대로 visit에 넘기고, 다음에 읽을 seq를 돌려준다.
+   * 너무 오래된 fromSeq는 버퍼에 남은 가장 오래된 샘플부터 읽는다.
+   */
+  forEachSince(fromSeq: number, visit: (value: number, seq: number) => void) {
+    let seq = Math.max(fromSeq, this.oldestSeq);
+    for (; seq < this.written; seq++) {
+      visit(this.buffer[seq & this.mask], seq);
+    }
+    return seq;
+  }
+
+  /**
+   * 최근 샘플을 out에 오래된 순서로 복사한다 (표시용, 할당 없음).
+   * stride > 1 이면 그 간격으로 솎아낸다. 복사한 개수를 돌려준다.
+   */
+  copyLatest(out: Float32Array, stride: number = 1): number {
+    const step = Math.max(1, Math.floor(stride));
+    const count = Math.min(out.length, Math.floor(this.length / step));
+    let seq = this.written - count * step;
+    for (let i = 0; i < count; i++, seq += step) {
+      out[i] = this.buffer[seq & this.mask];
+    }
+    return count;
+  }
+
+  clear() {
+    this.written = 0;
+  }
+}
@@ -0,0 +1,263 @@
+// services/heartRateFusion.ts
+// 여러 심박 소스(기기 BPM:, 폰 ECG 박동, BLE 벨트)를 하나의 심박수로 합치는 2상태 칼만 필터.
+//
+//   상태 x = [hr (bpm), 기울기 (bpm/s)], 등속 모델 + 백색 가속 잡음
+//   측정 z = 소스가 보고한 bpm. 소스마다 지연(latency)과 잡음 분산(R)을 따로 추정한다.
+//
+// 시간 정렬: 측정은 도착 시각 - 소스 지연 시점의 값으로 본다. 필터 시각보다 과거이면
+// 앞으로 돌리지 않고 측정 모델 H = [1, -lag]로 그 시점의 hr(= hr - 기울기 × lag)과 비교한다.
+// 지연 추정: 기울기가 충분할 때 잔차 ≈ -기울기 × (추정이 놓친 지연) 이므로 LMS로 보정한다.
+// 지연은 소스끼리의 상대값만 관측되므로, 최근 활동 중인 소스 중 지연이 가장 짧은 것은 기준으로 고정한다.
+// 품질 가중: R은 잔차 제곱의 지수 평균으로 따라가서, 흔들리는 소스는 자동으로 덜 믿는다.
+// 한 소스가 끊겨도 나머지로 계속 갱신되고, 끊긴 소스는 돌아오면 그대로 다시 합쳐진다.
+
+export type HeartRateSourceKey = "device" | "beat" | "strap";
+
+type SourcePrior = {
+  /** 측정 잡음 표준편차 초기값/하한 (bpm) */
+  noiseBpm: number;
+  /** 도착 시각 기준 지연 초기값 (ms) */
+  latencyMs: number;
+};
+
+const SOURCE_PRIORS: Record<HeartRateSourceKey, SourcePrior> = {
+  // 아두이노가 여러 박동을 평균해서 보낸다: 부드럽지만 늦다
+  device: { noiseBpm: 3, latencyMs: 3000 },
+  // 폰에서 검출한 박동마다의 순간 BPM: 빠르지만 박동 간 변이(HRV)만큼 흔들린다
+  beat: { noiseBpm: 4, latencyMs: 300 },
+  // 가슴 벨트: 벨트 안에서 짧게 평균한다
+  strap: { noiseBpm: 2, latencyMs: 1000 },
+};
+
+// 백색 가속 잡음 세기 (bpm²/s³). 운동 중 HR 기울기가 바뀌는 속도
+const PROCESS_NOISE = 0.3;
+const INITIAL_SLOPE_VARIANCE = 1;
+// 잔차가 이 배수(σ)를 넘으면 그 측정은 버린다
+const GATE_SIGMA = 5;
+// 버린 측정이 연달아 이만큼이면 필터가 틀린 것으로 보고 다시 시작한다
+const MAX_CONSECUTIVE_REJECTS = 5;
+// R 지수 평균 계수
+const NOISE_ALPHA = 0.05;
+// 지연 LMS: 기울기가 이보다 클 때만, 한 번에 최대 MAX_LATENCY_STEP_MS만큼
+const LATENCY_ALPHA = 0.02;
+const LATENCY_MIN_SLOPE = 0.3;
+const MAX_LATENCY_STEP_MS = 200;
+const MAX_LATENCY_MS = 10000;
+// 기준 소스를 고를 때 "최근 활동 중"으로 보는 범위
+const ACTIVE_SOURCE_MS = 5000;
+// 마지막 측정 이후 이만큼 지나면 필터를 다시 시작한다 (예측만으로는 믿을 수 없음)
+const RESET_AFTER_MS = 15000;
+
+export type HeartRateEstimate = {
+  bpm: number;
+  /** 기울기 (bpm/s) */
+  slope: number;
+  /** 추정 표준편차 (bpm) */
+  sigmaBpm: number;
+  /** 마지막으로 측정을 합친 시각 (epoch ms). 이 값이 오래됐으면 추정을 믿으면 안 된다 */
+  updatedAtMs: number;
+};
+
+export type HeartRateSourceStats = {
+  updates: number;
+  rejected: number;
+  latencyMs: number;
+  noiseBpm: number;
+  /** 마지막 측정 도착 시각 (epoch ms, 없으면 0) */
+  lastAt: number;
+};
+
+type SourceState = HeartRateSourceStats & {
+  noiseVariance: number;
+  minVariance: number;
+};
+
+export class HeartRateFusion {
+  private sources: Map<HeartRateSourceKey, SourceState> = new Map();
+  private initialized = false;
+  // 필터 상태가 가리키는 시각 (ms)
+  private time = 0;
+  private hr = 0;
+  private slope = 0;
+  private p00 = 0;
+  private p01 = 0;
+  private p11 = 0;
+  private lastUpdateAt = 0;
+  private consecutiveRejects = 0;
+
+  constructor() {
+    (Object.keys(SOURCE_PRIORS) as HeartRateSourceKey[]).forEach((key) => {
+      const prior = SOURCE_PRIORS[key];
+      const variance = prior.noiseBpm * prior.noiseBpm;
+      this.sources.set(key, {
+        updates: 0,
+        rejected: 0,
+        latencyMs: prior.latencyMs,
+        noiseBpm: prior.noiseBpm,
+        lastAt: 0,
+        noiseVariance: variance,
+        minVariance: variance,
+      });
+    });
+  }
+
+  /**
+   * 측정 하나를 합친다. 게이트에 걸려 버렸으면 false. 합친 값은 bpm으로 읽는다
+   * (샘플마다 불리므로 객체를 만들지 않는다). arrivedAtMs는 같은 시계(epoch ms)여야 한다.
+   */
+  update(key: HeartRateSourceKey, bpm: number, arrivedAtMs: number): boolean {
+    const source = this.sources.get(key)!;
+    const measuredAt = arrivedAtMs - source.latencyMs;
+
+    if (!this.initialized || arrivedAtMs - this.lastUpdateAt > RESET_AFTER_MS) {
+      this.start(bpm, measuredAt, source);
+      this.accept(source, arrivedAtMs);
+      return true;
+    }
+
+    if (measuredAt > this.time) this.predict(measuredAt);
+    const lagS = (this.time - measuredAt) / 1000;
+
+    // H = [1, -lag]
+    const h1 = -lagS;
+    const predicted = this.hr + h1 * this.slope;
+    const residual = bpm - predicted;
+    const ph0 = this.p00 + h1 * this.p01;
+    const ph1 = this.p01 + h1 * this.p11;
+    const hph = ph0 + h1 * ph1;
+    const innovationVariance = hph + source.noiseVariance;
+
+    if (residual * residual > GATE_SIGMA * GATE_SIGMA * innovationVariance) {
+      source.rejected++;
+      if (++this.consecutiveRejects >= MAX_CONSECUTIVE_REJECTS) {
+        // 게이트가 계속 막으면 HR이 실제로 튄 것이다
+        this.start(bpm, measuredAt, source);
+        this.accept(source, arrivedAtMs);
+        return true;
+      }
+      return false;
+    }
+
+    const k0 = ph0 / innovationVariance;
+    const k1 = ph1 / innovationVariance;
+    this.hr += k0 * residual;
+    this.slope += k1 * residual;
+    const p00 = this.p00 - k0 * ph0;
+    const p01 = this.p01 - k0 * ph1;
+    const p11 = this.p11 - k1 * ph1;
+    this.p00 = p00;
+    this.p01 = p01;
+    this.p11 = p11;
+
+    // 품질: 잔차로 R을 따라간다 (하한은 사전값)
+    source.noiseVariance = Math.max(
+      source.minVariance,
+      (1 - NOISE_ALPHA) * source.noiseVariance +
+        NOISE_ALPHA * (residual * residual - hph)
+    );
+    source.noiseBpm = Math.sqrt(source.noiseVariance);
+
+    // 지연: 잔차 ≈ -기울기 × 놓친 지연
+    if (
+      Math.abs(this.slope) >= LATENCY_MIN_SLOPE &&
+      !this.isReference(source, arrivedAtMs)
+    ) {
+      const missedMs = (-residual / this.slope) * 1000;
+      const step = Math.max(
+        -MAX_LATENCY_STEP_MS,
+        Math.min(MAX_LATENCY_STEP_MS, LATENCY_ALPHA * missedMs)
+      );
+      source.latencyMs = Math.max(
+        0,
+        Math.min(MAX_LATENCY_MS, source.latencyMs + step)
+      );
+    }
+
+    this.accept(source, arrivedAtMs);
+    return true;
+  }
+
+  /** 합친 심박수 (bpm). 아직 측정이 없으면 0 */
+  get bpm(): number {
+    return this.initialized ? this.hr : 0;
+  }
+
+  /** 필터 시각(마지막 측정 시점) 기준 추정. 아직 측정이 없으면 null */
+  current(): HeartRateEstimate | null {
+    return this.initialized ? this.estimate() : null;
+  }
+
+  sourceStats(): Record<HeartRateSourceKey, HeartRateSourceStats> {
+    const result = {} as Record<HeartRateSourceKey, HeartRateSourceStats>;
+    this.sources.forEach((source, key) => {
+      result[key] = {
+        updates: source.updates,
+        rejected: source.rejected,
+        latencyMs: Math.round(source.latencyMs),
+        noiseBpm: Math.round(source.noiseBpm * 10) / 10,
+        lastAt: source.lastAt,
+      };
+    });
+    return result;
+  }
+
+  /** 필터 상태만 비운다. 소스별 지연/잡음 추정은 다음 세션에도 유효하므로 남긴다 */
+  reset() {
+    this.initialized = false;
+    this.consecutiveRejects = 0;
+  }
+
+  /** 최근 활동 중인 다른 소스가 없거나, 그중 지연이 가장 짧으면 기준 소스 */
+  private isReference(source: SourceState, now: number): boolean {
+    for (const other of this.sources.values()) {
+      if (
+        other !== source &&
+        now - other.lastAt <= ACTIVE_SOURCE_MS &&
+        other.latencyMs < source.latencyMs
+      ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  private start(bpm: number, measuredAt: number, source: SourceState) {
+    this.initialized = true;
+    this.time = measuredAt;
+    this.hr = bpm;
+    this.slope = 0;
+    this.p00 = source.noiseVariance;
+    this.p01 = 0;
+    this.p11 = INITIAL_SLOPE_VARIANCE;
+  }
+
+  private accept(source: SourceState, arrivedAtMs: number) {
+    source.updates++;
+    source.lastAt = arrivedAtMs;
+    this.lastUpdateAt = arrivedAtMs;
+    this.consecutiveRejects = 0;
+  }
+
+  private predict(toMs: number) {
+    const dt = (toMs - this.time) / 1000;
+    this.time = toMs;
+    this.hr += this.slope * dt;
+
+    // P = F P Fᵀ + Q,  F = [[1, dt], [0, 1]]
+    const q = PROCESS_NOISE;
+    const p00 = this.p00 + 2 * dt * this.p01 + dt * dt * this.p11;
+    const p01 = this.p01 + dt * this.p11;
+    this.p00 = p00 + (q * dt * dt * dt) / 3;
+    this.p01 = p01 + (q * dt * dt) / 2;
+    this.p11 = this.p11 + q * dt;
+  }
+
+  private estimate(): HeartRateEstimate {
+    return {
+      bpm: this.hr,
+      slope: this.slope,
+      sigmaBpm: Math.sqrt(Math.max(0, this.p00)),
+      updatedAtMs: this.lastUpdateAt,
+    };
+  }
+}
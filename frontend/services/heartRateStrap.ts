@@ -0,0 +1,216 @@
+// services/heartRateStrap.ts
+// 표준 BLE 심박 벨트 (Heart Rate Service 0x180D, Heart Rate Measurement 0x2A37 notify).
+// 러닝머신 센서의 평균 BPM:과 달리 박동마다 RR 간격을 주고 지연도 짧다.
+// ArduinoBridge가 HeartRateSensor로 열고, 측정값은 브리지의 심박수 스트림(onEcgSample)으로 합쳐진다.
+
+import { BleManager, Device, Subscription } from "react-native-ble-plx";
+import { Buffer } from "buffer";
+
+import { createLogger } from "./logger";
+import { withTimeout } from "./transport";
+
+const log = createLogger("BLE:hr");
+
+export const HEART_RATE_SERVICE_UUID = "0000180d-0000-1000-8000-00805f9b34fb";
+export const HEART_RATE_MEASUREMENT_UUID =
+  "00002a37-0000-1000-8000-00805f9b34fb";
+
+// Heart Rate Measurement flags
+const FLAG_HR_UINT16 = 0x01;
+const FLAG_CONTACT_DETECTED = 0x02;
+const FLAG_CONTACT_SUPPORTED = 0x04;
+const FLAG_ENERGY_EXPENDED = 0x08;
+const FLAG_RR_INTERVALS = 0x10;
+
+// RR 간격 단위는 1/1024 초
+const RR_UNITS_PER_SECOND = 1024;
+
+export type HeartRateMeasurement = {
+  bpm: number;
+  /** 피부 접촉 여부. 벨트가 지원하지 않으면 null */
+  contact: boolean | null;
+  /** 누적 소모 에너지 (kJ). 없으면 null */
+  energyKj: number | null;
+  /** 이 알림에 담긴 RR 간격들 (ms, 오래된 것부터). 없을 수도 있다 */
+  rrMs: number[];
+};
+
+/** Heart Rate Measurement 값을 해석한다. 길이가 모자라면 null */
+export function parseHeartRateMeasurement(
+  data: Uint8Array
+): HeartRateMeasurement | null {
+  if (data.length < 2) return null;
+  const flags = data[0];
+  let offset = 1;
+
+  let bpm: number;
+  if (flags & FLAG_HR_UINT16) {
+    if (data.length < offset + 2) return null;
+    bpm = data[offset] | (data[offset + 1] << 8);
+    offset += 2;
+  } else {
+    bpm = data[offset];
+    offset += 1;
+  }
+
+  const contact =
+    flags & FLAG_CONTACT_SUPPORTED
+      ? (flags & FLAG_CONTACT_DETECTED) !== 0
+      : null;
+
+  let energyKj: number | null = null;
+  if (flags & FLAG_ENERGY_EXPENDED) {
+    if (data.length < offset + 2) return null;
+    energyKj = data[offset] | (data[offset + 1] << 8);
+    offset += 2;
+  }
+
+  const rrMs: number[] = [];
+  if (flags & FLAG_RR_INTERVALS) {
+    for (; offset + 1 < data.length; offset += 2) {
+      const raw = data[offset] | (data[offset + 1] << 8);
+      rrMs.push(Math.round((raw * 1000) / RR_UNITS_PER_SECOND));
+    }
+  }
+
+  return { bpm, contact, energyKj, rrMs };
+}
+
+export type HeartRateSensorSink = {
+  onMeasurement(measurement: HeartRateMeasurement, arrivedAtMs: number): void;
+  /** 벨트나 OS가 연결을 끊음. close()로 직접 닫은 경우에는 호출되지 않는다 */
+  onClosed(): void;
+};
+
+export type HeartRateSensorInfo = {
+  id: string;
+  name: string;
+  rssi: number | null;
+};
+
+/** 심박 벨트 링크. Transport와 같은 모양 (테스트에서는 가짜로 바꿔 끼운다) */
+export interface HeartRateSensor {
+  readonly isOpen: boolean;
+  /** 심박 서비스를 광고하는 기기를 durationMs 동안 찾는다. 같은 기기는 한 번만 알린다 */
+  scan(
+    onFound: (sensor: HeartRateSensorInfo) => void,
+    durationMs: number
+  ): Promise<void>;
+  open(
+    deviceId: string,
+    sink: HeartRateSensorSink,
+    timeoutMs: number
+  ): Promise<void>;
+  close(): Promise<void>;
+}
+
+export class BleHeartRateSensor implements HeartRateSensor {
+  // BleManager는 네이티브 모듈을 잡으므로 처음 쓸 때 만든다
+  private manager: BleManager | null = null;
+  private device: Device | null = null;
+  private measurementSubscription: Subscription | null = null;
+  private linkLostSubscription: Subscription | null = null;
+
+  get isOpen(): boolean {
+    return this.device !== null;
+  }
+
+  private getManager(): BleManager {
+    if (!this.manager) this.manager = new BleManager();
+    return this.manager;
+  }
+
+  async scan(
+    onFound: (sensor: HeartRateSensorInfo) => void,
+    durationMs: number
+  ): Promise<void> {
+    const manager = this.getManager();
+    const seen = new Set<string>();
+
+    await new Promise<void>((resolve, reject) => {
+      const timer = setTimeout(() => {
+        manager.stopDeviceScan();
+        resolve();
+      }, durationMs);
+
+      manager.startDeviceScan(
+        [HEART_RATE_SERVICE_UUID],
+        null,
+        (error, device) => {
+          if (error) {
+            clearTimeout(timer);
+            manager.stopDeviceScan();
+            reject(error);
+            return;
+          }
+          if (!device || seen.has(device.id)) return;
+          seen.add(device.id);
+          onFound({
+            id: device.id,
+            name: device.name || device.localName || "Heart Rate Sensor",
+            rssi: device.rssi,
+          });
+        }
+      );
+    });
+  }
+
+  async open(
+    deviceId: string,
+    sink: HeartRateSensorSink,
+    timeoutMs: number
+  ): Promise<void> {
+    const manager = this.getManager();
+    const device = await withTimeout(
+      manager
+        .connectToDevice(deviceId)
+        .then((connected) => connected.discoverAllServicesAndCharacteristics()),
+      timeoutMs
+    ).catch((error) => {
+      manager.cancelDeviceConnection(deviceId).catch(() => undefined);
+      throw error;
+    });
+
+    this.device = device;
+    log.info(`Heart rate sensor connected: ${device.name || deviceId}`);
+
+    this.measurementSubscription = device.monitorCharacteristicForService(
+      HEART_RATE_SERVICE_UUID,
+      HEART_RATE_MEASUREMENT_UUID,
+      (error, characteristic) => {
+        const arrivedAtMs = Date.now();
+        // 끊김/취소도 여기로 에러가 온다. 끊김 처리는 onDeviceDisconnected가 맡는다
+        if (error || !characteristic?.value) return;
+
+        const measurement = parseHeartRateMeasurement(
+          Buffer.from(characteristic.value, "base64")
+        );
+        if (measurement) sink.onMeasurement(measurement, arrivedAtMs);
+        else log.warn("Malformed heart rate measurement");
+      }
+    );
+    this.linkLostSubscription = manager.onDeviceDisconnected(deviceId, () => {
+      if (!this.device) return;
+      this.release();
+      sink.onClosed();
+    });
+  }
+
+  async close(): Promise<void> {
+    const device = this.device;
+    this.release();
+    if (device) await device.cancelConnection();
+  }
+
+  private release() {
+    if (this.measurementSubscription) {
+      this.measurementSubscription.remove();
+      this.measurementSubscription = null;
+    }
+    if (this.linkLostSubscription) {
+      this.linkLostSubscription.remove();
+      this.linkLostSubscription = null;
+    }
+    this.device = null;
+  }
+}
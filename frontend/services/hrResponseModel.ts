@@ -0,0 +1,315 @@
+// services/hrResponseModel.ts
+// 사용자의 속도 → 심박 응답 모델 (1차 + 데드타임, FOPDT). 세션 중 실제 샘플로 온라인으로 맞춘다.
+//
+//   HR(t) = b + K · v(t),  τ · dv/dt = u(t - θ) - v(t)
+//   u: 벨트 속도 (km/h), K: 이득 (bpm per km/h), τ: 시정수 (s), θ: 데드타임 (s)
+//
+// (θ, τ) 격자의 후보마다 지연·필터한 입력 v를 돌려 두고 HR ≈ b + K·v를 지수 가중 최소제곱으로 푼 뒤,
+// 잔차가 가장 작은 후보를 쓴다. 출력 오차 방식이라 심박 잡음 때문에 τ가 짧게 치우치지 않는다.
+// 입력은 1초 격자로 다시 샘플링하므로 측정마다 할 일은 비교 한 번, 1초마다 후보 수만큼의 상수 연산.
+//
+// 예측(predict)은 지금 측정값에서 출발해 모델 출력의 변화분만 더한다 (나머지는 상수 외란으로 본다).
+// 그래서 그날 컨디션에 따라 달라지는 b는 필요 없고, K·τ·θ만 프로필별로 들고 있으면
+// 다음 세션(재연결, 프로필 전환)은 처음부터 다시 배우지 않고 그 값으로 시작한다 (warm start).
+// 기본 저장소는 메모리뿐이라 앱을 다시 켜면 새로 배운다. 영구 저장은 HrModelStore 구현을 넘겨서 한다.
+
+import { createLogger } from "./logger";
+
+const log = createLogger("HrModel");
+
+/** 저장/복원하는 모델 파라미터 */
+export type HrModelParams = {
+  /** bpm per km/h */
+  gain: number;
+  timeConstantS: number;
+  deadTimeS: number;
+  /** 맞춤 설명력 (0~1) */
+  r2: number;
+  /** 맞춤에 쓴 1초 샘플 수 (여러 세션 누적) */
+  samples: number;
+};
+
+export type HrModelSource = "none" | "stored" | "session";
+
+export type HrModelStats = {
+  ready: boolean;
+  /** 지금 쓰는 파라미터가 저장된 값인지 이번 세션에서 맞춘 값인지 */
+  source: HrModelSource;
+  params: HrModelParams | null;
+  /** 이번 세션에서 쌓은 1초 샘플 */
+  sessionSamples: number;
+};
+
+/** 프로필별 모델 저장소. 비동기라 영구 저장소로 바꿔 끼울 수 있다 (앱에는 아직 없다) */
+export type HrModelStore = {
+  load(key: string): Promise<HrModelParams | null>;
+  save(key: string, params: HrModelParams): Promise<void>;
+};
+
+/** 앱이 떠 있는 동안만 유지되는 저장소 (기본값) */
+export class MemoryHrModelStore implements HrModelStore {
+  private entries: Map<string, HrModelParams> = new Map();
+
+  async load(key: string): Promise<HrModelParams | null> {
+    const params = this.entries.get(key);
+    return params ? { ...params } : null;
+  }
+
+  async save(key: string, params: HrModelParams): Promise<void> {
+    this.entries.set(key, { ...params });
+  }
+}
+
+const SAMPLE_MS = 1000;
+// 후보 격자 (초). 저장된 값도 이 격자 위의 값이다
+const DEAD_TIMES_S = [0, 4, 8, 12, 16, 20, 25, 30];
+const TIME_CONSTANTS_S = [15, 20, 30, 40, 55, 75, 100, 130];
+// 샘플마다 곱하는 망각 계수 (유효 기억 약 8분: 심박 드리프트를 따라간다)
+const FORGET = 0.998;
+// 이만큼 샘플이 쌓이고 속도가 충분히 바뀌었고 설명력이 있어야 맞춘 값을 믿는다
+const MIN_FIT_SAMPLES = 120;
+const MIN_INPUT_STD = 0.5;
+const MIN_R2 = 0.6;
+const MIN_GAIN = 2;
+const MAX_GAIN = 30;
+// 후보 비교는 이 샘플 수마다
+const REFIT_EVERY = 10;
+// 이보다 오래 측정이 없었으면 입력 이력을 이어 붙이지 않는다
+const GAP_RESET_MS = 10000;
+
+const MAX_DELAY_STEPS = DEAD_TIMES_S[DEAD_TIMES_S.length - 1];
+const CANDIDATES = DEAD_TIMES_S.length * TIME_CONSTANTS_S.length;
+
+export class HrResponseModel {
+  // 후보 i = (데드타임 i / τ개수, τ i % τ개수)
+  private delaySteps = new Int32Array(CANDIDATES);
+  private decay = new Float64Array(CANDIDATES);
+  private filtered = new Float64Array(CANDIDATES);
+  // 후보별 가중 합: Σv, Σv², Σv·y (Σw, Σy, Σy²는 공통)
+  private sumV = new Float64Array(CANDIDATES);
+  private sumVV = new Float64Array(CANDIDATES);
+  private sumVY = new Float64Array(CANDIDATES);
+  private sumW = 0;
+  private sumY = 0;
+  private sumYY = 0;
+  private sumU = 0;
+  private sumUU = 0;
+  // 최근 1초 입력 (데드타임 동안 이미 들어간 속도)
+  private inputs = new Float64Array(MAX_DELAY_STEPS + 1);
+  private head = 0;
+  private started = false;
+  private nextSampleAt = 0;
+  private lastObservedAt = 0;
+  private latestSpeed = 0;
+  private latestBpm = 0;
+  private sessionSamples = 0;
+  // 저장된 파라미터를 맞출 때까지 쌓인 샘플 (이전 세션들)
+  private priorSamples = 0;
+
+  private active = -1;
+  private activeParams: HrModelParams | null = null;
+  private source: HrModelSource = "none";
+
+  constructor() {
+    for (let i = 0; i < CANDIDATES; i++) {
+      const deadTimeS = DEAD_TIMES_S[Math.floor(i / TIME_CONSTANTS_S.length)];
+      const timeConstantS = TIME_CONSTANTS_S[i % TIME_CONSTANTS_S.length];
+      this.delaySteps[i] = Math.round((deadTimeS * 1000) / SAMPLE_MS);
+      this.decay[i] = Math.exp(-SAMPLE_MS / 1000 / timeConstantS);
+    }
+  }
+
+  /** 예측에 쓸 수 있는 파라미터가 있다 (저장된 값 또는 이번 세션 맞춤) */
+  get isReady(): boolean {
+    return this.activeParams !== null;
+  }
+
+  /** 지금 쓰는 파라미터. 준비 전이면 null */
+  get params(): HrModelParams | null {
+    return this.activeParams;
+  }
+
+  /**
+   * 저장된 파라미터로 시작한다. 이번 세션에서 이미 맞춘 값이 있으면 그쪽을 유지한다.
+   * 격자 밖 값이나 범위를 벗어난 이득은 버린다.
+   */
+  warmStart(params: HrModelParams): boolean {
+    if (this.source === "session") return false;
+    const deadIndex = DEAD_TIMES_S.indexOf(params.deadTimeS);
+    const tauIndex = TIME_CONSTANTS_S.indexOf(params.timeConstantS);
+    if (
+      deadIndex < 0 ||
+      tauIndex < 0 ||
+      !(params.gain >= MIN_GAIN && params.gain <= MAX_GAIN)
+    ) {
+      log.warn("Ignoring stored HR model:", params);
+      return false;
+    }
+    this.active = deadIndex * TIME_CONSTANTS_S.length + tauIndex;
+    this.activeParams = { ...params };
+    this.priorSamples = params.samples;
+    this.source = "stored";
+    log.info(
+      `HR model warm start: K=${params.gain.toFixed(1)} ` +
+        `τ=${params.timeConstantS}s θ=${params.deadTimeS}s`
+    );
+    return true;
+  }
+
+  /** 합친 심박 측정 하나와 그때의 벨트 속도. atMs는 단조 증가하는 앱 시계 */
+  observe(speed: number, bpm: number, atMs: number) {
+    if (!this.started || atMs - this.lastObservedAt > GAP_RESET_MS) {
+      this.restart(speed, atMs);
+    }
+    this.lastObservedAt = atMs;
+    this.latestSpeed = speed;
+    this.latestBpm = bpm;
+    while (atMs >= this.nextSampleAt) {
+      this.sample(this.latestSpeed, this.latestBpm);
+      this.nextSampleAt += SAMPLE_MS;
+    }
+  }
+
+  /**
+   * 지금 심박이 bpm이고 앞으로 속도를 holdSpeed로 유지할 때 1초, 2초 … out.length초 뒤 심박 예측.
+   * 데드타임 동안은 이미 들어간 속도 이력을 쓴다. 준비 전이면 false.
+   */
+  predict(bpm: number, holdSpeed: number, out: Float64Array): boolean {
+    const params = this.activeParams;
+    if (!params) return false;
+    const delay = this.delaySteps[this.active];
+    const decay = this.decay[this.active];
+    const size = this.inputs.length;
+    const start = this.filtered[this.active];
+    let v = start;
+    for (let k = 1; k <= out.length; k++) {
+      const input =
+        k <= delay
+          ? this.inputs[(this.head - 1 - delay + k + size) % size]
+          : holdSpeed;
+      v = decay * v + (1 - decay) * input;
+      out[k - 1] = bpm + params.gain * (v - start);
+    }
+    return true;
+  }
+
+  getStats(): HrModelStats {
+    return {
+      ready: this.isReady,
+      source: this.source,
+      params: this.activeParams ? { ...this.activeParams } : null,
+      sessionSamples: this.sessionSamples,
+    };
+  }
+
+  /**
+   * 새 세션 (새 연결, 다른 프로필). 맞춤 합과 입력 이력을 비운다.
+   * keepParams면 지금 파라미터를 저장된 값처럼 계속 쓴다 (같은 사용자의 다음 세션).
+   */
+  reset(keepParams: boolean) {
+    this.started = false;
+    this.sessionSamples = 0;
+    this.sumW = this.sumY = this.sumYY = this.sumU = this.sumUU = 0;
+    this.sumV.fill(0);
+    this.sumVV.fill(0);
+    this.sumVY.fill(0);
+    if (keepParams && this.activeParams) {
+      this.priorSamples = this.activeParams.samples;
+      this.source = "stored";
+    } else {
+      this.priorSamples = 0;
+      this.active = -1;
+      this.activeParams = null;
+      this.source = "none";
+    }
+  }
+
+  /** 이력이 끊겼으면 지금 속도에 오래 머물러 있었던 것으로 보고 다시 잇는다 */
+  private restart(speed: number, atMs: number) {
+    this.started = true;
+    this.nextSampleAt = atMs;
+    this.inputs.fill(speed);
+    this.filtered.fill(speed);
+  }
+
+  private sample(speed: number, bpm: number) {
+    const size = this.inputs.length;
+    this.inputs[this.head] = speed;
+    this.head = (this.head + 1) % size;
+
+    this.sumW = FORGET * this.sumW + 1;
+    this.sumY = FORGET * this.sumY + bpm;
+    this.sumYY = FORGET * this.sumYY + bpm * bpm;
+    this.sumU = FORGET * this.sumU + speed;
+    this.sumUU = FORGET * this.sumUU + speed * speed;
+    for (let i = 0; i < CANDIDATES; i++) {
+      const input =
+        this.inputs[(this.head - 1 - this.delaySteps[i] + size) % size];
+      const v = this.decay[i] * this.filtered[i] + (1 - this.decay[i]) * input;
+      this.filtered[i] = v;
+      this.sumV[i] = FORGET * this.sumV[i] + v;
+      this.sumVV[i] = FORGET * this.sumVV[i] + v * v;
+      this.sumVY[i] = FORGET * this.sumVY[i] + v * bpm;
+    }
+
+    this.sessionSamples++;
+    if (
+      this.sessionSamples >= MIN_FIT_SAMPLES &&
+      this.sessionSamples % REFIT_EVERY === 0
+    ) {
+      this.refit();
+    }
+  }
+
+  /** 잔차가 가장 작은 후보를 고르고, 믿을 만하면 지금 파라미터로 삼는다 */
+  private refit() {
+    const w = this.sumW;
+    const meanU = this.sumU / w;
+    if (this.sumUU / w - meanU * meanU < MIN_INPUT_STD * MIN_INPUT_STD) return;
+    const meanY = this.sumY / w;
+    const varY = this.sumYY / w - meanY * meanY;
+    if (!(varY > 0)) return;
+
+    let best = -1;
+    let bestResidual = Infinity;
+    let bestGain = 0;
+    for (let i = 0; i < CANDIDATES; i++) {
+      const meanV = this.sumV[i] / w;
+      const varV = this.sumVV[i] / w - meanV * meanV;
+      if (!(varV > 0)) continue;
+      const cov = this.sumVY[i] / w - meanV * meanY;
+      const residual = varY - (cov * cov) / varV;
+      if (residual < bestResidual) {
+        best = i;
+        bestResidual = residual;
+        bestGain = cov / varV;
+      }
+    }
+    const r2 = 1 - bestResidual / varY;
+    if (
+      best < 0 ||
+      r2 < MIN_R2 ||
+      bestGain < MIN_GAIN ||
+      bestGain > MAX_GAIN
+    ) {
+      return;
+    }
+
+    const params: HrModelParams = {
+      gain: Math.round(bestGain * 100) / 100,
+      timeConstantS: TIME_CONSTANTS_S[best % TIME_CONSTANTS_S.length],
+      deadTimeS: DEAD_TIMES_S[Math.floor(best / TIME_CONSTANTS_S.length)],
+      r2: Math.round(r2 * 1000) / 1000,
+      samples: this.priorSamples + this.sessionSamples,
+    };
+    if (this.source !== "session" || best !== this.active) {
+      log.info(
+        `HR model fitted: K=${params.gain.toFixed(1)} ` +
+          `τ=${params.timeConstantS}s θ=${params.deadTimeS}s r²=${params.r2}`
+      );
+    }
+    this.active = best;
+    this.activeParams = params;
+    this.source = "session";
+  }
+}
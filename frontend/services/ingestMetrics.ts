@@ -0,0 +1,108 @@
+// services/ingestMetrics.ts
+// 수신 파이프라인 계측. 카운터는 단계마다 정수 증가만 하고, 시간은 LatencyHistogram에 넣는다.
+//   fanOut     : 줄/샘플 하나를 디스패치해서 모든 리스너가 끝날 때까지 (ms)
+//   endToEnd   : 청크 도착 → WorkoutProvider의 React 커밋까지 (ms)
+//   oneWay     : 기기 측정(@<ms>, 앱 시계로 환산) → 청크 도착까지 (ms). 시계 동기화된 샘플만
+// 스냅샷은 디버그 오버레이와 세션 내보내기에서 읽는다.
+
+import { LatencyHistogram, LatencySummary } from "./latencyHistogram";
+
+export type IngestCounters = {
+  bytes: number;
+  chunks: number;
+  lines: number;
+  frames: number;
+  /** 접두사는 맞지만 값이 숫자가 아닌 줄 (isNaN으로 버려진 값) */
+  parseFailures: number;
+  /** 알 수 없는 접두사 */
+  unknownLines: number;
+  crcErrors: number;
+  /** 수신 버퍼 오버플로우로 버린 바이트/프레임 */
+  overflowBytes: number;
+  overflowFrames: number;
+  /** 네이티브 큐가 가득 차서 버린 샘플 */
+  queueDrops: number;
+  /** 네이티브 텍스트 줄 큐가 가득 차서 버린 줄 (ACK/PONG 유실 → 재전송 원인) */
+  textDrops: number;
+};
+
+export type IngestMetricsSnapshot = {
+  counters: IngestCounters;
+  fanOut: LatencySummary;
+  endToEnd: LatencySummary;
+  oneWay: LatencySummary;
+  /** 스냅샷 시각 (epoch ms) */
+  takenAt: number;
+};
+
+export type Clock = () => number;
+
+// Hermes/RN의 performance.now()는 서브 ms 해상도. 없으면 Date.now()
+const perf = (globalThis as { performance?: { now(): number } }).performance;
+export const monotonicNow: Clock = perf
+  ? () => perf.now()
+  : () => Date.now();
+
+export function emptyCounters(): IngestCounters {
+  return {
+    bytes: 0,
+    chunks: 0,
+    lines: 0,
+    frames: 0,
+    parseFailures: 0,
+    unknownLines: 0,
+    crcErrors: 0,
+    overflowBytes: 0,
+    overflowFrames: 0,
+    queueDrops: 0,
+    textDrops: 0,
+  };
+}
+
+export class IngestMetrics {
+  /** JS 경로에서 직접 센 값. 디코더/프레이머/네이티브 통계는 스냅샷 때 합친다 */
+  readonly counters: IngestCounters = emptyCounters();
+  readonly fanOut: LatencyHistogram = new LatencyHistogram();
+  readonly endToEnd: LatencyHistogram = new LatencyHistogram();
+  readonly oneWay: LatencyHistogram = new LatencyHistogram();
+
+  recordChunk(bytes: number) {
+    this.counters.chunks++;
+    this.counters.bytes += bytes;
+  }
+
+  recordFanOut(startedAt: number) {
+    this.fanOut.record(monotonicNow() - startedAt);
+  }
+
+  /** arrivedAtMs는 Date.now() 기준 (네이티브 읽기 스레드 타임스탬프와 같은 시계) */
+  recordCommit(arrivedAtMs: number) {
+    this.endToEnd.record(Date.now() - arrivedAtMs);
+  }
+
+  /** RTT 비대칭 때문에 조금 음수가 나올 수 있다. 버리면 분포가 치우치므로 0으로 센다 */
+  recordOneWay(ms: number) {
+    this.oneWay.record(Math.max(0, ms));
+  }
+
+  snapshot(extra: Partial<IngestCounters> = {}): IngestMetricsSnapshot {
+    const counters = { ...this.counters };
+    (Object.keys(extra) as (keyof IngestCounters)[]).forEach((key) => {
+      counters[key] += extra[key] ?? 0;
+    });
+    return {
+      counters,
+      fanOut: this.fanOut.summary(),
+      endToEnd: this.endToEnd.summary(),
+      oneWay: this.oneWay.summary(),
+      takenAt: Date.now(),
+    };
+  }
+
+  reset() {
+    Object.assign(this.counters, emptyCounters());
+    this.fanOut.reset();
+    this.endToEnd.reset();
+    this.oneWay.reset();
+  }
+}
@@ -0,0 +1,403 @@
+// services/intervalProgram.ts
+// 인터벌 운동 프로그램. 프로그램은 구간(목표 속도 또는 심박 구간 + 길이)의 나열이고,
+// compileProgram()이 이를 구간 경계 시각 배열 중심의 압축된 스케줄로 바꾼다
+// (연달아 같은 목표인 구간은 합치고, 목표는 타입 배열에 담는다).
+//
+// ProgramRunner는 시작 시각 기준 절대 시각으로 다음 이벤트를 잡으므로 타이머 지연이 쌓이지 않는다.
+// 각 구간의 목표는 경계보다 lead만큼 먼저 보낸다(pre-staging). lead는 지금까지 잰
+// 속도 명령 완료 시간(송신 큐 대기 + write, ACK 모드면 ACK까지)의 p95라서,
+// 인터벌 전환이 직렬 링크/기기 처리 지연만큼 늦지 않고 경계에 맞춰 도착한다.
+// ACK 모드가 아니면 lead는 큐 대기와 write 시간만 덮는다: 링크 전송과 기기 처리 시간은
+// 재지 못하므로 그만큼은 경계보다 늦게 반영될 수 있다.
+// 심박 구간 목표는 SpeedController에 넘기고, 속도 목표 구간에서는 속도 제어를 끈다.
+
+import { Clock, monotonicNow } from "./ingestMetrics";
+import { LatencyHistogram, LatencySummary } from "./latencyHistogram";
+import { createLogger } from "./logger";
+import { HeartRateBand } from "./speedController";
+
+const log = createLogger("Program");
+
+export type ProgramSegment = {
+  label: string;
+  durationS: number;
+  /** 고정 속도 (km/h). band와 둘 중 하나만 */
+  speed?: number;
+  /** 이 심박 구간(bpm)에 머물도록 속도 자동 조절 */
+  band?: HeartRateBand;
+};
+
+export type WorkoutProgram = {
+  name: string;
+  segments: ProgramSegment[];
+};
+
+/** 구간 i는 [startMs[i], startMs[i + 1]) 동안. 속도 구간이면 bandLow/High가 0, 심박 구간이면 speed가 NaN */
+export type CompiledProgram = {
+  name: string;
+  count: number;
+  startMs: Float64Array;
+  speed: Float32Array;
+  bandLow: Uint16Array;
+  bandHigh: Uint16Array;
+  labels: string[];
+  totalMs: number;
+};
+
+const MAX_PROGRAM_SPEED = 20;
+
+/** 구간 목록을 실행용 스케줄로. 목표가 없거나 둘 다 있거나 길이가 0 이하인 구간은 에러 */
+export function compileProgram(program: WorkoutProgram): CompiledProgram {
+  const merged: ProgramSegment[] = [];
+  program.segments.forEach((segment, i) => {
+    const hasSpeed = segment.speed !== undefined;
+    if (hasSpeed === (segment.band !== undefined)) {
+      throw new Error(`Segment ${i} needs exactly one of speed or band`);
+    }
+    if (!(segment.durationS > 0)) {
+      throw new Error(`Segment ${i} has invalid duration`);
+    }
+    if (
+      hasSpeed &&
+      !(segment.speed! >= 0 && segment.speed! <= MAX_PROGRAM_SPEED)
+    ) {
+      throw new Error(`Segment ${i} has invalid speed: ${segment.speed}`);
+    }
+    if (segment.band && !(segment.band.low < segment.band.high)) {
+      throw new Error(`Segment ${i} has invalid band`);
+    }
+
+    const previous = merged[merged.length - 1];
+    if (previous && sameTarget(previous, segment)) {
+      previous.durationS += segment.durationS;
+      return;
+    }
+    merged.push({ ...segment });
+  });
+  if (merged.length === 0) throw new Error("Program has no segments");
+
+  const count = merged.length;
+  const compiled: CompiledProgram = {
+    name: program.name,
+    count,
+    startMs: new Float64Array(count + 1),
+    speed: new Float32Array(count),
+    bandLow: new Uint16Array(count),
+    bandHigh: new Uint16Array(count),
+    labels: merged.map((segment) => segment.label),
+    totalMs: 0,
+  };
+  let t = 0;
+  merged.forEach((segment, i) => {
+    compiled.startMs[i] = t;
+    compiled.speed[i] = segment.speed ?? NaN;
+    compiled.bandLow[i] = segment.band?.low ?? 0;
+    compiled.bandHigh[i] = segment.band?.high ?? 0;
+    t += Math.round(segment.durationS * 1000);
+  });
+  compiled.startMs[count] = t;
+  compiled.totalMs = t;
+  return compiled;
+}
+
+function sameTarget(a: ProgramSegment, b: ProgramSegment): boolean {
+  if (a.speed !== undefined || b.speed !== undefined) {
+    return a.speed === b.speed;
+  }
+  return a.band!.low === b.band!.low && a.band!.high === b.band!.high;
+}
+
+type HiitLevel = {
+  workSpeed: number;
+  restSpeed: number;
+  rounds: number;
+};
+
+// 프로필 운동 수준별 질주/회복 속도 (km/h)
+const HIIT_LEVELS: Record<string, HiitLevel> = {
+  Beginner: { workSpeed: 9, restSpeed: 5, rounds: 6 },
+  Intermediate: { workSpeed: 11, restSpeed: 6, rounds: 8 },
+  Advanced: { workSpeed: 13, restSpeed: 6.5, rounds: 10 },
+};
+const HIIT_WARMUP_S = 240;
+const HIIT_WORK_S = 30;
+const HIIT_REST_S = 90;
+const HIIT_COOLDOWN_S = 180;
+const HIIT_COOLDOWN_SPEED = 4.5;
+
+/**
+ * 기본 HIIT: 심박 구간으로 워밍업 → 질주/회복 반복 → 걷기로 마무리.
+ * 30초 질주는 심박이 따라오기에 너무 짧으므로 인터벌은 속도로 지정한다.
+ */
+export function createHiitProgram(
+  warmupBand: HeartRateBand,
+  level: string = "Beginner"
+): WorkoutProgram {
+  const { workSpeed, restSpeed, rounds } =
+    HIIT_LEVELS[level] ?? HIIT_LEVELS.Beginner;
+  const segments: ProgramSegment[] = [
+    { label: "워밍업", durationS: HIIT_WARMUP_S, band: warmupBand },
+  ];
+  for (let round = 1; round <= rounds; round++) {
+    segments.push({
+      label: `질주 ${round}/${rounds}`,
+      durationS: HIIT_WORK_S,
+      speed: workSpeed,
+    });
+    segments.push({
+      label: `회복 ${round}/${rounds}`,
+      durationS: HIIT_REST_S,
+      speed: restSpeed,
+    });
+  }
+  segments.push({
+    label: "마무리",
+    durationS: HIIT_COOLDOWN_S,
+    speed: HIIT_COOLDOWN_SPEED,
+  });
+  return { name: "HIIT", segments };
+}
+
+/** 실행 대상. ArduinoBridge가 송신 큐와 SpeedController로 채운다 */
+export type ProgramTarget = {
+  sendSpeed(speed: number): Promise<void>;
+  /** 속도 제어를 켜거나 구간만 바꾼다 */
+  trackBand(band: HeartRateBand): void;
+  stopTracking(): void;
+  /** 송신 큐가 잰 속도 명령 완료 시간 p95 (ms). ACK 모드가 아니면 write 완료까지만. 없으면 NaN */
+  commandLatencyMs(): number;
+};
+
+export type ProgramState = "idle" | "running" | "finished";
+
+export type ProgramStatus = {
+  state: ProgramState;
+  name: string | null;
+  /** 지금 구간 (running이 아니면 -1) */
+  index: number;
+  count: number;
+  label: string | null;
+  /** 지금 구간이 끝나는 시각 (epoch ms, 화면 카운트다운용) */
+  segmentEndsAt: number;
+  endsAt: number;
+};
+
+export type ProgramStats = {
+  /** 지금 쓰는 선행 시간 (ms) */
+  leadMs: number;
+  staged: number;
+  /** 명령 완료가 경계 이전이었던 구간 수 */
+  onTime: number;
+  failures: number;
+  /** 미리 보낸 속도 명령 → 완료 */
+  stageToCommand: LatencySummary;
+  /** 경계보다 늦게 완료된 만큼 (늦은 것만) */
+  landingLate: LatencySummary;
+};
+
+type StatusListener = (status: ProgramStatus) => void;
+
+// 측정값이 없을 때의 선행 시간
+const DEFAULT_LEAD_MS = 250;
+// 측정값에 더하는 여유 (타이머가 늦게 깨는 만큼)
+const LEAD_MARGIN_MS = 20;
+const MAX_LEAD_MS = 3000;
+// 직전 구간이 짧으면 그 구간의 절반보다 먼저 보내지 않는다
+const MAX_LEAD_FRACTION = 0.5;
+
+export class ProgramRunner {
+  private target: ProgramTarget;
+  private now: Clock;
+  private program: CompiledProgram | null = null;
+  private state: ProgramState = "idle";
+  private timer: ReturnType<typeof setTimeout> | null = null;
+  // 프로그램 0초의 monotonic 시각과 epoch 시각
+  private t0 = 0;
+  private epochT0 = 0;
+  // 다음에 보낼 구간과 다음에 시작할 구간
+  private nextStage = 0;
+  private current = -1;
+  private stageAt = 0;
+  private leadMs = DEFAULT_LEAD_MS;
+  private listeners: Set<StatusListener> = new Set();
+
+  private counters = { staged: 0, onTime: 0, failures: 0 };
+  private stageToCommand = new LatencyHistogram();
+  private landingLate = new LatencyHistogram();
+
+  constructor(target: ProgramTarget, now: Clock = monotonicNow) {
+    this.target = target;
+    this.now = now;
+  }
+
+  get isRunning(): boolean {
+    return this.state === "running";
+  }
+
+  /** 첫 구간도 경계에 맞게 도착하도록 프로그램 0초는 lead 뒤로 잡는다 */
+  start(program: CompiledProgram) {
+    this.stop();
+    this.program = program;
+    this.state = "running";
+    this.leadMs = this.measureLead();
+    const now = this.now();
+    this.t0 = now + this.leadMs;
+    this.epochT0 = Math.round(Date.now() + this.leadMs);
+    this.nextStage = 0;
+    this.current = -1;
+    log.info(
+      `Program ${program.name}: ${program.count} segments, ` +
+        `${Math.round(program.totalMs / 1000)} s, ` +
+        `lead ${Math.round(this.leadMs)} ms`
+    );
+    this.stageAt = now;
+    this.run();
+  }
+
+  stop() {
+    if (this.timer) {
+      clearTimeout(this.timer);
+      this.timer = null;
+    }
+    if (this.state !== "running") return;
+    log.info("Program stopped");
+    this.state = "idle";
+    this.current = -1;
+    this.notify();
+  }
+
+  /** 재연결 후 지금 구간의 목표를 다시 보낸다 (재연결 중에 보낸 명령은 실패했을 수 있다) */
+  restage() {
+    if (this.state !== "running" || this.current < 0) return;
+    this.apply(this.current, false);
+  }
+
+  getStatus(): ProgramStatus {
+    const program = this.program;
+    const running = this.state === "running" && this.current >= 0;
+    return {
+      state: this.state,
+      name: program?.name ?? null,
+      index: running ? this.current : -1,
+      count: program?.count ?? 0,
+      label: running ? program!.labels[this.current] : null,
+      segmentEndsAt: running
+        ? this.epochT0 + program!.startMs[this.current + 1]
+        : 0,
+      endsAt: program ? this.epochT0 + program.totalMs : 0,
+    };
+  }
+
+  onStatusChange(listener: StatusListener) {
+    this.listeners.add(listener);
+    return () => this.listeners.delete(listener);
+  }
+
+  getStats(): ProgramStats {
+    return {
+      leadMs: Math.round(this.leadMs),
+      ...this.counters,
+      stageToCommand: this.stageToCommand.summary(),
+      landingLate: this.landingLate.summary(),
+    };
+  }
+
+  /** 지금까지 도달한 모든 이벤트(미리 보내기, 구간 시작, 끝)를 처리하고 다음 이벤트를 잡는다 */
+  private run() {
+    this.timer = null;
+    const program = this.program!;
+    const now = this.now();
+
+    while (this.nextStage < program.count && this.stageAt <= now) {
+      this.apply(this.nextStage, true);
+      this.nextStage++;
+      this.stageAt = this.computeStageAt(this.nextStage);
+    }
+
+    let changed = false;
+    while (
+      this.current + 1 < program.count &&
+      this.t0 + program.startMs[this.current + 1] <= now
+    ) {
+      this.current++;
+      changed = true;
+    }
+    if (changed) {
+      log.info(
+        `Segment ${this.current + 1}/${program.count}:`,
+        program.labels[this.current]
+      );
+      this.notify();
+    }
+
+    const endAt = this.t0 + program.totalMs;
+    if (now >= endAt) {
+      log.info(`Program ${program.name} finished`);
+      this.state = "finished";
+      this.target.stopTracking();
+      this.notify();
+      return;
+    }
+
+    const nextBoundary =
+      this.current + 1 < program.count
+        ? this.t0 + program.startMs[this.current + 1]
+        : endAt;
+    const next =
+      this.nextStage < program.count
+        ? Math.min(this.stageAt, nextBoundary)
+        : nextBoundary;
+    this.timer = setTimeout(() => this.run(), Math.max(0, next - now));
+  }
+
+  private computeStageAt(index: number): number {
+    const program = this.program!;
+    if (index >= program.count) return Infinity;
+    const previousMs = program.startMs[index] - program.startMs[index - 1];
+    this.leadMs = this.measureLead();
+    const lead = Math.min(this.leadMs, previousMs * MAX_LEAD_FRACTION);
+    return this.t0 + program.startMs[index] - lead;
+  }
+
+  private measureLead(): number {
+    const own = this.stageToCommand.percentile(95);
+    const measured = Number.isNaN(own) ? this.target.commandLatencyMs() : own;
+    if (Number.isNaN(measured)) return DEFAULT_LEAD_MS;
+    return Math.min(MAX_LEAD_MS, measured + LEAD_MARGIN_MS);
+  }
+
+  private apply(index: number, staged: boolean) {
+    const program = this.program!;
+    const speed = program.speed[index];
+    if (Number.isNaN(speed)) {
+      this.target.trackBand({
+        low: program.bandLow[index],
+        high: program.bandHigh[index],
+      });
+      return;
+    }
+
+    this.target.stopTracking();
+    const stagedAt = this.now();
+    const boundaryAt = this.t0 + program.startMs[index];
+    if (staged) this.counters.staged++;
+    this.target.sendSpeed(Number(speed.toFixed(1))).then(
+      () => {
+        if (!staged) return;
+        const doneAt = this.now();
+        this.stageToCommand.record(doneAt - stagedAt);
+        if (doneAt <= boundaryAt) this.counters.onTime++;
+        else this.landingLate.record(doneAt - boundaryAt);
+      },
+      (e) => {
+        this.counters.failures++;
+        log.warn(`Could not send segment ${index + 1} speed:`, e);
+      }
+    );
+  }
+
+  private notify() {
+    const status = this.getStatus();
+    this.listeners.forEach((listener) => listener(status));
+  }
+}
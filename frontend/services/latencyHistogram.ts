@@ -0,0 +1,97 @@
+// services/latencyHistogram.ts
+// 지연 시간(ms) 히스토그램. 0.1 ms 단위 값을 로그-선형 버킷(2의 거듭제곱 구간마다 16칸)에
+// 세므로 메모리가 고정이고 기록은 O(1)이다. 백분위 오차는 버킷 폭의 절반(약 3%) 이내.
+
+const UNITS_PER_MS = 10;
+const SUB_BUCKET_BITS = 4;
+const SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+// 약 100초(2^20 단위)까지 구분하고 그 이상은 마지막 버킷에 넣는다
+const MAX_SHIFT = 20 - SUB_BUCKET_BITS;
+const BUCKET_COUNT = SUB_BUCKETS * (MAX_SHIFT + 2);
+
+export type LatencySummary = {
+  count: number;
+  min: number;
+  max: number;
+  mean: number;
+  p50: number;
+  p95: number;
+  p99: number;
+};
+
+function bucketIndex(units: number): number {
+  if (units < 2 * SUB_BUCKETS) return units;
+  const shift = Math.min(
+    31 - Math.clz32(units) - SUB_BUCKET_BITS,
+    MAX_SHIFT
+  );
+  const sub = Math.min(units >>> shift, 2 * SUB_BUCKETS - 1);
+  return SUB_BUCKETS * (shift + 1) + (sub - SUB_BUCKETS);
+}
+
+/** 버킷 중앙값 (ms) */
+function bucketMidpoint(index: number): number {
+  if (index < 2 * SUB_BUCKETS) return (index + 0.5) / UNITS_PER_MS;
+  const shift = Math.floor(index / SUB_BUCKETS) - 1;
+  const sub = (index % SUB_BUCKETS) + SUB_BUCKETS;
+  return ((sub + 0.5) * 2 ** shift) / UNITS_PER_MS;
+}
+
+export class LatencyHistogram {
+  private buckets: Uint32Array = new Uint32Array(BUCKET_COUNT);
+  private total = 0;
+  private sum = 0;
+  private minValue = Infinity;
+  private maxValue = 0;
+
+  get count(): number {
+    return this.total;
+  }
+
+  record(ms: number) {
+    if (!(ms >= 0)) return;
+    const units = Math.round(ms * UNITS_PER_MS);
+    this.buckets[bucketIndex(units)]++;
+    this.total++;
+    this.sum += ms;
+    if (ms < this.minValue) this.minValue = ms;
+    if (ms > this.maxValue) this.maxValue = ms;
+  }
+
+  /** p(0~100) 백분위 값 (ms). 기록이 없으면 NaN */
+  percentile(p: number): number {
+    if (this.total === 0) return NaN;
+    const rank = Math.max(1, Math.ceil((p / 100) * this.total));
+    let seen = 0;
+    for (let i = 0; i < BUCKET_COUNT; i++) {
+      seen += this.buckets[i];
+      if (seen >= rank) {
+        return Math.min(
+          this.maxValue,
+          Math.max(this.minValue, bucketMidpoint(i))
+        );
+      }
+    }
+    return this.maxValue;
+  }
+
+  summary(): LatencySummary {
+    return {
+      count: this.total,
+      min: this.total > 0 ? this.minValue : NaN,
+      max: this.total > 0 ? this.maxValue : NaN,
+      mean: this.total > 0 ? this.sum / this.total : NaN,
+      p50: this.percentile(50),
+      p95: this.percentile(95),
+      p99: this.percentile(99),
+    };
+  }
+
+  reset() {
+    this.buckets.fill(0);
+    this.total = 0;
+    this.sum = 0;
+    this.minValue = Infinity;
+    this.maxValue = 0;
+  }
+}
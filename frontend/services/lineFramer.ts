@@ -0,0 +1,402 @@
+// services/lineFramer.ts
+// HC-06 수신 바이트를 고정 크기 링 버퍼에 쌓고, 각 바이트를 한 번만 스캔해서
+// 줄 종결자(\r, \r\n, \n, 리터럴 "\\r")를 찾는다. 완성된 줄은 복사 없이 LineView로 전달한다.
+// 종결자 없이 버퍼가 가득 차면 전체를 비우지 않고, 다음 프레임 시작 위치까지만 버리고 재동기화한다.
+// 재동기화 뒤 첫 줄은 종결자가 빠진 프레임들이 붙어 있을 수 있으므로 프레임 시작마다 잘라서 전달한다.
+
+import { createLogger } from "./logger";
+
+const log = createLogger("BT");
+
+const CR = 0x0d;
+const LF = 0x0a;
+const SPACE = 0x20;
+const TAB = 0x09;
+const BACKSLASH = 0x5c;
+const LOWER_R = 0x72;
+const PLUS = 0x2b;
+const MINUS = 0x2d;
+const DOT = 0x2e;
+const DIGIT_0 = 0x30;
+const DIGIT_9 = 0x39;
+const UPPER_A = 0x41;
+const UPPER_Z = 0x5a;
+
+const DEFAULT_CAPACITY = 512;
+
+function roundUpPow2(n: number): number {
+  let size = 1;
+  while (size < n) size <<= 1;
+  return size;
+}
+
+function isDigit(b: number): boolean {
+  return b >= DIGIT_0 && b <= DIGIT_9;
+}
+
+function isBlank(b: number): boolean {
+  return b === SPACE || b === TAB;
+}
+
+function isUpper(b: number): boolean {
+  return b >= UPPER_A && b <= UPPER_Z;
+}
+
+/**
+ * 용량이 2의 거듭제곱인 바이트 링 버퍼.
+ * head/tail은 계속 증가하는 절대 위치이고, 실제 인덱스는 mask로 구한다.
+ */
+export class ByteRingBuffer {
+  readonly bytes: Uint8Array;
+  readonly mask: number;
+  private head = 0;
+  private tail = 0;
+
+  constructor(capacity: number = DEFAULT_CAPACITY) {
+    const size = roundUpPow2(Math.max(2, capacity));
+    this.bytes = new Uint8Array(size);
+    this.mask = size - 1;
+  }
+
+  get capacity(): number {
+    return this.bytes.length;
+  }
+
+  get length(): number {
+    return this.head - this.tail;
+  }
+
+  /** 다음 바이트가 쓰일 절대 위치 */
+  get end(): number {
+    return this.head;
+  }
+
+  /** 가장 오래된 바이트의 절대 위치 */
+  get start(): number {
+    return this.tail;
+  }
+
+  isFull(): boolean {
+    return this.head - this.tail >= this.bytes.length;
+  }
+
+  push(byte: number): boolean {
+    if (this.isFull()) return false;
+    this.bytes[this.head & this.mask] = byte;
+    this.head++;
+    return true;
+  }
+
+  byteAt(pos: number): number {
+    return this.bytes[pos & this.mask];
+  }
+
+  /** pos 이전의 바이트를 모두 버린다 */
+  discardUntil(pos: number) {
+    this.tail = Math.min(Math.max(pos, this.tail), this.head);
+  }
+
+  clear() {
+    this.tail = this.head;
+  }
+}
+
+/**
+ * 링 버퍼 위의 한 줄을 가리키는 뷰. 콜백 안에서만 유효하고 재사용된다.
+ * 문자열을 만들지 않고 접두사 비교/숫자 파싱을 할 수 있다.
+ */
+export class LineView {
+  private ring: ByteRingBuffer;
+  private begin = 0;
+  private finish = 0;
+
+  constructor(ring: ByteRingBuffer) {
+    this.ring = ring;
+  }
+
+  /** @internal framer 전용 */
+  set(begin: number, finish: number): this {
+    this.begin = begin;
+    this.finish = finish;
+    return this;
+  }
+
+  get length(): number {
+    return this.finish - this.begin;
+  }
+
+  byteAt(index: number): number {
+    return this.ring.byteAt(this.begin + index);
+  }
+
+  startsWith(prefix: string, offset: number = 0): boolean {
+    if (offset + prefix.length > this.length) return false;
+    for (let i = 0; i < prefix.length; i++) {
+      if (this.byteAt(offset + i) !== prefix.charCodeAt(i)) return false;
+    }
+    return true;
+  }
+
+  indexOf(byte: number, from: number = 0): number {
+    for (let i = from; i < this.length; i++) {
+      if (this.byteAt(i) === byte) return i;
+    }
+    return -1;
+  }
+
+  private skipBlank(offset: number): number {
+    while (offset < this.length && isBlank(this.byteAt(offset))) offset++;
+    return offset;
+  }
+
+  /** parseInt(str.substring(offset), 10)과 같은 결과 (숫자가 없으면 NaN) */
+  parseIntAt(offset: number = 0): number {
+    let i = this.skipBlank(offset);
+    let sign = 1;
+    if (i < this.length) {
+      const b = this.byteAt(i);
+      if (b === MINUS || b === PLUS) {
+        sign = b === MINUS ? -1 : 1;
+        i++;
+      }
+    }
+
+    let value = 0;
+    let digits = 0;
+    while (i < this.length && isDigit(this.byteAt(i))) {
+      value = value * 10 + (this.byteAt(i) - DIGIT_0);
+      digits++;
+      i++;
+    }
+    return digits > 0 ? sign * value : NaN;
+  }
+
+  /** 부호/정수부/소수부만 지원하는 parseFloat (지수 표기 없음) */
+  parseFloatAt(offset: number = 0): number {
+    let i = this.skipBlank(offset);
+    let sign = 1;
+    if (i < this.length) {
+      const b = this.byteAt(i);
+      if (b === MINUS || b === PLUS) {
+        sign = b === MINUS ? -1 : 1;
+        i++;
+      }
+    }
+
+    let mantissa = 0;
+    let digits = 0;
+    let scale = 1;
+    while (i < this.length && isDigit(this.byteAt(i))) {
+      mantissa = mantissa * 10 + (this.byteAt(i) - DIGIT_0);
+      digits++;
+      i++;
+    }
+    if (i < this.length && this.byteAt(i) === DOT) {
+      i++;
+      while (i < this.length && isDigit(this.byteAt(i))) {
+        mantissa = mantissa * 10 + (this.byteAt(i) - DIGIT_0);
+        scale *= 10;
+        digits++;
+        i++;
+      }
+    }
+    return digits > 0 ? (sign * mantissa) / scale : NaN;
+  }
+
+  /** offset부터 끝까지를 문자열로 만든다 (텍스트 채널/로그용, 할당 발생) */
+  slice(offset: number = 0): string {
+    let out = "";
+    for (let i = offset; i < this.length; i++) {
+      out += String.fromCharCode(this.byteAt(i));
+    }
+    return out;
+  }
+
+  toString(): string {
+    return this.slice(0);
+  }
+}
+
+export type LineHandler = (line: LineView) => void;
+
+export type FramerStats = {
+  /** 재동기화로 버린 바이트 수 */
+  droppedBytes: number;
+  /** 재동기화로 버린 (불완전한) 프레임 수 */
+  droppedFrames: number;
+};
+
+export class LineFramer {
+  private ring: ByteRingBuffer;
+  private view: LineView;
+  private onLine: LineHandler;
+  private frameStarts: readonly string[];
+  private keepTail: number;
+  private pendingBackslash = false;
+  // 재동기화 이후 아직 종결자를 만나지 않음 (현재 줄에 여러 프레임이 붙어 있을 수 있다)
+  private resynced = false;
+  private stats: FramerStats = { droppedBytes: 0, droppedFrames: 0 };
+
+  /**
+   * @param frameStarts 유효한 프레임 시작 접두사 (예: "BPM:").
+   *   비어 있으면 대문자 토큰의 시작을 프레임 시작으로 본다.
+   */
+  constructor(
+    onLine: LineHandler,
+    capacity: number = DEFAULT_CAPACITY,
+    frameStarts: readonly string[] = []
+  ) {
+    this.ring = new ByteRingBuffer(capacity);
+    this.view = new LineView(this.ring);
+    this.onLine = onLine;
+    this.frameStarts = frameStarts;
+    // 버퍼 끝에 걸친 접두사 조각은 버리지 않고 남긴다
+    this.keepTail = frameStarts.reduce((m, p) => Math.max(m, p.length - 1), 0);
+  }
+
+  get buffered(): number {
+    return this.ring.length;
+  }
+
+  getStats(): FramerStats {
+    return { ...this.stats };
+  }
+
+  resetStats() {
+    this.stats.droppedBytes = 0;
+    this.stats.droppedFrames = 0;
+  }
+
+  /** onDataReceived가 넘겨주는 문자열 청크 (1문자 = 1바이트) */
+  pushString(chunk: string) {
+    for (let i = 0; i < chunk.length; i++) {
+      this.pushByte(chunk.charCodeAt(i) & 0xff);
+    }
+  }
+
+  pushBytes(bytes: Uint8Array, offset: number = 0, length?: number) {
+    const stop = length === undefined ? bytes.length : offset + length;
+    for (let i = offset; i < stop; i++) {
+      this.pushByte(bytes[i]);
+    }
+  }
+
+  reset() {
+    this.ring.clear();
+    this.pendingBackslash = false;
+    this.resynced = false;
+  }
+
+  pushByte(b: number) {
+    if (b === CR || b === LF) {
+      // \r\n 의 \n 은 빈 줄이 되어 emit에서 무시된다
+      this.emit(this.ring.end);
+      return;
+    }
+
+    if (this.pendingBackslash && b === LOWER_R) {
+      // 리터럴 "\\r": 이미 버퍼에 들어간 백슬래시는 줄에서 제외
+      this.emit(this.ring.end - 1);
+      return;
+    }
+    this.pendingBackslash = b === BACKSLASH;
+
+    if (!this.ring.push(b)) {
+      // 버퍼 폭주: 가장 오래된 프레임 하나만 버리고 나머지는 계속 파싱
+      this.resync();
+      this.ring.push(b);
+    }
+  }
+
+  private resync() {
+    const start = this.ring.start;
+    const end = this.ring.end;
+
+    let next = -1;
+    for (let pos = start + 1; pos < end; pos++) {
+      if (this.isFrameStartAt(pos, end)) {
+        next = pos;
+        break;
+      }
+    }
+    if (next < 0) {
+      next = Math.max(start + 1, end - this.keepTail);
+    }
+
+    if (this.stats.droppedFrames === 0) {
+      log.warn("Buffer overflow, resynchronizing");
+    }
+    this.stats.droppedBytes += next - start;
+    this.stats.droppedFrames++;
+    this.ring.discardUntil(next);
+    this.resynced = true;
+  }
+
+  private isFrameStartAt(pos: number, end: number): boolean {
+    if (this.frameStarts.length === 0) {
+      return (
+        isUpper(this.ring.byteAt(pos)) && !isUpper(this.ring.byteAt(pos - 1))
+      );
+    }
+
+    for (const prefix of this.frameStarts) {
+      let matched = true;
+      // 버퍼 끝에서 잘린 접두사도 시작으로 인정
+      for (let i = 0; i < prefix.length && pos + i < end; i++) {
+        if (this.ring.byteAt(pos + i) !== prefix.charCodeAt(i)) {
+          matched = false;
+          break;
+        }
+      }
+      if (matched) return true;
+    }
+    return false;
+  }
+
+  /** pos에서 접두사 하나가 end 안에 온전히 들어 있는지 */
+  private isCompleteFrameStartAt(pos: number, end: number): boolean {
+    for (const prefix of this.frameStarts) {
+      if (pos + prefix.length > end) continue;
+      let matched = true;
+      for (let i = 0; i < prefix.length; i++) {
+        if (this.ring.byteAt(pos + i) !== prefix.charCodeAt(i)) {
+          matched = false;
+          break;
+        }
+      }
+      if (matched) return true;
+    }
+    return false;
+  }
+
+  private emit(lineEnd: number) {
+    const start = this.ring.start;
+    if (this.resynced && this.frameStarts.length > 0) {
+      // 종결자가 빠져 붙은 프레임(예: "SPD:4.5BPM:71")을 프레임 시작마다 나눈다.
+      // 대문자 휴리스틱으로는 "STS:Running" 같은 값도 잘리므로 접두사 목록이 있을 때만 한다.
+      let segment = start;
+      for (let pos = start + 1; pos < lineEnd; pos++) {
+        if (this.isCompleteFrameStartAt(pos, lineEnd)) {
+          this.emitRange(segment, pos);
+          segment = pos;
+        }
+      }
+      this.emitRange(segment, lineEnd);
+    } else {
+      this.emitRange(start, lineEnd);
+    }
+
+    this.ring.clear();
+    this.pendingBackslash = false;
+    this.resynced = false;
+  }
+
+  private emitRange(begin: number, finish: number) {
+    while (begin < finish && isBlank(this.ring.byteAt(begin))) begin++;
+    while (finish > begin && isBlank(this.ring.byteAt(finish - 1))) finish--;
+
+    if (finish > begin) {
+      this.onLine(this.view.set(begin, finish));
+    }
+  }
+}
@@ -0,0 +1,108 @@
+// services/linkWatchdog.ts
+// 스트림별 도착 간격 감시. 마지막 수신 후 budget(= 예상 주기 × budgetFactor)이 지나면
+// 그 스트림을 stale로 표시하고, 감시 중인 어떤 스트림도 들어오지 않으면 링크 정지(stall)로 본다.
+// 샘플마다 하는 일은 타임스탬프 기록뿐이고, 판정은 고정 주기 타이머에서 한다.
+
+export type LinkWatchdogOptions = {
+  /** 기기가 샘플을 보내는 예상 주기 */
+  expectedPeriodMs?: number;
+  /** 예상 주기의 몇 배까지 기다릴지 */
+  budgetFactor?: number;
+};
+
+export type LinkWatchdogCallbacks<K extends string> = {
+  /** 스트림의 stale 여부가 바뀔 때 */
+  onStreamStale: (stream: K, stale: boolean) => void;
+  /** 모든 스트림이 멈추거나 다시 들어오기 시작할 때 */
+  onLinkStall: (stalled: boolean) => void;
+};
+
+export const DEFAULT_EXPECTED_PERIOD_MS = 1000;
+export const DEFAULT_BUDGET_FACTOR = 1.5;
+// 판정 타이머는 budget의 1/4 간격 (감지 지연 최대 budget × 1.25)
+const CHECKS_PER_BUDGET = 4;
+
+export class LinkWatchdog<K extends string> {
+  private streams: K[];
+  private callbacks: LinkWatchdogCallbacks<K>;
+  private budgetMs: number;
+  private lastArrival: Map<K, number> = new Map();
+  private stale: Set<K> = new Set();
+  private linkStalled = false;
+  private startedAt = 0;
+  private timer: ReturnType<typeof setInterval> | null = null;
+
+  constructor(
+    streams: K[],
+    callbacks: LinkWatchdogCallbacks<K>,
+    options: LinkWatchdogOptions = {}
+  ) {
+    this.streams = streams;
+    this.callbacks = callbacks;
+    this.budgetMs =
+      (options.expectedPeriodMs ?? DEFAULT_EXPECTED_PERIOD_MS) *
+      (options.budgetFactor ?? DEFAULT_BUDGET_FACTOR);
+  }
+
+  get budget(): number {
+    return this.budgetMs;
+  }
+
+  get stalled(): boolean {
+    return this.linkStalled;
+  }
+
+  isStale(stream: K): boolean {
+    return this.stale.has(stream);
+  }
+
+  /** 스트림 값이 도착했을 때 호출 */
+  feed(stream: K, now: number = Date.now()) {
+    this.lastArrival.set(stream, now);
+    if (this.stale.delete(stream)) {
+      this.callbacks.onStreamStale(stream, false);
+    }
+    if (this.linkStalled) {
+      this.linkStalled = false;
+      this.callbacks.onLinkStall(false);
+    }
+  }
+
+  /** 연결 직후 시작. 아직 한 번도 안 들어온 스트림은 시작 시각부터 잰다 */
+  start() {
+    this.stop();
+    this.startedAt = Date.now();
+    this.lastArrival.clear();
+    this.timer = setInterval(
+      () => this.check(),
+      this.budgetMs / CHECKS_PER_BUDGET
+    );
+  }
+
+  stop() {
+    if (this.timer) {
+      clearInterval(this.timer);
+      this.timer = null;
+    }
+    this.stale.clear();
+    this.linkStalled = false;
+  }
+
+  check(now: number = Date.now()) {
+    let allStale = true;
+    for (const stream of this.streams) {
+      const last = this.lastArrival.get(stream) ?? this.startedAt;
+      if (now - last <= this.budgetMs) {
+        allStale = false;
+      } else if (!this.stale.has(stream)) {
+        this.stale.add(stream);
+        this.callbacks.onStreamStale(stream, true);
+      }
+    }
+
+    if (allStale && !this.linkStalled) {
+      this.linkStalled = true;
+      this.callbacks.onLinkStall(true);
+    }
+  }
+}
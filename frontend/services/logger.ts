@@ -0,0 +1,171 @@
+// services/logger.ts
+// 레벨 로거. 꺼진 레벨은 메시지를 만들지 않는다: 비싼 메시지는 함수로 넘기면
+// 레벨이 켜져 있을 때만 호출된다. 고빈도 채널은 sampleEvery로 N번에 한 번만 출력한다.
+// 원시 송수신 기록은 콘솔 대신 TrafficLog 링 버퍼에 남기고 필요할 때 dump()로 꺼낸다.
+
+export type LogLevel = "debug" | "info" | "warn" | "error" | "silent";
+
+const LEVEL_RANK: Record<LogLevel, number> = {
+  debug: 10,
+  info: 20,
+  warn: 30,
+  error: 40,
+  silent: 100,
+};
+
+declare const __DEV__: boolean | undefined;
+
+// 릴리즈 빌드에서는 warn 이상만 (브리지로 문자열을 넘기는 비용 자체를 없앤다)
+let globalLevel: LogLevel =
+  typeof __DEV__ !== "undefined" && __DEV__ ? "info" : "warn";
+const tagLevels: Map<string, LogLevel> = new Map();
+
+export function setLogLevel(level: LogLevel) {
+  globalLevel = level;
+}
+
+/** 특정 태그만 레벨을 바꾼다. null이면 전역 레벨을 따른다 */
+export function setTagLogLevel(tag: string, level: LogLevel | null) {
+  if (level) tagLevels.set(tag, level);
+  else tagLevels.delete(tag);
+}
+
+type Message = string | (() => string);
+
+export type LoggerOptions = {
+  /** N번 호출 중 한 번만 출력 (켜진 레벨 기준) */
+  sampleEvery?: number;
+};
+
+export class Logger {
+  readonly tag: string;
+  private sampleEvery: number;
+  private sampleCount = 0;
+
+  constructor(tag: string, options: LoggerOptions = {}) {
+    this.tag = tag;
+    this.sampleEvery = Math.max(1, options.sampleEvery ?? 1);
+  }
+
+  isEnabled(level: LogLevel): boolean {
+    const threshold = tagLevels.get(this.tag) ?? globalLevel;
+    return LEVEL_RANK[level] >= LEVEL_RANK[threshold];
+  }
+
+  debug(message: Message, ...args: unknown[]) {
+    if (this.shouldLog("debug")) console.log(this.format(message), ...args);
+  }
+
+  info(message: Message, ...args: unknown[]) {
+    if (this.shouldLog("info")) console.log(this.format(message), ...args);
+  }
+
+  warn(message: Message, ...args: unknown[]) {
+    if (this.shouldLog("warn")) console.warn(this.format(message), ...args);
+  }
+
+  error(message: Message, ...args: unknown[]) {
+    if (this.shouldLog("error")) console.error(this.format(message), ...args);
+  }
+
+  private shouldLog(level: LogLevel): boolean {
+    if (!this.isEnabled(level)) return false;
+    if (this.sampleEvery === 1) return true;
+    return this.sampleCount++ % this.sampleEvery === 0;
+  }
+
+  private format(message: Message): string {
+    const text = typeof message === "function" ? message() : message;
+    return `[${this.tag}] ${text}`;
+  }
+}
+
+export function createLogger(tag: string, options?: LoggerOptions): Logger {
+  return new Logger(tag, options);
+}
+
+export type TrafficDirection = "rx" | "tx";
+
+export type TrafficEntry = {
+  /** Date.now() 기준 ms */
+  timestampMs: number;
+  direction: TrafficDirection;
+  data: string;
+};
+
+const DEFAULT_TRAFFIC_CAPACITY = 256;
+
+/**
+ * 최근 원시 송수신 청크를 고정 크기 링 버퍼에 보관한다 (현장 디버깅용).
+ * 문자열은 복사하지 않고 참조만 저장하므로 청크당 비용은 슬롯 세 개 갱신이다.
+ */
+export class TrafficLog {
+  private timestamps: Float64Array;
+  private directions: Uint8Array;
+  private data: string[];
+  private written = 0;
+  enabled = true;
+
+  constructor(capacity: number = DEFAULT_TRAFFIC_CAPACITY) {
+    this.timestamps = new Float64Array(capacity);
+    this.directions = new Uint8Array(capacity);
+    this.data = new Array<string>(capacity).fill("");
+  }
+
+  record(direction: TrafficDirection, data: string, now: number = Date.now()) {
+    if (!this.enabled) return;
+    const slot = this.written % this.data.length;
+    this.timestamps[slot] = now;
+    this.directions[slot] = direction === "rx" ? 0 : 1;
+    this.data[slot] = data;
+    this.written++;
+  }
+
+  /** 바이트 청크는 latin1 문자열로 바꿔서 기록한다 (꺼져 있으면 변환도 하지 않는다) */
+  recordBytes(
+    direction: TrafficDirection,
+    bytes: Uint8Array,
+    now: number = Date.now()
+  ) {
+    if (!this.enabled) return;
+    let text = "";
+    for (let i = 0; i < bytes.length; i++) {
+      text += String.fromCharCode(bytes[i]);
+    }
+    this.record(direction, text, now);
+  }
+
+  /** 오래된 순서로 */
+  entries(): TrafficEntry[] {
+    const count = Math.min(this.written, this.data.length);
+    const result: TrafficEntry[] = [];
+    for (let i = this.written - count; i < this.written; i++) {
+      const slot = i % this.data.length;
+      result.push({
+        timestampMs: this.timestamps[slot],
+        direction: this.directions[slot] === 0 ? "rx" : "tx",
+        data: this.data[slot],
+      });
+    }
+    return result;
+  }
+
+  /** 사람이 읽을 수 있는 텍스트로. 시각은 첫 항목 기준 초, 제어문자는 이스케이프 */
+  dump(): string {
+    const entries = this.entries();
+    if (entries.length === 0) return "";
+    const origin = entries[0].timestampMs;
+    return entries
+      .map(
+        (entry) =>
+          `+${((entry.timestampMs - origin) / 1000).toFixed(3)} ` +
+          `${entry.direction} ${JSON.stringify(entry.data)}`
+      )
+      .join("\n");
+  }
+
+  clear() {
+    this.written = 0;
+    this.data.fill("");
+  }
+}
@@ -0,0 +1,171 @@
+// services/nativeIngest.ts
+// 네이티브(C++/JSI) 인제스트 모듈 래퍼. 안드로이드에서 TelemetryIngestModule이 RFCOMM 소켓
+// 읽기를 맡고, cpp/TelemetryIngest가 프레이밍/디코딩을 JS 스레드 밖에서 처리한다.
+// JS는 drain()으로 디코딩된 샘플을 Float64Array 한 개로 묶어서 받는다.
+// 모듈이 없으면(iOS, Jest 등) isAvailable()이 false이고 ArduinoBridge는 기존 JS 경로를 쓴다.
+
+import { NativeEventEmitter, NativeModules, Platform } from "react-native";
+
+import { createLogger } from "./logger";
+import { TelemetryChannelKey } from "./telemetryChannels";
+
+const log = createLogger("NativeIngest");
+
+// cpp/TelemetryIngest.h의 zxis::Channel 값 순서와 같다
+// (0은 네이티브가 디코딩하지 않은 텍스트 줄: value가 text 배열의 인덱스)
+export const NATIVE_CHANNEL_KEYS: (TelemetryChannelKey | undefined)[] = [
+  undefined,
+  "bpm",
+  "speed",
+  "targetEcho",
+  "rr",
+  "incline",
+  "distance",
+  "protocol",
+  "ecg",
+];
+
+// [channel, value, 도착 시각, 기기 시각(@<ms>, 없으면 NaN)]
+const SAMPLE_STRIDE = 4;
+const TEXT_CHANNEL = 0;
+
+export type NativeIngestStats = {
+  bytes: number;
+  chunks: number;
+  lines: number;
+  frames: number;
+  parseFailures: number;
+  crcErrors: number;
+  seqGaps: number;
+  droppedBytes: number;
+  droppedFrames: number;
+  queueDrops: number;
+  textDrops: number;
+};
+
+type NativeIngestHost = {
+  drain(): { samples: Float64Array; text: string[] } | null;
+  stats(): NativeIngestStats;
+  reset(): void;
+  setNegotiating(negotiating: boolean): void;
+};
+
+type TelemetryIngestModule = {
+  install(): boolean;
+  connect(address: string): Promise<boolean>;
+  write(data: string): Promise<boolean>;
+  disconnect(): Promise<boolean>;
+  isConnected(): Promise<boolean>;
+};
+
+declare global {
+  // eslint-disable-next-line no-var
+  var __telemetryIngest: NativeIngestHost | undefined;
+}
+
+const EVENT_DISCONNECTED = "TelemetryIngestDisconnected";
+
+// 네이티브 소켓/큐는 하나뿐이므로 래퍼도 하나만 만든다
+let sharedInstance: NativeIngest | null | undefined;
+
+export type NativeSampleHandler = (
+  key: TelemetryChannelKey,
+  value: number,
+  timestampMs: number,
+  deviceTimeMs: number
+) => void;
+
+export type NativeTextHandler = (line: string, timestampMs: number) => void;
+
+export class NativeIngest {
+  private module: TelemetryIngestModule;
+  private host: NativeIngestHost;
+  private emitter: NativeEventEmitter;
+
+  private constructor(module: TelemetryIngestModule, host: NativeIngestHost) {
+    this.module = module;
+    this.host = host;
+    this.emitter = new NativeEventEmitter(NativeModules.TelemetryIngest);
+  }
+
+  /** 네이티브 모듈이 있으면 HostObject를 설치하고 인스턴스를 돌려준다 */
+  static create(): NativeIngest | null {
+    if (sharedInstance === undefined) {
+      sharedInstance = NativeIngest.install();
+    }
+    return sharedInstance;
+  }
+
+  private static install(): NativeIngest | null {
+    if (Platform.OS !== "android") return null;
+
+    const module = NativeModules.TelemetryIngest as
+      | TelemetryIngestModule
+      | undefined;
+    if (!module) return null;
+
+    if (!global.__telemetryIngest) {
+      try {
+        module.install();
+      } catch (e) {
+        log.warn("install failed:", e);
+        return null;
+      }
+    }
+
+    const host = global.__telemetryIngest;
+    return host ? new NativeIngest(module, host) : null;
+  }
+
+  connect(address: string): Promise<boolean> {
+    return this.module.connect(address);
+  }
+
+  write(data: string): Promise<boolean> {
+    return this.module.write(data);
+  }
+
+  disconnect(): Promise<boolean> {
+    return this.module.disconnect();
+  }
+
+  onDisconnected(listener: () => void): () => void {
+    const subscription = this.emitter.addListener(EVENT_DISCONNECTED, listener);
+    return () => subscription.remove();
+  }
+
+  /**
+   * 쌓인 샘플을 한 번에 꺼낸다. 네이티브가 디코딩하지 않은 줄(PONG:, ACK:, STS: 등)은
+   * 샘플 사이의 도착 순서 그대로 도착 시각과 함께 onText로 넘겨서 JS 디스패처가 처리하게 한다.
+   * 꺼낸 항목 수를 돌려준다.
+   */
+  drain(onSample: NativeSampleHandler, onText: NativeTextHandler): number {
+    const batch = this.host.drain();
+    if (!batch) return 0;
+
+    const samples = batch.samples;
+    for (let i = 0; i < samples.length; i += SAMPLE_STRIDE) {
+      if (samples[i] === TEXT_CHANNEL) {
+        const line = batch.text[samples[i + 1]];
+        if (line !== undefined) onText(line, samples[i + 2]);
+        continue;
+      }
+      const key = NATIVE_CHANNEL_KEYS[samples[i]];
+      if (key) onSample(key, samples[i + 1], samples[i + 2], samples[i + 3]);
+    }
+    return samples.length / SAMPLE_STRIDE;
+  }
+
+  stats(): NativeIngestStats {
+    return this.host.stats();
+  }
+
+  reset() {
+    this.host.reset();
+  }
+
+  /** BIN:<v> 협상 창. 열려 있을 때 온 응답만 네이티브 프레임 디코딩을 켠다 */
+  setNegotiating(negotiating: boolean) {
+    this.host.setNegotiating(negotiating);
+  }
+}
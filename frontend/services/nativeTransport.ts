@@ -0,0 +1,94 @@
+// services/nativeTransport.ts
+// NativeIngest 위의 Transport. 소켓 읽기와 디코딩은 네이티브 스레드에서 하고,
+// JS는 NATIVE_DRAIN_INTERVAL_MS마다 쌓인 샘플을 꺼내 onSample/onLine으로 넘긴다.
+
+import { createLogger } from "./logger";
+import { NativeIngest, NativeIngestStats } from "./nativeIngest";
+import { Transport, TransportSink, withTimeout } from "./transport";
+
+const log = createLogger("BT:native");
+
+// 네이티브 큐에서 샘플을 꺼내는 주기
+const NATIVE_DRAIN_INTERVAL_MS = 40;
+
+export class NativeIngestTransport implements Transport {
+  readonly kind = "native";
+  private native: NativeIngest;
+  private linked = false;
+  private drainTimer: ReturnType<typeof setInterval> | null = null;
+  private disconnectSub: (() => void) | null = null;
+
+  constructor(native: NativeIngest) {
+    this.native = native;
+  }
+
+  /** 네이티브 인제스트 모듈이 없으면 null */
+  static create(): NativeIngestTransport | null {
+    const native = NativeIngest.create();
+    return native ? new NativeIngestTransport(native) : null;
+  }
+
+  get isOpen(): boolean {
+    return this.linked;
+  }
+
+  async open(
+    address: string,
+    sink: TransportSink,
+    timeoutMs: number
+  ): Promise<void> {
+    await withTimeout(this.native.connect(address), timeoutMs);
+    this.linked = true;
+    log.info(`Successfully connected to: ${address}`);
+
+    this.disconnectSub = this.native.onDisconnected(() => {
+      log.warn("Native link lost");
+      this.release();
+      sink.onClosed();
+    });
+    this.drainTimer = setInterval(() => {
+      this.native.drain(
+        (key, value, timestampMs, deviceTimeMs) =>
+          sink.onSample(key, value, timestampMs, deviceTimeMs),
+        (line, timestampMs) => sink.onLine(line, timestampMs)
+      );
+    }, NATIVE_DRAIN_INTERVAL_MS);
+  }
+
+  async write(data: string): Promise<void> {
+    if (!this.linked) {
+      throw new Error("Device not connected");
+    }
+    await this.native.write(data);
+  }
+
+  async close(): Promise<void> {
+    const wasLinked = this.linked;
+    this.release();
+    if (wasLinked) await this.native.disconnect();
+  }
+
+  ingestStats(): NativeIngestStats | null {
+    return this.linked ? this.native.stats() : null;
+  }
+
+  resetIngest() {
+    this.native.reset();
+  }
+
+  setBinaryNegotiation(negotiating: boolean) {
+    this.native.setNegotiating(negotiating);
+  }
+
+  private release() {
+    if (this.drainTimer) {
+      clearInterval(this.drainTimer);
+      this.drainTimer = null;
+    }
+    if (this.disconnectSub) {
+      this.disconnectSub();
+      this.disconnectSub = null;
+    }
+    this.linked = false;
+  }
+}
@@ -0,0 +1,165 @@
+// services/nodeTransports.ts
+// Node 전용 Transport (Jest, 시뮬레이터, 벤치마크). 앱 번들에서는 import하지 않는다.
+//   TcpTransport  주소 "host:port"   — tools/simulator 같은 TCP 기기 흉내
+//   PtyTransport  주소 "/dev/pts/N" — socat 등으로 만든 pty, 또는 USB-시리얼 장치 파일
+// @types/node 없이 쓰도록 필요한 모양만 아래에 선언한다.
+
+import { Transport, TransportSink, withTimeout } from "./transport";
+
+type NodeStream = {
+  on(event: string, listener: (...args: never[]) => void): NodeStream;
+  once(event: string, listener: (...args: never[]) => void): NodeStream;
+  removeAllListeners(): NodeStream;
+  destroy(): void;
+};
+
+type NodeSocket = NodeStream & {
+  setNoDelay(noDelay: boolean): void;
+  write(data: string, callback: (error?: Error | null) => void): boolean;
+  end(): void;
+};
+
+type NodeWritable = NodeStream & {
+  write(data: string, callback: (error?: Error | null) => void): boolean;
+};
+
+type NetModule = {
+  createConnection(options: { host: string; port: number }): NodeSocket;
+};
+
+type FsModule = {
+  createReadStream(path: string): NodeStream;
+  createWriteStream(path: string, options: { flags: string }): NodeWritable;
+};
+
+function writeAsync(stream: NodeWritable | NodeSocket, data: string) {
+  return new Promise<void>((resolve, reject) => {
+    stream.write(data, (error) => (error ? reject(error) : resolve()));
+  });
+}
+
+export class TcpTransport implements Transport {
+  readonly kind = "tcp";
+  private socket: NodeSocket | null = null;
+
+  get isOpen(): boolean {
+    return this.socket !== null;
+  }
+
+  async open(
+    address: string,
+    sink: TransportSink,
+    timeoutMs: number
+  ): Promise<void> {
+    const separator = address.lastIndexOf(":");
+    const host = separator > 0 ? address.slice(0, separator) : "127.0.0.1";
+    const port = Number(address.slice(separator + 1));
+    if (!Number.isInteger(port) || port <= 0) {
+      throw new Error(`Invalid TCP address: ${address}`);
+    }
+
+    const net = require("net") as NetModule;
+    const socket = net.createConnection({ host, port });
+    try {
+      await withTimeout(
+        new Promise<void>((resolve, reject) => {
+          socket.once("connect", () => resolve());
+          socket.once("error", reject);
+        }),
+        timeoutMs
+      );
+    } catch (error) {
+      socket.destroy();
+      throw error;
+    }
+
+    // 명령은 짧고 지연에 민감하다 (Nagle 끔)
+    socket.setNoDelay(true);
+    this.socket = socket;
+    socket.on("data", (chunk: Uint8Array) => sink.onBytes(chunk, Date.now()));
+    socket.on("error", () => undefined);
+    socket.on("close", () => {
+      if (this.socket !== socket) return;
+      this.socket = null;
+      sink.onClosed();
+    });
+  }
+
+  async write(data: string): Promise<void> {
+    if (!this.socket) throw new Error("Device not connected");
+    await writeAsync(this.socket, data);
+  }
+
+  async close(): Promise<void> {
+    const socket = this.socket;
+    this.socket = null;
+    if (!socket) return;
+    socket.removeAllListeners();
+    socket.on("error", () => undefined);
+    socket.end();
+    socket.destroy();
+  }
+}
+
+export class PtyTransport implements Transport {
+  readonly kind = "pty";
+  private input: NodeStream | null = null;
+  private output: NodeWritable | null = null;
+
+  get isOpen(): boolean {
+    return this.output !== null;
+  }
+
+  async open(
+    address: string,
+    sink: TransportSink,
+    timeoutMs: number
+  ): Promise<void> {
+    const fs = require("fs") as FsModule;
+    const input = fs.createReadStream(address);
+    const output = fs.createWriteStream(address, { flags: "r+" });
+    try {
+      await withTimeout(
+        new Promise<void>((resolve, reject) => {
+          output.once("open", () => resolve());
+          output.once("error", reject);
+          input.once("error", reject);
+        }),
+        timeoutMs
+      );
+    } catch (error) {
+      input.destroy();
+      output.destroy();
+      throw error;
+    }
+
+    this.input = input;
+    this.output = output;
+    input.on("data", (chunk: Uint8Array) => sink.onBytes(chunk, Date.now()));
+    input.on("error", () => undefined);
+    // pty 반대편이 닫히면 읽기 스트림이 끝난다
+    input.on("close", () => {
+      if (this.input !== input) return;
+      this.release();
+      sink.onClosed();
+    });
+  }
+
+  async write(data: string): Promise<void> {
+    if (!this.output) throw new Error("Device not connected");
+    await writeAsync(this.output, data);
+  }
+
+  async close(): Promise<void> {
+    this.release();
+  }
+
+  private release() {
+    const { input, output } = this;
+    this.input = null;
+    this.output = null;
+    input?.removeAllListeners();
+    input?.destroy();
+    output?.destroy();
+  }
+}
@@ -0,0 +1,274 @@
+// services/qrsDetector.ts
+// 원시 ECG에서 R 피크를 찾는 스트리밍 Pan–Tompkins 검출기. 샘플당 연산량이 일정하다.
+//
+//   대역통과(5–15 Hz, 2차 HPF + 2차 LPF) → 5점 미분 → 제곱 → 150 ms 이동 적분
+//   → 적응형 임계값(SPKI/NPKI) + 200 ms 불응기 + RR 평균 1.66배 search-back
+//
+// 박동 시점은 이동 적분 피크 직전 창 안에서 대역통과 신호의 절대값이 가장 큰 샘플로 보정한다
+// (적분 신호의 피크는 넓어서 잡음에 따라 흔들린다). 보정 탐색은 박동마다 창 길이만큼만 든다.
+
+const LEARNING_SECONDS = 2;
+const REFRACTORY_MS = 200;
+const INTEGRATION_WINDOW_MS = 150;
+const MIN_RR_MS = 250; // 240 bpm
+const MAX_RR_MS = 2000; // 30 bpm
+const SEARCH_BACK_FACTOR = 1.66;
+const RR_AVERAGE_BEATS = 8;
+
+export type BeatEvent = {
+  /** 직전 박동과의 간격 (ms) */
+  rrMs: number;
+  /** 60000 / rrMs */
+  bpm: number;
+  /** 검출된 피크의 ECG 샘플 seq */
+  sampleSeq: number;
+};
+
+/** RBJ 쿡북 2차 IIR (Direct Form I) */
+class Biquad {
+  private b0: number;
+  private b1: number;
+  private b2: number;
+  private a1: number;
+  private a2: number;
+  private x1 = 0;
+  private x2 = 0;
+  private y1 = 0;
+  private y2 = 0;
+
+  constructor(kind: "lowpass" | "highpass", cutoffHz: number, fs: number) {
+    const w0 = (2 * Math.PI * cutoffHz) / fs;
+    const cos = Math.cos(w0);
+    const alpha = Math.sin(w0) / (2 * Math.SQRT1_2);
+    const a0 = 1 + alpha;
+
+    if (kind === "lowpass") {
+      this.b0 = (1 - cos) / 2 / a0;
+      this.b1 = (1 - cos) / a0;
+      this.b2 = this.b0;
+    } else {
+      this.b0 = (1 + cos) / 2 / a0;
+      this.b1 = -(1 + cos) / a0;
+      this.b2 = this.b0;
+    }
+    this.a1 = (-2 * cos) / a0;
+    this.a2 = (1 - alpha) / a0;
+  }
+
+  step(x: number): number {
+    const y =
+      this.b0 * x +
+      this.b1 * this.x1 +
+      this.b2 * this.x2 -
+      this.a1 * this.y1 -
+      this.a2 * this.y2;
+    this.x2 = this.x1;
+    this.x1 = x;
+    this.y2 = this.y1;
+    this.y1 = y;
+    return y;
+  }
+}
+
+export class QrsDetector {
+  private fs: number;
+  private highpass: Biquad;
+  private lowpass: Biquad;
+
+  // 5점 미분용 지연선
+  private d1 = 0;
+  private d2 = 0;
+  private d3 = 0;
+  private d4 = 0;
+
+  // 박동 시점 보정용 대역통과 신호 이력
+  private filteredHistory: Float32Array;
+  private historyMask: number;
+
+  // 이동 적분
+  private window: Float32Array;
+  private windowPos = 0;
+  private windowSum = 0;
+
+  // 피크 검출 (이동 적분 신호의 극대점)
+  private prev1 = 0;
+  private prev2 = 0;
+  private sampleIndex = 0;
+
+  // 적응형 임계값
+  private learningSamples: number;
+  private learnMax = 0;
+  private learnSum = 0;
+  private spki = 0;
+  private npki = 0;
+  private refractorySamples: number;
+
+  private lastBeatIndex = -1;
+  private rrAverage = 0; // 샘플 단위
+  private rrHistory: Float32Array = new Float32Array(RR_AVERAGE_BEATS);
+  private rrCount = 0;
+
+  // search-back 후보: 직전 박동 이후 가장 큰 잡음 피크
+  private backPeak = 0;
+  private backIndex = -1;
+
+  private onBeat: (beat: BeatEvent) => void;
+  private seqOffset = 0;
+
+  constructor(sampleRateHz: number, onBeat: (beat: BeatEvent) => void) {
+    this.fs = sampleRateHz;
+    this.highpass = new Biquad("highpass", 5, sampleRateHz);
+    this.lowpass = new Biquad("lowpass", 15, sampleRateHz);
+    this.window = new Float32Array(
+      Math.max(1, Math.round((INTEGRATION_WINDOW_MS * sampleRateHz) / 1000))
+    );
+    // search-back 후보는 최대 1.66 × MAX_RR 전까지 거슬러 올라간다
+    const historyNeeded =
+      (SEARCH_BACK_FACTOR * MAX_RR_MS * sampleRateHz) / 1000 +
+      this.window.length;
+    let historySize = 1;
+    while (historySize < historyNeeded) historySize <<= 1;
+    this.filteredHistory = new Float32Array(historySize);
+    this.historyMask = historySize - 1;
+    this.learningSamples = Math.round(LEARNING_SECONDS * sampleRateHz);
+    this.refractorySamples = Math.round((REFRACTORY_MS * sampleRateHz) / 1000);
+    this.onBeat = onBeat;
+  }
+
+  /** ECG 버퍼의 seq와 맞추기 위해 첫 샘플의 seq를 지정 */
+  reset(firstSeq: number = 0) {
+    this.highpass = new Biquad("highpass", 5, this.fs);
+    this.lowpass = new Biquad("lowpass", 15, this.fs);
+    this.d1 = this.d2 = this.d3 = this.d4 = 0;
+    this.window.fill(0);
+    this.filteredHistory.fill(0);
+    this.windowPos = 0;
+    this.windowSum = 0;
+    this.prev1 = this.prev2 = 0;
+    this.sampleIndex = 0;
+    this.learnMax = this.learnSum = 0;
+    this.spki = this.npki = 0;
+    this.lastBeatIndex = -1;
+    this.rrAverage = 0;
+    this.rrCount = 0;
+    this.backPeak = 0;
+    this.backIndex = -1;
+    this.seqOffset = firstSeq;
+  }
+
+  push(sample: number) {
+    // 대역통과
+    const filtered = this.lowpass.step(this.highpass.step(sample));
+    this.filteredHistory[this.sampleIndex & this.historyMask] = filtered;
+
+    // 5점 미분: (2x[n] + x[n-1] - x[n-3] - 2x[n-4]) / 8
+    const derivative =
+      (2 * filtered + this.d1 - this.d3 - 2 * this.d4) / 8;
+    this.d4 = this.d3;
+    this.d3 = this.d2;
+    this.d2 = this.d1;
+    this.d1 = filtered;
+
+    // 제곱 + 이동 적분
+    const squared = derivative * derivative;
+    this.windowSum += squared - this.window[this.windowPos];
+    this.window[this.windowPos] = squared;
+    this.windowPos = (this.windowPos + 1) % this.window.length;
+    const integrated = this.windowSum / this.window.length;
+
+    const index = this.sampleIndex++;
+
+    if (index < this.learningSamples) {
+      this.learnMax = Math.max(this.learnMax, integrated);
+      this.learnSum += integrated;
+      if (index === this.learningSamples - 1) {
+        this.spki = this.learnMax / 3;
+        this.npki = this.learnSum / this.learningSamples / 2;
+      }
+    } else if (this.prev1 > this.prev2 && this.prev1 >= integrated) {
+      // 직전 샘플이 극대점
+      this.classifyPeak(this.prev1, index - 1);
+    }
+
+    this.prev2 = this.prev1;
+    this.prev1 = integrated;
+
+    this.searchBack(index);
+  }
+
+  private threshold(): number {
+    return this.npki + 0.25 * (this.spki - this.npki);
+  }
+
+  private classifyPeak(peak: number, index: number) {
+    const sinceBeat =
+      this.lastBeatIndex < 0 ? Infinity : index - this.lastBeatIndex;
+
+    if (peak > this.threshold() && sinceBeat > this.refractorySamples) {
+      this.spki = 0.125 * peak + 0.875 * this.spki;
+      this.acceptBeat(index);
+      return;
+    }
+
+    this.npki = 0.125 * peak + 0.875 * this.npki;
+    if (sinceBeat > this.refractorySamples && peak > this.backPeak) {
+      this.backPeak = peak;
+      this.backIndex = index;
+    }
+  }
+
+  /** 예상보다 오래 박동이 없으면 절반 임계값으로 놓친 박동을 찾는다 */
+  private searchBack(index: number) {
+    if (this.rrAverage <= 0 || this.backIndex < 0) return;
+    if (index - this.lastBeatIndex < SEARCH_BACK_FACTOR * this.rrAverage) return;
+
+    if (this.backPeak > this.threshold() / 2) {
+      this.spki = 0.25 * this.backPeak + 0.75 * this.spki;
+      this.acceptBeat(this.backIndex);
+    } else {
+      this.backPeak = 0;
+      this.backIndex = -1;
+    }
+  }
+
+  /** 적분 피크 직전 창에서 |대역통과|가 최대인 샘플 (미분 지연 2샘플 포함) */
+  private locateRPeak(integratedPeak: number): number {
+    const from = Math.max(0, integratedPeak - this.window.length - 2);
+    let best = integratedPeak;
+    let bestValue = -1;
+    for (let i = from; i <= integratedPeak; i++) {
+      const value = Math.abs(this.filteredHistory[i & this.historyMask]);
+      if (value > bestValue) {
+        bestValue = value;
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  private acceptBeat(integratedPeak: number) {
+    const index = this.locateRPeak(integratedPeak);
+    const previous = this.lastBeatIndex;
+    this.lastBeatIndex = index;
+    this.backPeak = 0;
+    this.backIndex = -1;
+    if (previous < 0) return;
+
+    const rrSamples = index - previous;
+    const rrMs = (rrSamples * 1000) / this.fs;
+    if (rrMs < MIN_RR_MS || rrMs > MAX_RR_MS) return;
+
+    this.rrHistory[this.rrCount % RR_AVERAGE_BEATS] = rrSamples;
+    this.rrCount++;
+    const n = Math.min(this.rrCount, RR_AVERAGE_BEATS);
+    let sum = 0;
+    for (let i = 0; i < n; i++) sum += this.rrHistory[i];
+    this.rrAverage = sum / n;
+
+    this.onBeat({
+      rrMs,
+      bpm: 60000 / rrMs,
+      sampleSeq: this.seqOffset + index,
+    });
+  }
+}
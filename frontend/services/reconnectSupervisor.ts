@@ -0,0 +1,108 @@
+// services/reconnectSupervisor.ts
+// 링크가 끊기면 지터를 섞은 지수 백오프로 재연결을 반복한다.
+// 첫 시도는 짧게 두어 잠깐의 RF 끊김은 1초 안에 복구되게 하고, 이후 간격을 늘린다.
+// 실제 연결 절차는 attempt 콜백(ArduinoBridge)이 맡는다.
+
+export type ReconnectOptions = {
+  initialDelayMs?: number;
+  maxDelayMs?: number;
+  multiplier?: number;
+  /** 0~1. 각 지연을 [delay × (1 - jitter), delay] 범위에서 무작위로 고른다 */
+  jitter?: number;
+  maxAttempts?: number;
+};
+
+export type ReconnectCallbacks = {
+  onAttempt?: (attempt: number, delayMs: number) => void;
+  onRecovered: (attempts: number, elapsedMs: number) => void;
+  onGiveUp: (lastError: unknown) => void;
+};
+
+const DEFAULT_OPTIONS: Required<ReconnectOptions> = {
+  initialDelayMs: 100,
+  maxDelayMs: 5000,
+  multiplier: 2,
+  jitter: 0.5,
+  maxAttempts: 10,
+};
+
+export class ReconnectSupervisor {
+  private attemptConnect: () => Promise<void>;
+  private callbacks: ReconnectCallbacks;
+  private options: Required<ReconnectOptions>;
+  private timer: ReturnType<typeof setTimeout> | null = null;
+  // start/cancel마다 증가. 이전 세대의 시도 결과는 무시한다
+  private generation = 0;
+  private running = false;
+  private attempts = 0;
+  private startedAt = 0;
+
+  constructor(
+    attemptConnect: () => Promise<void>,
+    callbacks: ReconnectCallbacks,
+    options: ReconnectOptions = {}
+  ) {
+    this.attemptConnect = attemptConnect;
+    this.callbacks = callbacks;
+    this.options = { ...DEFAULT_OPTIONS, ...options };
+  }
+
+  get active(): boolean {
+    return this.running;
+  }
+
+  /** n번째(0부터) 재시도 전 지연 */
+  delayFor(attempt: number): number {
+    const { initialDelayMs, maxDelayMs, multiplier, jitter } = this.options;
+    const base = Math.min(maxDelayMs, initialDelayMs * multiplier ** attempt);
+    return base * (1 - jitter * Math.random());
+  }
+
+  start() {
+    if (this.running) return;
+    this.running = true;
+    this.generation++;
+    this.attempts = 0;
+    this.startedAt = Date.now();
+    this.schedule(this.generation);
+  }
+
+  cancel() {
+    this.running = false;
+    this.generation++;
+    if (this.timer) {
+      clearTimeout(this.timer);
+      this.timer = null;
+    }
+  }
+
+  private schedule(generation: number) {
+    const delay = this.delayFor(this.attempts);
+    this.timer = setTimeout(() => {
+      this.timer = null;
+      this.runAttempt(generation, delay);
+    }, delay);
+  }
+
+  private async runAttempt(generation: number, delay: number) {
+    this.attempts++;
+    this.callbacks.onAttempt?.(this.attempts, delay);
+
+    try {
+      await this.attemptConnect();
+    } catch (error) {
+      if (generation !== this.generation) return;
+      if (this.attempts >= this.options.maxAttempts) {
+        this.running = false;
+        this.callbacks.onGiveUp(error);
+        return;
+      }
+      this.schedule(generation);
+      return;
+    }
+
+    if (generation !== this.generation) return;
+    this.running = false;
+    this.callbacks.onRecovered(this.attempts, Date.now() - this.startedAt);
+  }
+}
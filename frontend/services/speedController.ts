@@ -0,0 +1,406 @@
+// services/speedController.ts
+// 합친 심박수가 운동 목적의 강도 구간(PURPOSE_INTENSITY) 안에 머물도록 러닝머신 속도를 조절하는 PI 제어 루프.
+//
+//   오차 e = 구간 중앙 - 심박수 (bpm),  출력 u = 속도 (km/h)
+//   u = I + Kp·e - Kd·기울기,  I += Ki·e·dt
+//
+// 기울기 항은 측정값 미분이라 목표가 바뀌어도 튀지 않고, 심박이 올라가는 중이면 미리 늦춘다.
+// 출력은 [minSpeed, maxSpeed]와 초당 가속/감속 한도로 자른다 (anti-windup: 속도 한도에 잘린 만큼은
+// 적분에서 되돌리고, 가속 한도에 걸려 있는 동안은 그 방향으로 적분하지 않는다). 시작/재개는 현재 속도에서 이어받는다.
+//
+// React 렌더와 무관하게 자체 타이머로 돈다. 다음 틱 시각을 주기만큼 누적해서 잡으므로 지연이 쌓이지 않고,
+// 밀린 틱은 몰아서 돌지 않고 건너뛴다. 심박 추정이 staleAfterMs보다 오래됐거나 링크가 끊겼으면
+// 명령을 보내지 않고 속도와 적분을 그대로 둔다 (holding).
+// 틱에서 결정한 시각부터 속도 명령 전송(ACK 모드면 ACK)까지의 시간은 히스토그램에 남긴다.
+//
+// 사용자의 심박 응답 모델(HrResponseModel)이 준비돼 있으면 PI 대신 모델 예측 제어(MPC)를 쓴다.
+// 심박은 속도보다 수십 초 늦게 따라오므로, 지금 심박이 아니라 앞으로 θ + 2τ 동안의 예측 심박이
+// 목표에 가장 가깝게 되는 속도를 고른다 (이미 들어간 속도의 효과까지 보므로 오버슈트가 줄어든다).
+// 예측은 한 번 바꾼 속도를 유지한다는 가정이라 선형이고, 닫힌 식으로 풀린다. 한도 처리는 PI와 같다.
+
+import { CommandCancelledError } from "./commandQueue";
+import { HeartRateEstimate } from "./heartRateFusion";
+import { HrResponseModel } from "./hrResponseModel";
+import { Clock, monotonicNow } from "./ingestMetrics";
+import { LatencyHistogram, LatencySummary } from "./latencyHistogram";
+import { createLogger } from "./logger";
+
+const log = createLogger("SpeedControl");
+
+export type HeartRateBand = {
+  low: number;
+  high: number;
+};
+
+export type SpeedControllerOptions = {
+  /** 제어 주기 */
+  periodMs?: number;
+  /** 비례 이득 (km/h per bpm) */
+  kp?: number;
+  /** 적분 이득 (km/h per bpm·s) */
+  ki?: number;
+  /** 심박 기울기 이득 (km/h per bpm/s) */
+  kd?: number;
+  minSpeed?: number;
+  maxSpeed?: number;
+  /** 초당 최대 가속/감속 (km/h/s). 감속은 더 빠르게 허용한다 */
+  maxAccelPerS?: number;
+  maxDecelPerS?: number;
+  /** 심박 추정이 이보다 오래되면 조절을 멈춘다 */
+  staleAfterMs?: number;
+  /** MPC 속도 변경 벌점 (예측 오차 대비 비율). 클수록 천천히 움직인다 */
+  mpcMovePenalty?: number;
+  /** 틱 예약/지연 측정에 쓰는 단조 시계 (테스트용) */
+  now?: Clock;
+};
+
+/** 제어 대상. ArduinoBridge가 자기 필터/송신 큐로 채운다 */
+export type SpeedControlTarget = {
+  heartRate(): HeartRateEstimate | null;
+  isConnected(): boolean;
+  sendSpeed(speed: number): Promise<void>;
+  /** 예측에 쓸 수 있는 심박 응답 모델. 아직 없으면 null (PI로 조절) */
+  responseModel(): HrResponseModel | null;
+};
+
+export type SpeedControlMode = "off" | "tracking" | "holding";
+
+export type SpeedControlStrategy = "pi" | "mpc";
+
+export type SpeedControlStatus = {
+  mode: SpeedControlMode;
+  band: HeartRateBand | null;
+  /** 마지막으로 보낸 속도 (km/h) */
+  speed: number;
+  /** holding일 때 이유 */
+  holdReason: "stale" | "disconnected" | null;
+  /** 마지막 틱에서 쓴 방식 */
+  strategy: SpeedControlStrategy;
+};
+
+export type SpeedControlStats = {
+  ticks: number;
+  commands: number;
+  /** 데이터가 오래됐거나 링크가 끊겨 건너뛴 틱 */
+  holds: number;
+  /** 출력이 속도/가속 한도에 걸린 틱 */
+  saturated: number;
+  /** 모델 예측으로 결정한 틱 */
+  predictiveTicks: number;
+  /** 앱이 멈춰 있어서 건너뛴 틱 */
+  skippedTicks: number;
+  failures: number;
+  /** 틱 결정 → 속도 명령 전송(또는 ACK) */
+  decisionToCommand: LatencySummary;
+  /** 예정 시각 대비 틱이 늦게 돈 정도 */
+  tickLateness: LatencySummary;
+};
+
+type StatusListener = (status: SpeedControlStatus) => void;
+
+const DEFAULT_PERIOD_MS = 1000;
+// 속도 1 km/h에 심박 약 8 bpm, 시정수 약 40초 기준 (느리게 잡아서 오버슈트가 없게)
+const DEFAULT_KP = 0.05;
+const DEFAULT_KI = 0.002;
+const DEFAULT_KD = 0.2;
+const DEFAULT_MIN_SPEED = 2;
+const DEFAULT_MAX_SPEED = 16;
+const DEFAULT_MAX_ACCEL_PER_S = 0.1;
+const DEFAULT_MAX_DECEL_PER_S = 0.3;
+const DEFAULT_STALE_AFTER_MS = 5000;
+// 백그라운드에서 오래 멈췄다 돌아와도 한 틱에 적분/가속을 이 주기 수 이상 반영하지 않는다
+const MAX_DT_PERIODS = 3;
+// 러닝머신 속도 단위 (S:x.x)
+const SPEED_STEP = 0.1;
+const SPEED_EPSILON = 1e-6;
+const DEFAULT_MPC_MOVE_PENALTY = 1;
+// 예측 구간: 데드타임 + 시정수의 이 배수 (이 정도면 새 속도의 효과가 거의 다 나타난다)
+const MPC_HORIZON_TAUS = 2;
+const MPC_MAX_HORIZON_S = 300;
+
+export class SpeedController {
+  private target: SpeedControlTarget;
+  private periodMs: number;
+  private kp: number;
+  private ki: number;
+  private kd: number;
+  private minSpeed: number;
+  private maxSpeed: number;
+  private maxAccelPerS: number;
+  private maxDecelPerS: number;
+  private staleAfterMs: number;
+  private mpcMovePenalty: number;
+  private now: Clock;
+
+  private timer: ReturnType<typeof setTimeout> | null = null;
+  private nextTickAt = 0;
+  private lastTickAt = 0;
+  private band: HeartRateBand | null = null;
+  private mode: SpeedControlMode = "off";
+  private holdReason: SpeedControlStatus["holdReason"] = null;
+  private strategy: SpeedControlStrategy = "pi";
+  // 연속 출력 (양자화 전)과 마지막으로 보낸 값
+  private output = 0;
+  private commanded = NaN;
+  private integral = 0;
+  // 다음 틱에서 현재 출력에 맞춰 적분을 다시 잡는다 (시작/재개)
+  private bumpless = true;
+  // 예측 작업 배열 (지금 속도 유지 / 1 km/h 올려 유지)
+  private predictedHold = new Float64Array(MPC_MAX_HORIZON_S);
+  private predictedMove = new Float64Array(MPC_MAX_HORIZON_S);
+  private listeners: Set<StatusListener> = new Set();
+
+  private counters = {
+    ticks: 0,
+    commands: 0,
+    holds: 0,
+    saturated: 0,
+    predictiveTicks: 0,
+    skippedTicks: 0,
+    failures: 0,
+  };
+  private decisionToCommand = new LatencyHistogram();
+  private tickLateness = new LatencyHistogram();
+
+  constructor(
+    target: SpeedControlTarget,
+    options: SpeedControllerOptions = {}
+  ) {
+    this.target = target;
+    this.periodMs = options.periodMs ?? DEFAULT_PERIOD_MS;
+    this.kp = options.kp ?? DEFAULT_KP;
+    this.ki = options.ki ?? DEFAULT_KI;
+    this.kd = options.kd ?? DEFAULT_KD;
+    this.minSpeed = options.minSpeed ?? DEFAULT_MIN_SPEED;
+    this.maxSpeed = options.maxSpeed ?? DEFAULT_MAX_SPEED;
+    this.maxAccelPerS = options.maxAccelPerS ?? DEFAULT_MAX_ACCEL_PER_S;
+    this.maxDecelPerS = options.maxDecelPerS ?? DEFAULT_MAX_DECEL_PER_S;
+    this.staleAfterMs = options.staleAfterMs ?? DEFAULT_STALE_AFTER_MS;
+    this.mpcMovePenalty = options.mpcMovePenalty ?? DEFAULT_MPC_MOVE_PENALTY;
+    this.now = options.now ?? monotonicNow;
+  }
+
+  get isActive(): boolean {
+    return this.mode !== "off";
+  }
+
+  /**
+   * 목표 구간으로 조절을 시작한다. currentSpeed는 지금 러닝머신 속도 (여기서 이어받는다).
+   * 이미 돌고 있으면 구간만 바꾼다.
+   */
+  start(band: HeartRateBand, currentSpeed: number) {
+    this.band = band;
+    if (this.timer) {
+      this.notify();
+      return;
+    }
+
+    log.info(`Speed control on: ${band.low}-${band.high} bpm`);
+    this.output = currentSpeed;
+    this.commanded = currentSpeed;
+    this.bumpless = true;
+    this.mode = "tracking";
+    this.holdReason = null;
+    const now = this.now();
+    this.lastTickAt = now;
+    this.nextTickAt = now;
+    this.schedule(now);
+    this.notify();
+  }
+
+  stop() {
+    if (this.timer) {
+      clearTimeout(this.timer);
+      this.timer = null;
+    }
+    if (this.mode === "off") return;
+    log.info("Speed control off");
+    this.mode = "off";
+    this.holdReason = null;
+    this.notify();
+  }
+
+  getStatus(): SpeedControlStatus {
+    return {
+      mode: this.mode,
+      band: this.band,
+      speed: Number.isNaN(this.commanded) ? this.output : this.commanded,
+      holdReason: this.holdReason,
+      strategy: this.strategy,
+    };
+  }
+
+  onStatusChange(listener: StatusListener) {
+    this.listeners.add(listener);
+    return () => this.listeners.delete(listener);
+  }
+
+  getStats(): SpeedControlStats {
+    return {
+      ...this.counters,
+      decisionToCommand: this.decisionToCommand.summary(),
+      tickLateness: this.tickLateness.summary(),
+    };
+  }
+
+  private schedule(now: number) {
+    this.nextTickAt += this.periodMs;
+    if (this.nextTickAt <= now) {
+      const missed = Math.floor((now - this.nextTickAt) / this.periodMs) + 1;
+      this.counters.skippedTicks += missed;
+      this.nextTickAt += missed * this.periodMs;
+    }
+    this.timer = setTimeout(() => this.tick(), this.nextTickAt - now);
+  }
+
+  private tick() {
+    const now = this.now();
+    // 타이머가 조금 일찍 깨는 것은 0으로 센다
+    this.tickLateness.record(Math.max(0, now - this.nextTickAt));
+    const dt =
+      Math.min(now - this.lastTickAt, this.periodMs * MAX_DT_PERIODS) / 1000;
+    this.lastTickAt = now;
+    this.counters.ticks++;
+
+    this.step(dt, now);
+    if (this.mode !== "off") this.schedule(now);
+  }
+
+  private step(dt: number, decidedAt: number) {
+    const band = this.band!;
+    const estimate = this.target.heartRate();
+    const holdReason = !this.target.isConnected()
+      ? "disconnected"
+      : !estimate || Date.now() - estimate.updatedAtMs > this.staleAfterMs
+        ? "stale"
+        : null;
+
+    if (holdReason || !estimate) {
+      this.counters.holds++;
+      // 돌아오면 그때의 속도에서 다시 이어받는다
+      this.bumpless = true;
+      this.setMode("holding", holdReason);
+      return;
+    }
+    this.setMode("tracking", null);
+
+    const center = (band.low + band.high) / 2;
+    const model = this.target.responseModel();
+    let increment = 0;
+    let raw: number;
+    if (model) {
+      this.counters.predictiveTicks++;
+      raw = this.predictiveOutput(model, estimate.bpm, center);
+      // PI로 돌아가면 그때 출력에서 이어받는다
+      this.bumpless = true;
+    } else {
+      const error = center - estimate.bpm;
+      const proportional = this.kp * error - this.kd * estimate.slope;
+      increment = this.ki * error * dt;
+      if (this.bumpless) {
+        this.integral = this.output - proportional;
+        this.bumpless = false;
+      } else {
+        this.integral += increment;
+      }
+      raw = this.integral + proportional;
+    }
+    this.setStrategy(model ? "mpc" : "pi");
+
+    // 속도 한도: 잘린 만큼 적분을 되돌린다 (back-calculation)
+    const bounded = Math.max(this.minSpeed, Math.min(this.maxSpeed, raw));
+    this.integral += bounded - raw;
+
+    // 가속 한도: 걸린 방향으로 오차가 밀고 있으면 이번 틱 적분을 취소한다 (conditional integration)
+    const limited = Math.max(
+      this.output - this.maxDecelPerS * dt,
+      Math.min(this.output + this.maxAccelPerS * dt, bounded)
+    );
+    if (bounded !== raw || limited !== bounded) this.counters.saturated++;
+    if (limited !== bounded && limited < bounded === increment > 0) {
+      this.integral -= increment;
+    }
+    this.output = limited;
+
+    // 한 단위 이상 움직였을 때만 보낸다 (경계에서 0.1씩 왔다 갔다 하지 않게).
+    // 9.9 → 10처럼 부동소수 차가 0.1보다 살짝 작게 나와도 한 단위로 센다
+    if (Math.abs(limited - this.commanded) < SPEED_STEP - SPEED_EPSILON) return;
+    this.command(Number(limited.toFixed(1)), decidedAt);
+  }
+
+  /**
+   * 지금 속도를 u로 바꿔 유지할 때 예측 구간의 (예측 심박 - 목표)² 합 + 변경 벌점을 최소로 하는 u.
+   * 예측이 u에 선형이라 (지금 속도 유지 예측 f, 1 km/h당 변화 s) 최소점은
+   *   u = 지금 속도 + Σ s·(목표 - f) / ((1 + 벌점) · Σ s²)
+   */
+  private predictiveOutput(
+    model: HrResponseModel,
+    bpm: number,
+    center: number
+  ): number {
+    const params = model.params!;
+    const horizon = Math.min(
+      MPC_MAX_HORIZON_S,
+      Math.round(params.deadTimeS + MPC_HORIZON_TAUS * params.timeConstantS)
+    );
+    const hold = this.predictedHold.subarray(0, horizon);
+    const move = this.predictedMove.subarray(0, horizon);
+    model.predict(bpm, this.output, hold);
+    model.predict(bpm, this.output + 1, move);
+
+    let numerator = 0;
+    let denominator = 0;
+    for (let k = 0; k < horizon; k++) {
+      const sensitivity = move[k] - hold[k];
+      numerator += sensitivity * (center - hold[k]);
+      denominator += sensitivity * sensitivity;
+    }
+    if (!(denominator > 0)) return this.output;
+    return (
+      this.output + numerator / ((1 + this.mpcMovePenalty) * denominator)
+    );
+  }
+
+  private command(speed: number, decidedAt: number) {
+    this.commanded = speed;
+    this.counters.commands++;
+    this.notify();
+    this.target.sendSpeed(speed).then(
+      () => this.decisionToCommand.record(this.now() - decidedAt),
+      (e) => {
+        // 비상 정지가 대기 중인 속도 명령을 취소함
+        if (e instanceof CommandCancelledError) {
+          this.stop();
+          return;
+        }
+        this.counters.failures++;
+        log.warn("Speed command failed:", e);
+        // 다음 틱에서 다시 보낸다
+        if (this.commanded === speed) this.commanded = NaN;
+      }
+    );
+  }
+
+  private setMode(
+    mode: SpeedControlMode,
+    holdReason: SpeedControlStatus["holdReason"]
+  ) {
+    if (this.mode === mode && this.holdReason === holdReason) return;
+    if (mode === "holding") log.info(`Speed control holding (${holdReason})`);
+    this.mode = mode;
+    this.holdReason = holdReason;
+    this.notify();
+  }
+
+  private setStrategy(strategy: SpeedControlStrategy) {
+    if (this.strategy === strategy) return;
+    log.info(`Speed control strategy: ${strategy}`);
+    this.strategy = strategy;
+    this.notify();
+  }
+
+  private notify() {
+    const status = this.getStatus();
+    this.listeners.forEach((listener) => listener(status));
+  }
+}
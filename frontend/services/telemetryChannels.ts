@@ -0,0 +1,208 @@
+// services/telemetryChannels.ts
+// 텍스트 프로토콜 채널 레지스트리. 채널마다 접두사/값 타입/디코더를 선언하고,
+// 접두사(콜론 앞 최대 4바이트)를 정수 키로 묶어 한 번의 Map 조회로 채널을 찾는다.
+// 새 채널은 TELEMETRY_CHANNELS에 항목만 추가하면 된다.
+//
+// 값 뒤에 @<기기 ms>가 붙을 수 있다 (예: BPM:72@183204). 기기 단조 시계로 잰 측정 시각이며,
+// 값 디코더는 숫자가 끝나는 곳에서 멈추므로 붙지 않은 기기와도 그대로 호환된다.
+
+import { LineView } from "./lineFramer";
+
+const COLON = 0x3a;
+const AT = 0x40;
+const MAX_PREFIX_BYTES = 4;
+
+/** 채널 키 → 디코딩된 값 타입 */
+export type TelemetryValues = {
+  bpm: number; // 심박수 (BPM:)
+  speed: number; // 현재 속도 (SPD:)
+  targetEcho: number; // 목표 심박 수신 확인 (N:)
+  rr: number; // RR 간격 ms (RR:)
+  incline: number; // 경사 % (INC:)
+  distance: number; // 누적 거리 km (DST:)
+  status: string; // 기기 상태 문자열 (STS:)
+  protocol: number; // 바이너리 프로토콜 협상 응답 (BIN:)
+  ecg: number; // 원시 ECG 샘플 (ECG:, 보통은 바이너리 프레임으로 묶어서 온다)
+  ecgRate: number; // ECG 샘플링 주파수 Hz (EHZ:, 스트림을 시작할 때)
+  ack: number; // 명령 수신 확인 seq (ACK:)
+  pong: number; // keepalive 응답, PING:<n>의 n (PONG:)
+};
+
+export type TelemetryChannelKey = keyof TelemetryValues;
+
+export type TelemetryValueType = "int" | "float" | "text";
+
+export type TelemetryChannelSpec<T> = {
+  prefix: string;
+  type: TelemetryValueType;
+  /** 접두사 다음 offset부터 값을 디코딩. 잘못된 값이면 null */
+  decode: (line: LineView, offset: number) => T | null;
+};
+
+export type TelemetryListener<K extends TelemetryChannelKey> = (
+  value: TelemetryValues[K]
+) => void;
+
+/** dispatch 결과. 알 수 없는 접두사와 값 파싱 실패를 구분한다 */
+export type DispatchResult = "ok" | "unknown" | "invalid";
+
+const decodeInt = (line: LineView, offset: number): number | null => {
+  const value = line.parseIntAt(offset);
+  return isNaN(value) ? null : value;
+};
+
+const decodeFloat = (line: LineView, offset: number): number | null => {
+  const value = line.parseFloatAt(offset);
+  return isNaN(value) ? null : value;
+};
+
+const decodeText = (line: LineView, offset: number): string | null => {
+  let value = line.slice(offset);
+  const at = value.lastIndexOf("@");
+  if (at >= 0) value = value.slice(0, at);
+  value = value.trim();
+  return value.length > 0 ? value : null;
+};
+
+/** offset 이후의 @<기기 ms>. 없으면 NaN */
+function findDeviceTime(line: LineView, offset: number): number {
+  for (let i = line.length - 1; i >= offset; i--) {
+    if (line.byteAt(i) === AT) return line.parseIntAt(i + 1);
+  }
+  return NaN;
+}
+
+export const TELEMETRY_CHANNELS: {
+  [K in TelemetryChannelKey]: TelemetryChannelSpec<TelemetryValues[K]>;
+} = {
+  bpm: { prefix: "BPM:", type: "int", decode: decodeInt },
+  speed: { prefix: "SPD:", type: "float", decode: decodeFloat },
+  targetEcho: { prefix: "N:", type: "int", decode: decodeInt },
+  rr: { prefix: "RR:", type: "int", decode: decodeInt },
+  incline: { prefix: "INC:", type: "float", decode: decodeFloat },
+  distance: { prefix: "DST:", type: "float", decode: decodeFloat },
+  status: { prefix: "STS:", type: "text", decode: decodeText },
+  protocol: { prefix: "BIN:", type: "int", decode: decodeInt },
+  ecg: { prefix: "ECG:", type: "int", decode: decodeInt },
+  ecgRate: { prefix: "EHZ:", type: "int", decode: decodeInt },
+  ack: { prefix: "ACK:", type: "int", decode: decodeInt },
+  pong: { prefix: "PONG:", type: "int", decode: decodeInt },
+};
+
+export const TELEMETRY_CHANNEL_KEYS = Object.keys(
+  TELEMETRY_CHANNELS
+) as TelemetryChannelKey[];
+
+/** 오버플로우 재동기화에 쓰는 프레임 시작 접두사 목록 */
+export const TELEMETRY_PREFIXES = TELEMETRY_CHANNEL_KEYS.map(
+  (key) => TELEMETRY_CHANNELS[key].prefix
+);
+
+function packPrefix(prefix: string): number {
+  const name = prefix.endsWith(":") ? prefix.slice(0, -1) : prefix;
+  if (name.length === 0 || name.length > MAX_PREFIX_BYTES) {
+    throw new Error(`Invalid telemetry prefix: ${prefix}`);
+  }
+  let key = 0;
+  for (let i = 0; i < name.length; i++) {
+    const b = name.charCodeAt(i) & 0xff;
+    if (b === 0) throw new Error(`Invalid telemetry prefix: ${prefix}`);
+    key = key * 256 + b;
+  }
+  return key;
+}
+
+type ChannelSlot = {
+  key: TelemetryChannelKey;
+  spec: TelemetryChannelSpec<any>;
+  // 구독/해지 시에만 새 배열로 교체 (순회 중 변경에도 안전, 순회 시 할당 없음)
+  listeners: ReadonlyArray<(value: any) => void>;
+};
+
+export class TelemetryDispatcher {
+  private byPrefix: Map<number, ChannelSlot> = new Map();
+  private byKey: Map<TelemetryChannelKey, ChannelSlot> = new Map();
+  /** 지금 전달 중인(끝난 뒤에는 마지막으로 dispatch한) 값의 기기 타임스탬프 (@<ms>). 없으면 NaN */
+  deviceTimeMs = NaN;
+
+  constructor() {
+    TELEMETRY_CHANNEL_KEYS.forEach((key) => {
+      const spec = TELEMETRY_CHANNELS[key];
+      const slot: ChannelSlot = { key, spec, listeners: [] };
+      this.byPrefix.set(packPrefix(spec.prefix), slot);
+      this.byKey.set(key, slot);
+    });
+  }
+
+  on<K extends TelemetryChannelKey>(
+    key: K,
+    listener: TelemetryListener<K>
+  ): () => void {
+    const slot = this.byKey.get(key)!;
+    if (!slot.listeners.includes(listener)) {
+      slot.listeners = [...slot.listeners, listener];
+    }
+    return () => {
+      slot.listeners = slot.listeners.filter((l) => l !== listener);
+    };
+  }
+
+  listenerCount(key: TelemetryChannelKey): number {
+    return this.byKey.get(key)!.listeners.length;
+  }
+
+  /** 한 줄을 디코딩해서 해당 채널 리스너에 전달 */
+  dispatch(line: LineView): DispatchResult {
+    // 콜론은 접두사 길이 안에서만 찾는다
+    let packed = 0;
+    let colon = -1;
+    const limit = Math.min(line.length, MAX_PREFIX_BYTES + 1);
+    for (let i = 0; i < limit; i++) {
+      const b = line.byteAt(i);
+      if (b === COLON) {
+        colon = i;
+        break;
+      }
+      // 앞의 NUL은 자릿수를 바꾸지 않아 "\0N:"이 "N:"과 같은 키가 된다 (연결 직후 잡음)
+      if (b === 0) return "unknown";
+      packed = packed * 256 + b;
+    }
+    if (colon <= 0) return "unknown";
+
+    const slot = this.byPrefix.get(packed);
+    if (!slot) return "unknown";
+
+    const value = slot.spec.decode(line, colon + 1);
+    if (value === null) return "invalid";
+
+    this.deviceTimeMs = findDeviceTime(line, colon + 1);
+    this.fanOut(slot, value);
+    return "ok";
+  }
+
+  /** 이미 디코딩된 값을 직접 전달 (바이너리/네이티브 경로용) */
+  emit<K extends TelemetryChannelKey>(
+    key: K,
+    value: TelemetryValues[K],
+    deviceTimeMs: number = NaN
+  ) {
+    // 리스너 안에서 다시 emit할 수 있으므로 바깥 값을 되돌려 놓는다
+    const outer = this.deviceTimeMs;
+    this.deviceTimeMs = deviceTimeMs;
+    this.fanOut(this.byKey.get(key)!, value);
+    this.deviceTimeMs = outer;
+  }
+
+  clear() {
+    this.byKey.forEach((slot) => {
+      slot.listeners = [];
+    });
+  }
+
+  private fanOut(slot: ChannelSlot, value: unknown) {
+    const listeners = slot.listeners;
+    for (let i = 0; i < listeners.length; i++) {
+      listeners[i](value);
+    }
+  }
+}
@@ -0,0 +1,279 @@
+// services/trafficCapture.ts
+// 수신 원시 청크 캡처와 재생. 현장 세션을 그대로 다시 돌려서 회귀 입력/처리량 벤치마크로 쓴다.
+//
+// 파일 형식 (정수는 모두 LEB128 varint):
+//   "ZXC1"                          매직 4바이트
+//   반복: [deltaUs][length][bytes]  이전 청크와의 간격(µs, 단조 시계), 청크 길이, 청크 바이트
+// 청크 경계를 그대로 보존하므로 프레이머가 본 조각남(fragmentation)까지 재현된다.
+// 텍스트 청크는 latin1 바이트로 저장한다 (LineFramer.pushString과 같은 변환).
+
+import { IngestMetricsSnapshot, monotonicNow } from "./ingestMetrics";
+import { Transport, TransportSink } from "./transport";
+
+const MAGIC = [0x5a, 0x58, 0x43, 0x31]; // "ZXC1"
+// 앱에서 실수로 켜 둔 채 오래 달려도 메모리가 끝없이 늘지 않게
+const DEFAULT_MAX_CAPTURE_BYTES = 8 * 1024 * 1024;
+
+export type CapturedChunk = {
+  /** 캡처 시작 기준 ms */
+  offsetMs: number;
+  bytes: Uint8Array;
+};
+
+class ByteWriter {
+  private buffer: Uint8Array = new Uint8Array(4096);
+  length = 0;
+
+  private ensure(extra: number) {
+    if (this.length + extra <= this.buffer.length) return;
+    let size = this.buffer.length * 2;
+    while (size < this.length + extra) size *= 2;
+    const next = new Uint8Array(size);
+    next.set(this.buffer.subarray(0, this.length));
+    this.buffer = next;
+  }
+
+  byte(b: number) {
+    this.ensure(1);
+    this.buffer[this.length++] = b;
+  }
+
+  varint(value: number) {
+    let v = Math.max(0, Math.floor(value));
+    while (v >= 0x80) {
+      this.byte((v % 0x80) | 0x80);
+      v = Math.floor(v / 0x80);
+    }
+    this.byte(v);
+  }
+
+  bytes(data: Uint8Array) {
+    this.ensure(data.length);
+    this.buffer.set(data, this.length);
+    this.length += data.length;
+  }
+
+  text(data: string) {
+    this.ensure(data.length);
+    for (let i = 0; i < data.length; i++) {
+      this.buffer[this.length++] = data.charCodeAt(i) & 0xff;
+    }
+  }
+
+  toBytes(): Uint8Array {
+    return this.buffer.slice(0, this.length);
+  }
+}
+
+export type CaptureRecorderOptions = {
+  maxBytes?: number;
+};
+
+/** 받은 청크를 도착 순서대로 캡처 형식으로 쌓는다 */
+export class CaptureRecorder {
+  private writer: ByteWriter = new ByteWriter();
+  private maxBytes: number;
+  private lastAt = -1;
+  private chunkCount = 0;
+  private truncatedChunks = 0;
+
+  constructor(options: CaptureRecorderOptions = {}) {
+    this.maxBytes = options.maxBytes ?? DEFAULT_MAX_CAPTURE_BYTES;
+    MAGIC.forEach((b) => this.writer.byte(b));
+  }
+
+  get chunks(): number {
+    return this.chunkCount;
+  }
+
+  /** maxBytes를 넘어서 버린 청크 수 */
+  get truncated(): number {
+    return this.truncatedChunks;
+  }
+
+  recordText(chunk: string, now: number = monotonicNow()) {
+    if (!this.begin(chunk.length, now)) return;
+    this.writer.text(chunk);
+  }
+
+  recordBytes(chunk: Uint8Array, now: number = monotonicNow()) {
+    if (!this.begin(chunk.length, now)) return;
+    this.writer.bytes(chunk);
+  }
+
+  toBytes(): Uint8Array {
+    return this.writer.toBytes();
+  }
+
+  private begin(length: number, now: number): boolean {
+    // 헤더 varint 최대 10바이트
+    if (this.writer.length + length + 10 > this.maxBytes) {
+      this.truncatedChunks++;
+      return false;
+    }
+    const deltaUs = this.lastAt < 0 ? 0 : (now - this.lastAt) * 1000;
+    this.lastAt = now;
+    this.chunkCount++;
+    this.writer.varint(deltaUs);
+    this.writer.varint(length);
+    return true;
+  }
+}
+
+export function decodeCapture(data: Uint8Array): CapturedChunk[] {
+  for (let i = 0; i < MAGIC.length; i++) {
+    if (data[i] !== MAGIC[i]) throw new Error("Not a traffic capture");
+  }
+
+  let pos = MAGIC.length;
+  const readVarint = (): number => {
+    let value = 0;
+    let scale = 1;
+    for (;;) {
+      if (pos >= data.length) throw new Error("Truncated traffic capture");
+      const b = data[pos++];
+      value += (b & 0x7f) * scale;
+      if (b < 0x80) return value;
+      scale *= 0x80;
+    }
+  };
+
+  const chunks: CapturedChunk[] = [];
+  let offsetUs = 0;
+  while (pos < data.length) {
+    offsetUs += readVarint();
+    const length = readVarint();
+    if (pos + length > data.length) {
+      throw new Error("Truncated traffic capture");
+    }
+    chunks.push({
+      offsetMs: offsetUs / 1000,
+      bytes: data.subarray(pos, pos + length),
+    });
+    pos += length;
+  }
+  return chunks;
+}
+
+export type ReplayOptions = {
+  /** 재생 배속. 1 = 실시간, Infinity = 가능한 한 빨리 */
+  speed?: number;
+  /** 최대 속도 재생에서 이만큼 청크를 보낸 뒤 이벤트 루프에 양보한다 (React 커밋 기회) */
+  yieldEvery?: number;
+};
+
+export type ReplayStats = {
+  chunks: number;
+  bytes: number;
+  /** 캡처에 기록된 세션 길이 */
+  capturedMs: number;
+  /** 실제 재생에 걸린 시간 */
+  elapsedMs: number;
+};
+
+/**
+ * 캡처를 기기 대신 틀어 주는 Transport. open()하면 재생을 시작하고 끝나면 finished가 풀린다.
+ * 재생이 끝난 링크는 열린 채로 조용해진다 (닫으면 브리지가 재연결해서 처음부터 다시 튼다).
+ * 쓰기는 받아서 버린다.
+ */
+export class ReplayTransport implements Transport {
+  readonly kind = "replay";
+  readonly finished: Promise<ReplayStats>;
+  private chunks: CapturedChunk[];
+  private speed: number;
+  private yieldEvery: number;
+  private sink: TransportSink | null = null;
+  private timer: ReturnType<typeof setTimeout> | null = null;
+  private resolveFinished: (stats: ReplayStats) => void = () => undefined;
+
+  constructor(
+    capture: Uint8Array | CapturedChunk[],
+    options: ReplayOptions = {}
+  ) {
+    this.chunks =
+      capture instanceof Uint8Array ? decodeCapture(capture) : capture;
+    this.speed = options.speed ?? 1;
+    this.yieldEvery = Math.max(1, options.yieldEvery ?? 64);
+    this.finished = new Promise((resolve) => {
+      this.resolveFinished = resolve;
+    });
+  }
+
+  get isOpen(): boolean {
+    return this.sink !== null;
+  }
+
+  async open(_address: string, sink: TransportSink): Promise<void> {
+    this.sink = sink;
+    // 핸드셰이크 전송이 끝난 뒤부터 재생
+    this.timer = setTimeout(() => this.play(sink), 0);
+  }
+
+  async write(): Promise<void> {
+    if (!this.sink) throw new Error("Device not connected");
+  }
+
+  async close(): Promise<void> {
+    this.sink = null;
+    if (this.timer) {
+      clearTimeout(this.timer);
+      this.timer = null;
+    }
+  }
+
+  private play(sink: TransportSink) {
+    const startedAt = monotonicNow();
+    let bytes = 0;
+    let index = 0;
+
+    const step = () => {
+      this.timer = null;
+      let sentSinceYield = 0;
+      while (index < this.chunks.length && this.sink === sink) {
+        const chunk = this.chunks[index];
+        // 시작 시각 기준 절대 일정이라 타이머 지연이 누적되지 않는다
+        const dueIn =
+          chunk.offsetMs / this.speed - (monotonicNow() - startedAt);
+        if (dueIn > 1 || sentSinceYield >= this.yieldEvery) {
+          this.timer = setTimeout(step, Math.max(0, dueIn));
+          return;
+        }
+        sink.onBytes(chunk.bytes, Date.now());
+        bytes += chunk.bytes.length;
+        index++;
+        sentSinceYield++;
+      }
+      if (this.sink !== sink) return;
+
+      const last = this.chunks[this.chunks.length - 1];
+      this.resolveFinished({
+        chunks: index,
+        bytes,
+        capturedMs: last ? last.offsetMs : 0,
+        elapsedMs: monotonicNow() - startedAt,
+      });
+    };
+
+    step();
+  }
+}
+
+export type ReplayThroughput = {
+  /** 디코딩된 줄+프레임 / 재생 시간 */
+  samplesPerSecond: number;
+  /** 재생 시간 / React 커밋 수 (Provider를 거치지 않았으면 null) */
+  msPerFrame: number | null;
+};
+
+export function replayThroughput(
+  stats: ReplayStats,
+  ingest: IngestMetricsSnapshot
+): ReplayThroughput {
+  const seconds = stats.elapsedMs / 1000;
+  const samples = ingest.counters.lines + ingest.counters.frames;
+  const commits = ingest.endToEnd.count;
+  return {
+    samplesPerSecond: seconds > 0 ? samples / seconds : 0,
+    msPerFrame: commits > 0 ? stats.elapsedMs / commits : null,
+  };
+}
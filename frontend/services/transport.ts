@@ -0,0 +1,140 @@
+// services/transport.ts
+// ArduinoBridge가 쓰는 링크 추상화. 브리지는 Transport로 열고/쓰고/닫기만 하고,
+// 수신 데이터는 TransportSink 콜백으로 받는다. 구현:
+//   ClassicTransport        (classicTransport.ts) react-native-bluetooth-classic, HC-06
+//   NativeIngestTransport   (nativeTransport.ts)  C++/JSI 인제스트, 디코딩된 샘플을 넘긴다
+//   LoopbackTransport       (이 파일)              메모리 안에서 기기 역할을 흉내 낸다 (Jest/Node)
+//   TcpTransport/PtyTransport (nodeTransports.ts) Node 전용, 시뮬레이터 연결용
+
+import { NativeIngestStats } from "./nativeIngest";
+import { TelemetryChannelKey } from "./telemetryChannels";
+
+export type TransportSink = {
+  /** 원시 수신 텍스트 청크 (종결자/청크 경계는 그대로) */
+  onText(chunk: string, arrivedAtMs: number): void;
+  /** 원시 수신 바이트 청크 */
+  onBytes(chunk: Uint8Array, arrivedAtMs: number): void;
+  /** 다른 곳에서 이미 줄 단위로 자른 텍스트 (네이티브가 디코딩하지 않은 줄) */
+  onLine(line: string, arrivedAtMs: number): void;
+  /** 이미 디코딩된 샘플 (네이티브 인제스트). deviceTimeMs는 @<기기 ms>가 있었을 때만 */
+  onSample(
+    key: TelemetryChannelKey,
+    value: number,
+    arrivedAtMs: number,
+    deviceTimeMs?: number
+  ): void;
+  /** 상대편이나 OS가 링크를 끊음. close()로 직접 닫은 경우에는 호출되지 않는다 */
+  onClosed(): void;
+};
+
+export interface Transport {
+  /** 로그/진단용 이름 */
+  readonly kind: string;
+  readonly isOpen: boolean;
+  open(address: string, sink: TransportSink, timeoutMs: number): Promise<void>;
+  write(data: string): Promise<void>;
+  close(): Promise<void>;
+  /** 트랜스포트 안에서 디코딩까지 하는 경우 그 통계 */
+  ingestStats?(): NativeIngestStats | null;
+  /** 트랜스포트 안의 디코딩 상태 초기화 */
+  resetIngest?(): void;
+  /** 트랜스포트 안에서 디코딩하는 경우 BIN:<v> 협상 창을 JS와 맞춘다 */
+  setBinaryNegotiation?(negotiating: boolean): void;
+}
+
+export function withTimeout<T>(promise: Promise<T>, ms: number): Promise<T> {
+  let timer: ReturnType<typeof setTimeout> | null = null;
+  const timeoutPromise = new Promise<never>((_, reject) => {
+    timer = setTimeout(() => {
+      reject(new Error(`Connection timeout after ${ms / 1000} seconds`));
+    }, ms);
+  });
+  return Promise.race([promise, timeoutPromise]).finally(() => {
+    if (timer) clearTimeout(timer);
+  });
+}
+
+export type LoopbackOptions = {
+  /** 양방향 전달 지연. 0이면 동기 전달 */
+  latencyMs?: number;
+};
+
+/**
+ * 메모리 루프백. 브리지 쪽은 Transport로, 테스트/시뮬레이터 쪽은
+ * emit()/onWrite()/drop()으로 기기 역할을 한다.
+ */
+export class LoopbackTransport implements Transport {
+  readonly kind = "loopback";
+  /** false면 open()이 실패한다 (재연결 테스트용) */
+  acceptConnections = true;
+  private latencyMs: number;
+  private sink: TransportSink | null = null;
+  private writeListeners: Set<(data: string) => void> = new Set();
+  private openedAddress: string | null = null;
+
+  constructor(options: LoopbackOptions = {}) {
+    this.latencyMs = options.latencyMs ?? 0;
+  }
+
+  get isOpen(): boolean {
+    return this.sink !== null;
+  }
+
+  get address(): string | null {
+    return this.openedAddress;
+  }
+
+  async open(address: string, sink: TransportSink): Promise<void> {
+    if (!this.acceptConnections) {
+      throw new Error(`Loopback refused connection to ${address}`);
+    }
+    this.sink = sink;
+    this.openedAddress = address;
+  }
+
+  async write(data: string): Promise<void> {
+    if (!this.sink) throw new Error("Device not connected");
+    this.deliver(() => this.writeListeners.forEach((listener) => listener(data)));
+  }
+
+  async close(): Promise<void> {
+    this.sink = null;
+  }
+
+  // ---- 기기 쪽 API ----
+
+  /** 브리지가 쓴 데이터 구독 */
+  onWrite(listener: (data: string) => void): () => void {
+    this.writeListeners.add(listener);
+    return () => this.writeListeners.delete(listener);
+  }
+
+  /** 기기 → 브리지 원시 청크 */
+  emit(chunk: string | Uint8Array) {
+    // 지연이 없으면 클로저 없이 바로 (벤치마크에서 하네스 할당이 섞이지 않게)
+    if (this.latencyMs > 0) {
+      setTimeout(() => this.deliverChunk(chunk), this.latencyMs);
+    } else {
+      this.deliverChunk(chunk);
+    }
+  }
+
+  /** 링크 끊김 흉내 (브리지에는 onClosed로 알려진다) */
+  drop() {
+    const sink = this.sink;
+    this.sink = null;
+    sink?.onClosed();
+  }
+
+  private deliverChunk(chunk: string | Uint8Array) {
+    const sink = this.sink;
+    if (!sink) return;
+    if (typeof chunk === "string") sink.onText(chunk, Date.now());
+    else sink.onBytes(chunk, Date.now());
+  }
+
+  private deliver(action: () => void) {
+    if (this.latencyMs > 0) setTimeout(action, this.latencyMs);
+    else action();
+  }
+}
@@ -0,0 +1,263 @@
+// tools/simulator/SimDevice.cpp
+
+#include "SimDevice.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace zxis::sim {
+
+namespace {
+
+// 앱이 보내는 명령 줄의 최대 길이 (넘으면 버린다)
+constexpr size_t kMaxCommandLine = 64;
+
+bool startsWith(const std::string& text, const char* prefix) {
+  return text.rfind(prefix, 0) == 0;
+}
+
+// binaryProtocol.ts와 같은 상수
+constexpr uint8_t kFrameSync = 0xA5;
+constexpr uint8_t kBpmChannel = 0x01;
+constexpr uint8_t kSpeedChannel = 0x02;
+
+uint8_t crc8(const std::string& data, size_t begin) {
+  uint8_t crc = 0;
+  for (size_t i = begin; i < data.size(); i++) {
+    crc ^= static_cast<uint8_t>(data[i]);
+    for (int bit = 0; bit < 8; bit++) {
+      crc = crc & 0x80 ? static_cast<uint8_t>((crc << 1) ^ 0x07)
+                       : static_cast<uint8_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+bool parseNumber(const std::string& text, double& value) {
+  if (text.empty()) return false;
+  char* end = nullptr;
+  value = std::strtod(text.c_str(), &end);
+  return end == text.c_str() + text.size() && std::isfinite(value);
+}
+
+} // namespace
+
+SimDevice::SimDevice(
+    const DeviceOptions& options,
+    uint32_t seed,
+    Clock::time_point now)
+    : options_(options),
+      rng_(seed),
+      model_(options.model),
+      period_(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(1.0 / options.sampleRateHz))),
+      modelTime_(now),
+      bootTime_(now),
+      bootMillis_(std::uniform_real_distribution<double>(0, 1e6)(rng_)),
+      nextSampleGrid_(now + period_) {
+  nextSampleAt_ = nextSampleGrid_ + jitter();
+}
+
+void SimDevice::receive(
+    const char* data,
+    size_t length,
+    Clock::time_point now) {
+  for (size_t i = 0; i < length; i++) {
+    const char c = data[i];
+    if (c == '\n' || c == '\r') {
+      if (!lineBuffer_.empty()) handleLine(lineBuffer_, now);
+      lineBuffer_.clear();
+    } else if (lineBuffer_.size() < kMaxCommandLine) {
+      lineBuffer_.push_back(c);
+    }
+  }
+}
+
+void SimDevice::handleLine(const std::string& raw, Clock::time_point now) {
+  stats_.commands++;
+
+  // <명령>#<seq>
+  std::string line = raw;
+  std::string seq;
+  const size_t hash = line.rfind('#');
+  if (hash != std::string::npos) {
+    seq = line.substr(hash + 1);
+    line.resize(hash);
+  }
+
+  double value = 0;
+  bool handled = true;
+  if (line == "READY") {
+    reply("STS:READY", now);
+  } else if (line == "STOP") {
+    model_.stop();
+  } else if (startsWith(line, "S:") && parseNumber(line.substr(2), value)) {
+    model_.setSpeed(value);
+  } else if (startsWith(line, "T:") && parseNumber(line.substr(2), value)) {
+    reply("N:" + std::to_string(static_cast<int>(std::lround(value))), now);
+  } else if (startsWith(line, "PING:")) {
+    // 받은 시각과 보낼 시각의 중간으로 찍는다 (앱은 왕복의 중간과 비교한다)
+    const auto handledAt = now +
+        std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::milli>(
+                options_.replyDelayMs / 2));
+    reply("PONG:" + line.substr(5) + stamp(handledAt), now);
+  } else if (startsWith(line, "BIN:")) {
+    if (!options_.binaryProtocol) {
+      // 바이너리를 모르는 펌웨어: 응답하지 않는다
+    } else if (line == "BIN:1") {
+      reply("BIN:1", now, 1);
+    } else {
+      reply("BIN:0", now, 0);
+    }
+  } else {
+    handled = false;
+  }
+
+  if (handled && !seq.empty()) reply("ACK:" + seq, now);
+}
+
+void SimDevice::reply(
+    const std::string& line,
+    Clock::time_point now,
+    int switchTo) {
+  const auto delay = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double, std::milli>(options_.replyDelayMs));
+  replies_.push_back({now + delay, terminate(line), switchTo});
+}
+
+std::string SimDevice::frame(uint8_t channelId, uint16_t value, size_t width) {
+  std::string out;
+  out.push_back(static_cast<char>(kFrameSync));
+  out.push_back(static_cast<char>(channelId));
+  out.push_back(static_cast<char>(frameSeq_++));
+  out.push_back(1);
+  out.push_back(static_cast<char>(value & 0xff));
+  if (width == 2) out.push_back(static_cast<char>(value >> 8));
+  out.push_back(static_cast<char>(crc8(out, 1)));
+  return out;
+}
+
+std::string SimDevice::terminate(const std::string& line) const {
+  return line + (options_.crlf ? "\r\n" : "\n");
+}
+
+std::string SimDevice::stamp(Clock::time_point t) const {
+  if (!options_.timestamps) return "";
+  const double elapsedMs =
+      std::chrono::duration<double, std::milli>(t - bootTime_).count();
+  const double millis =
+      bootMillis_ + elapsedMs * (1 + options_.clockDriftPpm * 1e-6);
+  return "@" + std::to_string(static_cast<uint64_t>(millis));
+}
+
+void SimDevice::advance(Clock::time_point now, std::vector<std::string>& out) {
+  // 모델은 보낼 일이 있을 때만 now까지 적분한다
+  auto stepModelTo = [this](Clock::time_point t) {
+    if (t <= modelTime_) return;
+    model_.step(std::chrono::duration<double>(t - modelTime_).count());
+    modelTime_ = t;
+  };
+
+  while (true) {
+    const bool replyDue = !replies_.empty() && replies_.front().at <= now;
+    const bool sampleDue = nextSampleAt_ <= now;
+    if (!replyDue && !sampleDue) break;
+
+    if (replyDue &&
+        (!sampleDue || replies_.front().at <= nextSampleAt_)) {
+      if (replies_.front().switchTo >= 0) {
+        binary_ = replies_.front().switchTo == 1;
+      }
+      send(std::move(replies_.front().data), out);
+      replies_.pop_front();
+      continue;
+    }
+
+    // 측정은 격자 시각에, 송신은 지터만큼 늦게
+    stepModelTo(nextSampleGrid_);
+    const long heartRate = std::lround(model_.reportedHeartRate(rng_));
+    if (binary_) {
+      const long centiKmh = std::lround(model_.speed() * 100);
+      // seq 순서가 보장되도록 프레임을 차례로 만든다
+      std::string frames = frame(
+          kBpmChannel,
+          static_cast<uint16_t>(std::clamp(heartRate, 0L, 255L)),
+          1);
+      frames += frame(
+          kSpeedChannel,
+          static_cast<uint16_t>(std::clamp(centiKmh, 0L, 65535L)),
+          2);
+      send(std::move(frames), out);
+    } else {
+      const std::string measuredAt = stamp(nextSampleGrid_);
+      char line[96];
+      std::snprintf(
+          line,
+          sizeof(line),
+          "BPM:%ld%s%sSPD:%.1f%s",
+          heartRate,
+          measuredAt.c_str(),
+          options_.crlf ? "\r\n" : "\n",
+          model_.speed(),
+          measuredAt.c_str());
+      send(terminate(line), out);
+    }
+    stats_.samples++;
+
+    // 격자는 지터와 무관하게 주기만큼 전진한다
+    nextSampleGrid_ += period_;
+    nextSampleAt_ = std::max(nextSampleAt_, nextSampleGrid_ + jitter());
+  }
+}
+
+Clock::time_point SimDevice::nextDeadline() const {
+  if (replies_.empty()) return nextSampleAt_;
+  return std::min(nextSampleAt_, replies_.front().at);
+}
+
+void SimDevice::send(std::string data, std::vector<std::string>& out) {
+  const FaultOptions& faults = options_.faults;
+  if (faults.dropRate > 0 || faults.corruptRate > 0) {
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::uniform_int_distribution<int> anyByte(0, 255);
+    std::string damaged;
+    damaged.reserve(data.size());
+    for (char c : data) {
+      if (chance(rng_) < faults.dropRate) {
+        stats_.bytesDropped++;
+        continue;
+      }
+      if (chance(rng_) < faults.corruptRate) {
+        stats_.bytesCorrupted++;
+        c = static_cast<char>(anyByte(rng_));
+      }
+      damaged.push_back(c);
+    }
+    data.swap(damaged);
+  }
+  if (data.empty()) return;
+  stats_.bytesSent += data.size();
+
+  if (faults.maxChunk == 0 || data.size() <= 1) {
+    out.push_back(std::move(data));
+    return;
+  }
+  std::uniform_int_distribution<size_t> pieceSize(1, faults.maxChunk);
+  for (size_t pos = 0; pos < data.size();) {
+    const size_t n = std::min(pieceSize(rng_), data.size() - pos);
+    out.push_back(data.substr(pos, n));
+    pos += n;
+  }
+}
+
+Clock::duration SimDevice::jitter() {
+  if (options_.faults.jitterMs <= 0) return Clock::duration::zero();
+  std::uniform_real_distribution<double> ms(0.0, options_.faults.jitterMs);
+  return std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double, std::milli>(ms(rng_)));
+}
+
+} // namespace zxis::sim
@@ -0,0 +1,112 @@
+// tools/simulator/SimDevice.h
+// HC-06에 물린 아두이노 한 대의 기기 쪽 줄 프로토콜. 전송 수단(TCP/pty)과 무관하다.
+//   받는 명령: READY, T:<bpm>, S:<km/h>, STOP, PING:<n>, BIN:<v>  (각각 #<seq>가 붙으면 ACK:<seq>)
+//   보내는 값: BPM:<n>, SPD:<x.x> (샘플 주기마다), N:<bpm> (T: 에코), STS:<text>, PONG:<n>
+//   timestamps면 BPM/SPD/PONG 뒤에 @<기기 ms> (기기 단조 시계, clockDriftPpm만큼 틀어진다)
+// BIN:1에 BIN:1로 답한 뒤에는 BPM/SPD를 바이너리 프레임(services/binaryProtocol.ts)으로 보내고,
+// BIN:0이면 BIN:0으로 답하고 텍스트로 돌아간다. 프레임에는 기기 시각이 없다.
+// binaryProtocol이 꺼져 있으면 BIN: 요청에 응답하지 않는다 (바이너리를 모르는 펌웨어).
+// 송신 경로에 지터, 바이트 손실/손상, 청크 쪼개기를 넣을 수 있다.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TreadmillModel.h"
+
+namespace zxis::sim {
+
+using Clock = std::chrono::steady_clock;
+
+struct FaultOptions {
+  // 샘플마다 [0, jitterMs] 만큼 늦게 보낸다 (샘플 격자 자체는 밀리지 않음)
+  double jitterMs = 0;
+  // 송신 바이트마다 버릴 확률 / 임의 바이트로 바꿀 확률
+  double dropRate = 0;
+  double corruptRate = 0;
+  // 0이 아니면 송신 데이터를 1..maxChunk 바이트 조각으로 나눠 따로 쓴다
+  size_t maxChunk = 0;
+};
+
+struct DeviceOptions {
+  double sampleRateHz = 1.0;
+  // 명령 처리 지연 (아두이노 loop 주기 흉내)
+  double replyDelayMs = 5;
+  bool crlf = false;
+  // 값 뒤에 @<기기 ms>를 붙인다 (BPM/SPD는 측정 시각, PONG은 PING 처리 시각)
+  bool timestamps = false;
+  // BIN:1 협상에 응답한다
+  bool binaryProtocol = true;
+  // 기기 시계 오차 (ppm). 아두이노 세라믹 레조네이터는 수천 ppm까지 틀어진다
+  double clockDriftPpm = 0;
+  FaultOptions faults;
+  ModelParams model;
+};
+
+struct DeviceStats {
+  uint64_t commands = 0;
+  uint64_t samples = 0;
+  uint64_t bytesSent = 0;
+  uint64_t bytesDropped = 0;
+  uint64_t bytesCorrupted = 0;
+};
+
+class SimDevice {
+ public:
+  SimDevice(const DeviceOptions& options, uint32_t seed, Clock::time_point now);
+
+  // 앱이 쓴 바이트
+  void receive(const char* data, size_t length, Clock::time_point now);
+
+  // now까지 보낼 것을 만든다. out에는 한 번의 write로 보낼 조각들이 순서대로 들어간다
+  void advance(Clock::time_point now, std::vector<std::string>& out);
+
+  // 다음에 advance()가 할 일이 생기는 시각
+  Clock::time_point nextDeadline() const;
+
+  const DeviceStats& stats() const { return stats_; }
+  const TreadmillModel& model() const { return model_; }
+
+ private:
+  struct Pending {
+    Clock::time_point at;
+    std::string data;
+    // 보낸 직후 바꿀 송신 모드 (-1 = 유지, 0 = 텍스트, 1 = 바이너리)
+    int switchTo = -1;
+  };
+
+  void handleLine(const std::string& line, Clock::time_point now);
+  void reply(const std::string& line, Clock::time_point now, int switchTo = -1);
+  // [SYNC][id][seq][1][필드][CRC-8] 샘플 한 개짜리 프레임
+  std::string frame(uint8_t channelId, uint16_t value, size_t width);
+  std::string terminate(const std::string& line) const;
+  // 값 뒤에 붙일 "@<기기 ms>" (timestamps가 꺼져 있으면 빈 문자열)
+  std::string stamp(Clock::time_point t) const;
+  void send(std::string data, std::vector<std::string>& out);
+  Clock::duration jitter();
+
+  DeviceOptions options_;
+  std::mt19937 rng_;
+  TreadmillModel model_;
+  Clock::duration period_;
+  Clock::time_point modelTime_;
+  // 기기 시계: 전원을 켠 시각과 그때의 millis() (기기마다 다르게)
+  Clock::time_point bootTime_;
+  double bootMillis_;
+  // 다음 샘플의 격자 시각과, 지터를 더한 실제 송신 시각
+  Clock::time_point nextSampleGrid_;
+  Clock::time_point nextSampleAt_;
+  std::deque<Pending> replies_;
+  std::string lineBuffer_;
+  bool binary_ = false;
+  uint8_t frameSeq_ = 0;
+  DeviceStats stats_;
+};
+
+} // namespace zxis::sim
@@ -0,0 +1,54 @@
+// tools/simulator/TreadmillModel.cpp
+
+#include "TreadmillModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace zxis::sim {
+
+TreadmillModel::TreadmillModel(const ModelParams& params)
+    : params_(params), hr_(params.restingHr) {}
+
+void TreadmillModel::setSpeed(double kmh) {
+  commanded_ = std::clamp(kmh, 0.0, params_.maxSpeedKmh);
+  stopping_ = false;
+}
+
+void TreadmillModel::stop() {
+  commanded_ = 0;
+  stopping_ = true;
+}
+
+void TreadmillModel::step(double dtSec) {
+  if (dtSec <= 0) return;
+
+  // 벨트: 가속/감속 한계
+  const double decel =
+      stopping_ ? params_.stopDecelKmhPerSec : params_.decelKmhPerSec;
+  if (speed_ < commanded_) {
+    speed_ = std::min(commanded_, speed_ + params_.accelKmhPerSec * dtSec);
+  } else if (speed_ > commanded_) {
+    speed_ = std::max(commanded_, speed_ - decel * dtSec);
+  }
+  if (stopping_ && speed_ == 0) stopping_ = false;
+
+  // 심박: 1차 지연으로 정상 상태 값을 따라간다
+  if (speed_ > 0) {
+    drift_ += params_.driftBpmPerMin * dtSec / 60.0;
+  } else {
+    drift_ = std::max(0.0, drift_ - params_.driftBpmPerMin * dtSec / 60.0);
+  }
+  const double steady = std::min(
+      params_.maxHr, params_.restingHr + params_.hrPerKmh * speed_ + drift_);
+  const double tau = steady > hr_ ? params_.tauUpSec : params_.tauDownSec;
+  hr_ += (steady - hr_) * (1.0 - std::exp(-dtSec / tau));
+}
+
+double TreadmillModel::reportedHeartRate(std::mt19937& rng) {
+  if (params_.hrNoiseBpm <= 0) return hr_;
+  std::normal_distribution<double> noise(0.0, params_.hrNoiseBpm);
+  return std::clamp(hr_ + noise(rng), 30.0, 230.0);
+}
+
+} // namespace zxis::sim
@@ -0,0 +1,53 @@
+// tools/simulator/TreadmillModel.h
+// 러닝머신 벨트 속도와 사용자 심박 반응 모델.
+// 속도는 명령값을 향해 가속/감속 한계로 따라가고, 심박은 속도에 비례하는 정상 상태 값을
+// 1차 지연(오를 때/내릴 때 시정수 다름)으로 따라간다. 운동이 길어지면 심박이 조금씩 더 오른다(cardiac drift).
+
+#pragma once
+
+#include <random>
+
+namespace zxis::sim {
+
+struct ModelParams {
+  double restingHr = 65;
+  double maxHr = 190;
+  // 정상 상태 심박 = restingHr + hrPerKmh × 속도
+  double hrPerKmh = 7.5;
+  double tauUpSec = 25;
+  double tauDownSec = 40;
+  // 움직이는 동안 분당 추가 상승
+  double driftBpmPerMin = 0.15;
+  // 보고값에 섞는 잡음 (표준편차)
+  double hrNoiseBpm = 1.0;
+  double accelKmhPerSec = 0.8;
+  double decelKmhPerSec = 1.5;
+  // STOP 명령 시 감속
+  double stopDecelKmhPerSec = 4.0;
+  double maxSpeedKmh = 20;
+};
+
+class TreadmillModel {
+ public:
+  explicit TreadmillModel(const ModelParams& params = {});
+
+  void setSpeed(double kmh);
+  void stop();
+  void step(double dtSec);
+
+  double speed() const { return speed_; }
+  double commandedSpeed() const { return commanded_; }
+  double heartRate() const { return hr_; }
+  // 잡음이 섞인 보고용 심박
+  double reportedHeartRate(std::mt19937& rng);
+
+ private:
+  ModelParams params_;
+  double speed_ = 0;
+  double commanded_ = 0;
+  bool stopping_ = false;
+  double hr_;
+  double drift_ = 0;
+};
+
+} // namespace zxis::sim
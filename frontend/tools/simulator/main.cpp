@@ -0,0 +1,318 @@
+// tools/simulator/main.cpp
+// 호스트용 러닝머신/심박 시뮬레이터. 아두이노+HC-06 대신 앱(TcpTransport/PtyTransport)이나
+// 백엔드 부하 테스트가 붙는다. 엔드포인트마다 SimDevice 하나(TCP는 접속마다 하나)를 돌린다.
+//
+//   treadmill-sim --tcp 7001 --instances 20 --rate 10 --jitter 30 --drop 0.001
+//   treadmill-sim --pty --rate 250 --fragment 8
+//
+// 단일 스레드 poll() 루프. 시작할 때 엔드포인트 주소를 한 줄씩 stdout에 찍는다.
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SimDevice.h"
+
+using zxis::sim::Clock;
+using zxis::sim::DeviceOptions;
+using zxis::sim::SimDevice;
+
+namespace {
+
+struct Options {
+  int tcpPort = 0;
+  bool pty = false;
+  int instances = 1;
+  uint32_t seed = 1;
+  DeviceOptions device;
+};
+
+// 엔드포인트: TCP 리스너, TCP 접속, pty 마스터
+struct Endpoint {
+  enum class Kind { Listener, Client, Pty } kind;
+  int fd;
+  std::string name;
+  std::unique_ptr<SimDevice> device;
+  // pty: 아무도 열지 않아도 HUP이 나지 않게 슬레이브를 하나 잡아 둔다
+  int ptySlave = -1;
+};
+
+volatile std::sig_atomic_t gStop = 0;
+
+void usage() {
+  std::fprintf(
+      stderr,
+      "usage: treadmill-sim (--tcp PORT | --pty) [options]\n"
+      "  --instances N     N endpoints (TCP ports PORT..PORT+N-1 or N ptys)\n"
+      "  --rate HZ         BPM/SPD sample rate (default 1)\n"
+      "  --jitter MS       delay each sample by up to MS\n"
+      "  --drop P          drop each sent byte with probability P\n"
+      "  --corrupt P       replace each sent byte with probability P\n"
+      "  --fragment N      split writes into 1..N byte pieces\n"
+      "  --reply-delay MS  command processing delay (default 5)\n"
+      "  --crlf            terminate lines with \\r\\n\n"
+      "  --timestamps      append @<device ms> to BPM/SPD/PONG\n"
+      "  --clock-drift PPM device clock error (default 0)\n"
+      "  --no-binary       ignore BIN: requests (text-only firmware)\n"
+      "  --rest-hr BPM     resting heart rate (default 65)\n"
+      "  --seed N          random seed (default 1)\n");
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    auto value = [&]() { return std::atof(argv[++i]); };
+
+    if (arg == "--tcp" && hasValue) {
+      options.tcpPort = static_cast<int>(value());
+    } else if (arg == "--pty") {
+      options.pty = true;
+    } else if (arg == "--instances" && hasValue) {
+      options.instances = std::max(1, static_cast<int>(value()));
+    } else if (arg == "--rate" && hasValue) {
+      options.device.sampleRateHz = value();
+    } else if (arg == "--jitter" && hasValue) {
+      options.device.faults.jitterMs = value();
+    } else if (arg == "--drop" && hasValue) {
+      options.device.faults.dropRate = value();
+    } else if (arg == "--corrupt" && hasValue) {
+      options.device.faults.corruptRate = value();
+    } else if (arg == "--fragment" && hasValue) {
+      options.device.faults.maxChunk = static_cast<size_t>(value());
+    } else if (arg == "--reply-delay" && hasValue) {
+      options.device.replyDelayMs = value();
+    } else if (arg == "--crlf") {
+      options.device.crlf = true;
+    } else if (arg == "--timestamps") {
+      options.device.timestamps = true;
+    } else if (arg == "--no-binary") {
+      options.device.binaryProtocol = false;
+    } else if (arg == "--clock-drift" && hasValue) {
+      options.device.clockDriftPpm = value();
+    } else if (arg == "--rest-hr" && hasValue) {
+      options.device.model.restingHr = value();
+    } else if (arg == "--seed" && hasValue) {
+      options.seed = static_cast<uint32_t>(value());
+    } else {
+      return false;
+    }
+  }
+  return (options.tcpPort > 0) != options.pty &&
+      options.device.sampleRateHz > 0;
+}
+
+void setNonBlocking(int fd) {
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+int openListener(int port) {
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  const int on = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(fd, 16) < 0) {
+    close(fd);
+    return -1;
+  }
+  setNonBlocking(fd);
+  return fd;
+}
+
+// 슬레이브 경로를 돌려준다. 실패하면 빈 문자열
+std::string openPty(int& masterFd, int& slaveFd) {
+  masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (masterFd < 0 || grantpt(masterFd) < 0 || unlockpt(masterFd) < 0) {
+    return "";
+  }
+  const char* path = ptsname(masterFd);
+  if (!path) return "";
+  const std::string slavePath = path;
+
+  // 에코/줄 편집 없이 바이트 그대로 (시리얼 포트처럼)
+  termios tio{};
+  tcgetattr(masterFd, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(masterFd, TCSANOW, &tio);
+  setNonBlocking(masterFd);
+
+  slaveFd = open(slavePath.c_str(), O_RDWR | O_NOCTTY);
+  return slavePath;
+}
+
+// 보낼 데이터를 쓴다. 상대가 읽지 않아 버퍼가 차면 버린다 (실제 HC-06도 그렇다)
+void writeAll(Endpoint& endpoint, const std::vector<std::string>& chunks) {
+  for (const auto& chunk : chunks) {
+    const ssize_t n = endpoint.kind == Endpoint::Kind::Client
+        ? send(endpoint.fd, chunk.data(), chunk.size(), MSG_NOSIGNAL)
+        : write(endpoint.fd, chunk.data(), chunk.size());
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return;
+  }
+}
+
+void printStats(const Endpoint& endpoint) {
+  if (!endpoint.device) return;
+  const auto& stats = endpoint.device->stats();
+  std::fprintf(
+      stderr,
+      "%s: commands=%llu samples=%llu sent=%llu dropped=%llu "
+      "corrupted=%llu\n",
+      endpoint.name.c_str(),
+      static_cast<unsigned long long>(stats.commands),
+      static_cast<unsigned long long>(stats.samples),
+      static_cast<unsigned long long>(stats.bytesSent),
+      static_cast<unsigned long long>(stats.bytesDropped),
+      static_cast<unsigned long long>(stats.bytesCorrupted));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    usage();
+    return 2;
+  }
+
+  std::signal(SIGINT, [](int) { gStop = 1; });
+  std::signal(SIGTERM, [](int) { gStop = 1; });
+
+  std::vector<Endpoint> endpoints;
+  uint32_t nextSeed = options.seed;
+
+  for (int i = 0; i < options.instances; i++) {
+    if (options.pty) {
+      int master = -1;
+      int slave = -1;
+      const std::string path = openPty(master, slave);
+      if (path.empty()) {
+        std::perror("pty");
+        return 1;
+      }
+      endpoints.push_back(
+          {Endpoint::Kind::Pty,
+           master,
+           path,
+           std::make_unique<SimDevice>(
+               options.device, nextSeed++, Clock::now()),
+           slave});
+      std::printf("%s\n", path.c_str());
+    } else {
+      const int port = options.tcpPort + i;
+      const int fd = openListener(port);
+      if (fd < 0) {
+        std::perror("listen");
+        return 1;
+      }
+      endpoints.push_back(
+          {Endpoint::Kind::Listener,
+           fd,
+           "127.0.0.1:" + std::to_string(port),
+           nullptr});
+      std::printf("127.0.0.1:%d\n", port);
+    }
+  }
+  std::fflush(stdout);
+
+  std::vector<pollfd> fds;
+  std::vector<std::string> chunks;
+  char buffer[512];
+
+  while (!gStop) {
+    // 가장 가까운 송신 시각까지 기다린다
+    auto now = Clock::now();
+    auto deadline = now + std::chrono::seconds(1);
+    for (const auto& endpoint : endpoints) {
+      if (endpoint.device) {
+        deadline = std::min(deadline, endpoint.device->nextDeadline());
+      }
+    }
+    const auto waitMs = std::chrono::ceil<std::chrono::milliseconds>(
+        deadline - now);
+
+    fds.clear();
+    for (const auto& endpoint : endpoints) {
+      fds.push_back({endpoint.fd, POLLIN, 0});
+    }
+    if (poll(fds.data(), fds.size(), std::max<int>(0, waitMs.count())) < 0 &&
+        errno != EINTR) {
+      std::perror("poll");
+      break;
+    }
+
+    now = Clock::now();
+    const size_t count = endpoints.size();
+    for (size_t i = 0; i < count; i++) {
+      Endpoint& endpoint = endpoints[i];
+      if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+      if (endpoint.kind == Endpoint::Kind::Listener) {
+        const int client = accept(endpoint.fd, nullptr, nullptr);
+        if (client < 0) continue;
+        setNonBlocking(client);
+        const int on = 1;
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        // 접속마다 새 기기 (새 세션)
+        endpoints.push_back(
+            {Endpoint::Kind::Client,
+             client,
+             endpoint.name + "#" + std::to_string(client),
+             std::make_unique<SimDevice>(options.device, nextSeed++, now)});
+        continue;
+      }
+
+      const ssize_t n = read(endpoint.fd, buffer, sizeof(buffer));
+      if (n > 0) {
+        endpoint.device->receive(buffer, static_cast<size_t>(n), now);
+      } else if (
+          endpoint.kind == Endpoint::Kind::Client &&
+          (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))) {
+        printStats(endpoint);
+        close(endpoint.fd);
+        endpoint.fd = -1;
+      }
+    }
+
+    // 끊긴 접속 정리
+    endpoints.erase(
+        std::remove_if(
+            endpoints.begin(),
+            endpoints.end(),
+            [](const Endpoint& endpoint) { return endpoint.fd < 0; }),
+        endpoints.end());
+
+    for (auto& endpoint : endpoints) {
+      if (!endpoint.device) continue;
+      chunks.clear();
+      endpoint.device->advance(now, chunks);
+      writeAll(endpoint, chunks);
+    }
+  }
+
+  for (const auto& endpoint : endpoints) {
+    printStats(endpoint);
+    close(endpoint.fd);
+    if (endpoint.ptySlave >= 0) close(endpoint.ptySlave);
+  }
+  return 0;
+}